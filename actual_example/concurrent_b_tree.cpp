@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <pthread.h>
+#include <sched.h>
+#include <thread>
+#include <vector>
+
+#include "common/olc_b_tree.hpp"
+#include "common/rng.hpp"
+#include "common/stopwatch.hpp"
+
+constexpr uint64_t Seed = 20201013;
+rng_base Rng{Seed};
+stopwatch SW;
+
+/**
+ * データ列
+ * - 最初にN個入れておき、Q個の操作(lower_bound/insert)を複数スレッドで処理する
+ */
+using data_t            = uint32_t;
+constexpr data_t Inf    = std::numeric_limits<data_t>::max();  // ∞を表現するためだけの定数
+constexpr data_t Min    = 1;
+constexpr data_t Max    = Inf - 1;
+constexpr std::size_t N = (1 << 22);
+constexpr std::size_t Q = (1 << 22);
+
+/**
+ * 楽観的ロックカップリングによるB+木 (common/olc_b_tree.hpp)
+ */
+constexpr std::size_t NodeBytes = 256;
+using tree_t                    = olc::tree<data_t, NodeBytes>;
+static_assert(tree_t::Inf == Inf, "lower_bound must return Inf when not found");
+
+/**
+ * 操作列
+ * - read: trueならlower_bound、falseならinsert
+ */
+struct op_t
+{
+    bool read;
+    data_t key;
+};
+
+/**
+ * 読み込み率read_percent[%]の操作列をthreadsスレッドで処理する
+ * - 毎回N個入れた木から始める
+ * - Opsをスレッド数で等分し、スレッドtはコアt (mod コア数) に固定する
+ * - 最後に入れたキーが全部見つかるか確認する
+ */
+void test(const std::vector<data_t>& xs, const std::vector<op_t>& ops, const std::size_t read_percent, const std::size_t threads)
+{
+    tree_t tree;
+    for (const data_t x : xs) { tree.insert(x); }
+
+    const std::size_t cpus = std::max(std::thread::hardware_concurrency(), 1U);
+    std::vector<data_t> sums(threads);
+    std::vector<std::thread> ths;
+    std::cout << "[OLC B+-tree] Read: " << read_percent << "% (Threads: " << threads << ")" << std::endl;
+    SW.rap();
+    for (std::size_t t = 0; t < threads; t++) {
+        ths.emplace_back([&, t] {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(t % cpus, &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+            data_t sum = 0;
+            for (std::size_t q = Q * t / threads; q < Q * (t + 1) / threads; q++) {
+                if (ops[q].read) {
+                    sum += tree.lower_bound(ops[q].key);
+                } else {
+                    sum += tree.insert(ops[q].key);
+                }
+            }
+            sums[t] = sum;
+        });
+    }
+    for (auto& th : ths) { th.join(); }
+    const auto dur_ns = SW.rap<std::chrono::nanoseconds>();
+    data_t sum        = 0;
+    for (const data_t s : sums) { sum += s; }
+
+    bool ok = true;
+    for (const data_t x : xs) { ok &= (tree.lower_bound(x) == x); }
+    for (const auto& op : ops) { ok &= (op.read or tree.lower_bound(op.key) == op.key); }
+    std::cout << "Throughput: " << static_cast<double>(Q) * 1e9 / static_cast<double>(dur_ns) << " ops/s" << std::endl;
+    std::cout << "Check: " << (ok ? "OK" : "NG") << std::endl;
+    std::cout << "Sum(for Debug): " << sum << std::endl;
+    std::cout << std::endl;
+}
+
+/**
+ * 使い方: concurrent_b_tree_bench [最大スレッド数]
+ * - スレッド数は1,2,4,...と倍にしていき、最後は最大スレッド数
+ */
+int main(int argc, char* argv[])
+{
+    const std::size_t max_threads = argc > 1 ? static_cast<std::size_t>(std::max(std::atoi(argv[1]), 1)) : std::max(std::thread::hardware_concurrency(), 1U);
+
+    std::vector<data_t> xs(N);
+    for (auto& x : xs) { x = Rng.val<data_t>(Min, Max); }
+    std::cout << "Node: " << NodeBytes << " bytes (Leaf: " << tree_t::LeafCap << " keys, Inner: " << tree_t::InnerCap << " keys)" << std::endl;
+    std::cout << std::endl;
+
+    for (const std::size_t read_percent : {100UL, 90UL, 50UL}) {
+        std::vector<op_t> ops(Q);
+        for (auto& op : ops) {
+            op.read = Rng.val<std::size_t>(0, 99) < read_percent;
+            op.key  = Rng.val<data_t>(Min, Max);
+        }
+        for (std::size_t threads = 1;; threads = std::min(threads * 2, max_threads)) {
+            test(xs, ops, read_percent, threads);
+            if (threads == max_threads) { break; }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+
+#include "common/rng.hpp"
+#include "common/stopwatch.hpp"
+
+constexpr uint64_t Seed = 20201013;
+rng_base Rng{Seed};
+stopwatch SW;
+
+using data_t = uint32_t;
+
+namespace lcs {
+
+/**
+ * 2系列
+ * - as: 長さN
+ * - bs: 長さM (Mの方を長くして1行がキャッシュに乗らないようにする)
+ */
+constexpr std::size_t N    = (1 << 10);
+constexpr std::size_t M    = (1 << 21);
+constexpr std::size_t Base = 64;  // これ以下の辺は分割しない
+data_t* as;
+data_t* bs;
+
+void data_init()
+{
+    as = new data_t[N];
+    bs = new data_t[M];
+    for (std::size_t i = 0; i < N; i++) { as[i] = Rng.val<data_t>(0, 3); }
+    for (std::size_t j = 0; j < M; j++) { bs[j] = Rng.val<data_t>(0, 3); }
+}
+
+inline data_t kernel(const data_t diag, const data_t up, const data_t left, const data_t a, const data_t b)
+{
+    return a == b ? diag + 1 : std::max(up, left);
+}
+
+/**
+ * 1行ずつ埋める (2行分だけ持つ)
+ */
+data_t naive()
+{
+    data_t* prev = new data_t[M + 1]();
+    data_t* cur  = new data_t[M + 1]();
+    for (std::size_t i = 1; i <= N; i++) {
+        const data_t a = as[i - 1];
+        for (std::size_t j = 1; j <= M; j++) { cur[j] = kernel(prev[j - 1], prev[j], cur[j - 1], a, bs[j - 1]); }
+        std::swap(prev, cur);
+    }
+    const data_t ans = prev[M];
+    delete[] prev;
+    delete[] cur;
+    return ans;
+}
+
+/**
+ * 計算済み領域の境界 (D[i][j]はfs[j-i+N])
+ */
+data_t* fs;
+
+void recursive(const std::size_t i0, const std::size_t i1, const std::size_t j0, const std::size_t j1)
+{
+    if (i0 >= i1 or j0 >= j1) { return; }
+    if (i1 - i0 <= Base and j1 - j0 <= Base) {
+        for (std::size_t i = i0; i < i1; i++) {
+            const data_t a = as[i - 1];
+            data_t* f      = fs + N - i;
+            for (std::size_t j = j0; j < j1; j++) { f[j] = kernel(f[j], f[j + 1], f[j - 1], a, bs[j - 1]); }
+        }
+        return;
+    }
+    const std::size_t im = i1 - i0 <= Base ? i0 : (i0 + i1) / 2;
+    const std::size_t jm = j1 - j0 <= Base ? j0 : (j0 + j1) / 2;
+    recursive(i0, im, j0, jm);
+    recursive(i0, im, jm, j1);
+    recursive(im, i1, j0, jm);
+    recursive(im, i1, jm, j1);
+}
+
+data_t solve()
+{
+    fs = new data_t[N + M + 1]();
+    recursive(1, N + 1, 1, M + 1);
+    const data_t ans = fs[M];
+    delete[] fs;
+    return ans;
+}
+
+template<typename Solver>
+void test(const char* title, Solver solver)
+{
+    std::cout << title << std::endl;
+    SW.rap();
+    const data_t ans = solver();
+    const auto dur   = SW.rap<std::chrono::nanoseconds>();
+    std::cout << "Total: " << dur << " ns" << std::endl;
+    std::cout << "LCS(for Debug): " << ans << std::endl;
+    std::cout << std::endl;
+}
+
+}  // namespace lcs
+
+namespace fw {
+
+/**
+ * 距離行列 (行優先)
+ */
+constexpr std::size_t N    = (1 << 11);
+constexpr std::size_t Base = 64;  // これ以下のブロックは3重ループ
+constexpr data_t Inf       = std::numeric_limits<data_t>::max() / 2;
+data_t* Init;
+data_t* ds;
+
+void data_init()
+{
+    Init = new data_t[N * N];
+    for (std::size_t i = 0; i < N * N; i++) { Init[i] = i % (N + 1) == 0 ? 0 : Rng.val<int>(0, 7) == 0 ? Rng.val<data_t>(1, 1000000) : Inf; }
+    ds = new data_t[N * N];
+}
+
+void naive()
+{
+    for (std::size_t k = 0; k < N; k++) {
+        for (std::size_t i = 0; i < N; i++) {
+            const data_t dik = ds[i * N + k];
+            for (std::size_t j = 0; j < N; j++) { ds[i * N + j] = std::min(ds[i * N + j], dik + ds[k * N + j]); }
+        }
+    }
+}
+
+/**
+ * I-GEP ([i0,i0+size)x[j0,j0+size)を[k0,k0+size)で更新)
+ */
+void gep(const std::size_t i0, const std::size_t j0, const std::size_t k0, const std::size_t size)
+{
+    if (size <= Base) {
+        for (std::size_t k = k0; k < k0 + size; k++) {
+            for (std::size_t i = i0; i < i0 + size; i++) {
+                const data_t dik = ds[i * N + k];
+                for (std::size_t j = j0; j < j0 + size; j++) { ds[i * N + j] = std::min(ds[i * N + j], dik + ds[k * N + j]); }
+            }
+        }
+        return;
+    }
+    const std::size_t h = size / 2;
+    gep(i0, j0, k0, h);
+    gep(i0, j0 + h, k0, h);
+    gep(i0 + h, j0, k0, h);
+    gep(i0 + h, j0 + h, k0, h);
+    gep(i0 + h, j0 + h, k0 + h, h);
+    gep(i0 + h, j0, k0 + h, h);
+    gep(i0, j0 + h, k0 + h, h);
+    gep(i0, j0, k0 + h, h);
+}
+
+void recursive()
+{
+    gep(0, 0, 0, N);
+}
+
+template<typename Solver>
+void test(const char* title, Solver solver)
+{
+    std::cout << title << std::endl;
+    std::copy(Init, Init + N * N, ds);
+    SW.rap();
+    solver();
+    const auto dur = SW.rap<std::chrono::nanoseconds>();
+    uint64_t sum   = 0;
+    for (std::size_t i = 0; i < N * N; i++) { sum += ds[i]; }
+    std::cout << "Total: " << dur << " ns" << std::endl;
+    std::cout << "Sum(for Debug): " << sum << std::endl;
+    std::cout << std::endl;
+}
+
+}  // namespace fw
+
+int main()
+{
+    lcs::data_init();
+    lcs::test("[LCS Sol1] Row by Row", lcs::naive);
+    lcs::test("[LCS Sol2] Recursive", lcs::solve);
+
+    fw::data_init();
+    fw::test("[Floyd-Warshall Sol1] Naive", fw::naive);
+    fw::test("[Floyd-Warshall Sol2] I-GEP", fw::recursive);
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include <cstdint>
+#include <iostream>
+#include <utility>
+
+#include "common/rng.hpp"
+#include "common/space_filling_curve.hpp"
+#include "common/stopwatch.hpp"
+
+constexpr uint64_t Seed = 20201013;
+rng_base Rng{Seed};
+stopwatch SW;
+
+/**
+ * グリッド
+ */
+using data_t             = uint32_t;
+constexpr std::size_t LG = 12;
+constexpr std::size_t S  = 1UL << LG;  // 一辺
+data_t* Vs;
+
+/**
+ * 近傍クエリの中心
+ */
+constexpr std::size_t Q = (1 << 22);
+std::size_t* Is;
+std::size_t* Js;
+
+void data_init()
+{
+    Vs = new data_t[S * S];
+    for (std::size_t i = 0; i < S * S; i++) {
+        Vs[i] = Rng.val<data_t>(0, 1000);
+    }
+    Is = new std::size_t[Q];
+    Js = new std::size_t[Q];
+    for (std::size_t q = 0; q < Q; q++) {
+        Is[q] = Rng.val<std::size_t>(1, S - 2);
+        Js[q] = Rng.val<std::size_t>(1, S - 2);
+    }
+}
+
+/**
+ * 各レイアウトの添字計算
+ * - index(i,j): (i,j)がレイアウトで何番目か
+ * - position(ind): レイアウトでind番目にあるマス
+ */
+struct row_major
+{
+    static constexpr const char* name = "[Sol1] Row Major";
+    static std::size_t index(const std::size_t i, const std::size_t j) { return (i << LG) | j; }
+    static std::pair<std::size_t, std::size_t> position(const std::size_t ind) { return {ind >> LG, ind & (S - 1)}; }
+};
+struct z_order
+{
+    static constexpr const char* name = "[Sol2] Z-order";
+    static std::size_t index(const std::size_t i, const std::size_t j) { return morton_encode(i, j); }
+    static std::pair<std::size_t, std::size_t> position(const std::size_t ind) { return morton_decode(ind); }
+};
+struct hilbert
+{
+    static constexpr const char* name = "[Sol3] Hilbert order";
+    static std::size_t index(const std::size_t i, const std::size_t j) { return hilbert_encode(LG, i, j); }
+    static std::pair<std::size_t, std::size_t> position(const std::size_t ind) { return hilbert_decode(LG, ind); }
+};
+
+template<typename Layout>
+void test()
+{
+    std::cout << Layout::name << std::endl;
+    data_t* src = new data_t[S * S];
+    data_t* dst = new data_t[S * S];
+    for (std::size_t i = 0; i < S; i++) {
+        for (std::size_t j = 0; j < S; j++) { src[Layout::index(i, j)] = Vs[i * S + j]; }
+    }
+    data_t sum = 0;
+
+    // 5点ステンシル (レイアウト順に1回掃く, 境界はそのまま)
+    SW.rap();
+    for (std::size_t ind = 0; ind < S * S; ind++) {
+        const auto [i, j] = Layout::position(ind);
+        if (i == 0 or j == 0 or i + 1 == S or j + 1 == S) {
+            dst[ind] = src[ind];
+            continue;
+        }
+        dst[ind] = (src[ind] + src[Layout::index(i - 1, j)] + src[Layout::index(i + 1, j)] + src[Layout::index(i, j - 1)] + src[Layout::index(i, j + 1)]) / 5;
+    }
+    std::cout << "Stencil Total: " << SW.rap<std::chrono::nanoseconds>() << " ns" << std::endl;
+    sum += dst[Layout::index(S / 2, S / 2)];
+
+    // 列方向の走査
+    SW.rap();
+    for (std::size_t j = 0; j < S; j++) {
+        for (std::size_t i = 0; i < S; i++) { sum += src[Layout::index(i, j)]; }
+    }
+    std::cout << "Column Total: " << SW.rap<std::chrono::nanoseconds>() << " ns" << std::endl;
+
+    // ランダムな点の3x3近傍
+    SW.rap();
+    for (std::size_t q = 0; q < Q; q++) {
+        for (std::size_t i = Is[q] - 1; i <= Is[q] + 1; i++) {
+            for (std::size_t j = Js[q] - 1; j <= Js[q] + 1; j++) { sum += src[Layout::index(i, j)]; }
+        }
+    }
+    std::cout << "Neighbor Total: " << SW.rap<std::chrono::nanoseconds>() << " ns" << std::endl;
+    std::cout << "Sum(for Debug): " << sum << std::endl;
+    std::cout << std::endl;
+
+    delete[] src;
+    delete[] dst;
+}
+
+int main()
+{
+    data_init();
+
+    test<row_major>();
+    test<z_order>();
+    test<hilbert>();
+
+    return 0;
+}
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <pthread.h>
+#include <sched.h>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "common/hot_swap.hpp"
+#include "common/rng.hpp"
+#include "common/stopwatch.hpp"
+
+constexpr uint64_t Seed = 20201013;
+stopwatch SW;
+
+/**
+ * データ列
+ * - N個のソート済み配列をRebuilds回作り直す (作り直すたびにデータも変わる)
+ */
+using data_t                   = uint32_t;
+constexpr data_t Inf           = std::numeric_limits<data_t>::max();  // ∞を表現するためだけの定数
+constexpr data_t Min           = 1;
+constexpr data_t Max           = Inf >> 1;
+constexpr std::size_t N        = (1 << 22);
+constexpr std::size_t Rebuilds = 8;
+
+/**
+ * 静的な索引 (ソート済み配列 + 分岐なし二分探索)
+ */
+struct sorted_index
+{
+    explicit sorted_index(const uint64_t seed) : xs(N + 1)
+    {
+        rng_base rng{seed};
+        for (std::size_t i = 0; i < N; i++) { xs[i] = rng.val<data_t>(Min, Max); }
+        std::sort(xs.begin(), xs.begin() + N);
+        xs[N] = Inf;
+    }
+
+    data_t lower_bound(const data_t v) const
+    {
+        const data_t* base = xs.data();
+        for (std::size_t len = N + 1; len > 1;) {
+            const std::size_t half = len / 2;
+            base += (base[half] < v) * half;
+            len -= half;
+        }
+        return *base < v ? base[1] : *base;
+    }
+
+    std::vector<data_t> xs;
+};
+
+/**
+ * 読み手のクエリ1回ごとの応答時間
+ */
+struct latency_t
+{
+    std::vector<uint32_t> nss;
+    data_t sum = 0;
+};
+
+void pin(const std::size_t t)
+{
+    const std::size_t cpus = std::max(std::thread::hardware_concurrency(), 1U);
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(t % cpus, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+/**
+ * 読み手ごとに応答時間を測りながらqueryを呼び続ける (doneになるまで)
+ */
+template<typename Query>
+std::vector<latency_t> run_readers(const std::size_t readers, const std::atomic<bool>& done, Query query)
+{
+    std::vector<latency_t> lats(readers);
+    std::vector<std::thread> ths;
+    for (std::size_t r = 0; r < readers; r++) {
+        ths.emplace_back([&, r] {
+            pin(r + 1);  // コア0は書き手
+            rng_base rng{Seed + 100 + r};
+            auto& lat = lats[r];
+            lat.nss.reserve(1 << 24);
+            while (not done.load(std::memory_order_relaxed)) {
+                const data_t v = rng.val<data_t>(Min, Max);
+                const auto t0  = std::chrono::steady_clock::now();
+                lat.sum += query(r, v);
+                const auto t1 = std::chrono::steady_clock::now();
+                lat.nss.push_back(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()));
+            }
+        });
+    }
+    for (auto& th : ths) { th.join(); }
+    return lats;
+}
+
+/**
+ * 応答時間の分布
+ */
+void print_latency(const std::vector<latency_t>& lats, const long long dur_ms)
+{
+    std::vector<uint32_t> nss;
+    data_t sum = 0;
+    for (const auto& lat : lats) {
+        nss.insert(nss.end(), lat.nss.begin(), lat.nss.end());
+        sum += lat.sum;
+    }
+    std::sort(nss.begin(), nss.end());
+    const auto at = [&](const double p) { return nss.empty() ? 0U : nss[std::min(nss.size() - 1, static_cast<std::size_t>(p * static_cast<double>(nss.size())))]; };
+    std::cout << "Total: " << dur_ms << " ms" << std::endl;
+    std::cout << "Queries: " << nss.size() << std::endl;
+    std::cout << "Latency p50: " << at(0.5) << " ns" << std::endl;
+    std::cout << "Latency p99: " << at(0.99) << " ns" << std::endl;
+    std::cout << "Latency p99.9: " << at(0.999) << " ns" << std::endl;
+    std::cout << "Latency max: " << (nss.empty() ? 0U : nss.back()) << " ns" << std::endl;
+    std::cout << "Sum(for Debug): " << sum << std::endl;
+    std::cout << std::endl;
+}
+
+namespace stop_the_world {
+
+/**
+ * 作り直している間は書き込みロックを持つ (読み手は待たされる)
+ */
+void test(const std::size_t readers)
+{
+    std::shared_mutex mutex;
+    auto index = std::make_unique<sorted_index>(Seed);
+    std::atomic<bool> done{false};
+    std::cout << "[Stop the World] (Readers: " << readers << ")" << std::endl;
+    SW.rap();
+    std::thread writer{[&] {
+        pin(0);
+        for (std::size_t i = 1; i <= Rebuilds; i++) {
+            std::unique_lock<std::shared_mutex> lock{mutex};
+            index = std::make_unique<sorted_index>(Seed + i);
+        }
+        done = true;
+    }};
+    const auto lats = run_readers(readers, done, [&](const std::size_t, const data_t v) {
+        std::shared_lock<std::shared_mutex> lock{mutex};
+        return index->lower_bound(v);
+    });
+    writer.join();
+    print_latency(lats, SW.rap());
+}
+
+}  // namespace stop_the_world
+
+namespace rcu {
+
+/**
+ * 別スレッドで作り直し、できたらポインタを差し替える (読み手は古いものを読み続ける)
+ */
+void test(const std::size_t readers)
+{
+    hot_swap<sorted_index> index{readers, std::make_unique<sorted_index>(Seed)};
+    std::atomic<bool> done{false};
+    std::cout << "[Hot Swap] (Readers: " << readers << ")" << std::endl;
+    SW.rap();
+    std::thread writer{[&] {
+        pin(0);
+        for (std::size_t i = 1; i <= Rebuilds; i++) {
+            index.rebuild([i] { return std::make_unique<sorted_index>(Seed + i); }).join();
+        }
+        done = true;
+    }};
+    const auto lats = run_readers(readers, done, [&](const std::size_t r, const data_t v) { return index.read(r)->lower_bound(v); });
+    writer.join();
+    index.synchronize();
+    print_latency(lats, SW.rap());
+}
+
+}  // namespace rcu
+
+/**
+ * 使い方: hot_swap_bench [読み手の数]
+ * - 書き手1つがRebuilds回作り直す間、読み手がクエリを投げ続ける
+ */
+int main(int argc, char* argv[])
+{
+    const std::size_t cpus    = std::max(std::thread::hardware_concurrency(), 1U);
+    const std::size_t readers = argc > 1 ? static_cast<std::size_t>(std::max(std::atoi(argv[1]), 1)) : std::max<std::size_t>(cpus - 1, 1);
+
+    stop_the_world::test(readers);
+    rcu::test(readers);
+    return 0;
+}
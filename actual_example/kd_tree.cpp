@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+
+#include "common/bit.hpp"
+#include "common/rng.hpp"
+#include "common/stopwatch.hpp"
+#include "common/tree_layout.hpp"
+
+constexpr uint64_t Seed = 20201013;
+rng_base Rng{Seed};
+stopwatch SW;
+
+/**
+ * 点列
+ */
+using coord_t               = uint32_t;
+constexpr coord_t Sentinel  = std::numeric_limits<coord_t>::max();
+constexpr coord_t MaxXY     = (1U << 30);
+constexpr std::size_t N     = (1 << 22);
+constexpr std::size_t TN    = ceil2(N + 1) - 1;  // 完全二分木のサイズ
+constexpr std::size_t R     = (TN + 1) / 2;      // 完全二分木の根
+constexpr coord_t RectSide  = (1U << 20);        // 矩形クエリの一辺 (1個あたり約4点)
+static_assert(MaxXY <= (1U << 31), "squared distances must fit in uint64_t");  // nearestは距離の2乗をuint64で持つ
+struct point_t
+{
+    coord_t x, y;
+};
+point_t* Ps;
+
+/**
+ * 質問
+ */
+constexpr std::size_t Q = (1 << 20);
+point_t* Qs;
+
+/**
+ * 頂点
+ * - l,r: 子のレイアウト上の位置 (葉はTN)
+ */
+struct node_t
+{
+    point_t p;
+    uint32_t l, r;
+};
+point_t* Nodes;  // 頂点番号 -> 点
+
+inline coord_t coord(const point_t& p, const std::size_t depth)
+{
+    return depth % 2 == 0 ? p.x : p.y;
+}
+
+void build(const std::size_t n, const std::size_t depth, point_t* first, point_t* last)
+{
+    point_t* mid = first + (last - first) / 2;
+    std::nth_element(first, mid, last, [&](const point_t& p1, const point_t& p2) { return coord(p1, depth) < coord(p2, depth); });
+    Nodes[n] = *mid;
+    if ((n & 1UL) == 0) {
+        build(layout::left(n), depth + 1, first, mid);
+        build(layout::right(n), depth + 1, mid + 1, last);
+    }
+}
+
+void data_init()
+{
+    Ps = new point_t[TN];
+    for (std::size_t i = 0; i < TN; i++) {
+        Ps[i] = i < N ? point_t{Rng.val<coord_t>(0, MaxXY), Rng.val<coord_t>(0, MaxXY)} : point_t{Sentinel, Sentinel};
+    }
+    Nodes = new point_t[TN + 1];
+    build(R, 0, Ps, Ps + TN);
+    Qs = new point_t[Q];
+    for (std::size_t q = 0; q < Q; q++) {
+        Qs[q] = {Rng.val<coord_t>(0, MaxXY - RectSide), Rng.val<coord_t>(0, MaxXY - RectSide)};
+    }
+}
+
+/**
+ * レイアウト上の木
+ */
+node_t* nodes;
+std::size_t root_pos;
+
+void init(const std::vector<std::size_t>& orders)
+{
+    std::vector<std::size_t> poss(TN + 1);
+    for (std::size_t i = 0; i < TN; i++) { poss[orders[i]] = i; }
+    nodes    = new node_t[TN];
+    root_pos = poss[R];
+    for (std::size_t i = 0; i < TN; i++) {
+        const std::size_t n = orders[i];
+        nodes[i].p          = Nodes[n];
+        nodes[i].l          = (n & 1UL) == 0 ? static_cast<uint32_t>(poss[layout::left(n)]) : static_cast<uint32_t>(TN);
+        nodes[i].r          = (n & 1UL) == 0 ? static_cast<uint32_t>(poss[layout::right(n)]) : static_cast<uint32_t>(TN);
+    }
+}
+
+void fin()
+{
+    delete[] nodes;
+}
+
+std::size_t range_count(const std::size_t pos, const std::size_t depth, const point_t& lo, const point_t& hi)
+{
+    if (pos == TN) { return 0; }
+    const node_t& node = nodes[pos];
+    std::size_t count  = node.p.x != Sentinel and lo.x <= node.p.x and node.p.x < hi.x and lo.y <= node.p.y and node.p.y < hi.y;
+    const coord_t s    = coord(node.p, depth);
+    if (coord(lo, depth) <= s) { count += range_count(node.l, depth + 1, lo, hi); }
+    if (s < coord(hi, depth)) { count += range_count(node.r, depth + 1, lo, hi); }
+    return count;
+}
+
+void nearest(const std::size_t pos, const std::size_t depth, const point_t& q, uint64_t& best)
+{
+    if (pos == TN) { return; }
+    const node_t& node = nodes[pos];
+    const uint64_t dx  = node.p.x > q.x ? node.p.x - q.x : q.x - node.p.x;
+    const uint64_t dy  = node.p.y > q.y ? node.p.y - q.y : q.y - node.p.y;
+    if (node.p.x != Sentinel) { best = std::min(best, dx * dx + dy * dy); }
+    const coord_t s = coord(node.p, depth), c = coord(q, depth);
+    nearest(c < s ? node.l : node.r, depth + 1, q, best);
+    const uint64_t gap = c < s ? s - c : c - s;
+    if (gap * gap < best) { nearest(c < s ? node.r : node.l, depth + 1, q, best); }
+}
+
+void test(const char* title, const std::vector<std::size_t>& orders)
+{
+    std::cout << title << std::endl;
+    init(orders);
+    std::size_t count = 0;
+    SW.rap();
+    for (std::size_t q = 0; q < Q; q++) {
+        count += range_count(root_pos, 0, Qs[q], point_t{Qs[q].x + RectSide, Qs[q].y + RectSide});
+    }
+    std::cout << "Range Total: " << SW.rap<std::chrono::nanoseconds>() << " ns (Points: " << count << ")" << std::endl;
+    uint64_t sum = 0;
+    SW.rap();
+    for (std::size_t q = 0; q < Q; q++) {
+        uint64_t best = std::numeric_limits<uint64_t>::max();
+        nearest(root_pos, 0, Qs[q], best);
+        sum += best;
+    }
+    std::cout << "Nearest Total: " << SW.rap<std::chrono::nanoseconds>() << " ns" << std::endl;
+    std::cout << "Sum(for Debug): " << sum << std::endl;
+    std::cout << std::endl;
+    fin();
+}
+
+int main()
+{
+    data_init();
+
+    test("[Sol1] BFS order", layout::bfs_orders(R));
+    test("[Sol2] DFS order", layout::dfs_orders(R));
+    test("[Sol3] vEB Layout", layout::vEB_orders(R));
+
+    return 0;
+}
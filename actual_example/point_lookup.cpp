@@ -0,0 +1,515 @@
+#include <algorithm>
+#include <cstdint>
+#include <immintrin.h>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "common/bit.hpp"
+#include "common/rng.hpp"
+#include "common/stopwatch.hpp"
+#include "common/tree_layout.hpp"
+
+constexpr uint64_t Seed = 20201013;
+rng_base Rng{Seed};
+stopwatch SW;
+
+/**
+ * データ列
+ * - キーはMin以上なので、0を空きスロットに使う
+ */
+using data_t            = uint32_t;
+constexpr data_t Inf    = std::numeric_limits<data_t>::max();  // ∞を表現するためだけの定数
+constexpr data_t Min    = 1;
+constexpr data_t Max    = Inf >> 1;
+constexpr data_t Empty  = 0;
+constexpr std::size_t N = (1 << 24);
+std::vector<data_t> Xs;  // ソート済み, 重複なし
+
+/**
+ * 検索する値たち
+ * - Ys: 半分がヒット、半分が外れ
+ * - Zs: ヒットは1/16だけ (ほとんど無いキーの存在確認)
+ */
+constexpr std::size_t Q = (1 << 24);
+std::vector<data_t> Ys, Zs;
+
+void data_init()
+{
+    Xs.resize(N);
+    for (auto& x : Xs) { x = Rng.val<data_t>(Min, Max); }
+    std::sort(Xs.begin(), Xs.end());
+    Xs.erase(std::unique(Xs.begin(), Xs.end()), Xs.end());
+    Ys.resize(Q);
+    for (std::size_t q = 0; q < Q; q++) { Ys[q] = q % 2 == 0 ? Xs[Rng.val<std::size_t>(0, Xs.size() - 1)] : Rng.val<data_t>(Min, Max); }
+    Zs.resize(Q);
+    for (std::size_t q = 0; q < Q; q++) { Zs[q] = q % 16 == 0 ? Xs[Rng.val<std::size_t>(0, Xs.size() - 1)] : Rng.val<data_t>(Min, Max); }
+}
+
+inline uint64_t mix(const data_t x, const uint64_t seed)
+{
+    uint64_t z = x + seed;
+    z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z          = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+constexpr uint64_t Seed1 = 0x9E3779B97F4A7C15ULL;
+constexpr uint64_t Seed2 = 0xC2B2AE3D27D4EB4FULL;
+
+/**
+ * 1スレッドで全クエリを投げて時間を測る
+ */
+template<typename Find>
+void test(const char* name, const std::size_t bytes, Find find, const std::vector<data_t>& qs = Ys)
+{
+    std::size_t hit = 0;
+    std::cout << name << std::endl;
+    std::cout << "Memory: " << bytes << " bytes" << std::endl;
+    SW.rap();
+    for (std::size_t q = 0; q < Q; q++) { hit += find(qs[q]); }
+    const auto dur_ns = SW.rap<std::chrono::nanoseconds>();
+    std::cout << "Query Total: " << dur_ns << " ns" << std::endl;
+    std::cout << "Per Query: " << static_cast<double>(dur_ns) / static_cast<double>(Q) << " ns" << std::endl;
+    std::cout << "Hit(for Debug): " << hit << std::endl;
+    std::cout << std::endl;
+}
+
+namespace sorting {
+
+/**
+ * 分岐なしの二分探索 (順序付きの索引の基準)
+ */
+inline bool find(const data_t v)
+{
+    const data_t* base = Xs.data();
+    for (std::size_t len = Xs.size(); len > 1;) {
+        const std::size_t half = len / 2;
+        base += (base[half] < v) * half;
+        len -= half;
+    }
+    return *base == v or (*base < v and base + 1 < Xs.data() + Xs.size() and base[1] == v);
+}
+
+}  // namespace sorting
+
+namespace eytzinger {
+
+/**
+ * BFS順のレイアウト (1-indexed)
+ * - 左詰めの完全二分探索木のBFS順がそのままxs[1, n]の並びになる (頂点の並べ方はcommon/tree_layout.hpp)
+ */
+std::vector<data_t> xs;
+
+void init()
+{
+    const std::size_t n                   = Xs.size();
+    const std::vector<std::size_t> orders = layout::complete_orders(layout::bfs_orders(ceil2(n + 1) / 2), n);
+    xs.assign(n + 1, Inf);
+    for (std::size_t i = 0; i < n; i++) { xs[i + 1] = Xs[layout::complete_rank(orders[i], n) - 1]; }
+}
+
+inline bool find(const data_t v)
+{
+    const std::size_t n = xs.size() - 1;
+    std::size_t k       = 1;
+    while (k <= n) {
+        __builtin_prefetch(xs.data() + 16 * k);
+        k = 2 * k + (xs[k] < v);
+    }
+    k >>= __builtin_ctzll(~k) + 1;
+    return xs[k] == v;
+}
+
+}  // namespace eytzinger
+
+namespace vEB {
+
+/**
+ * vEBレイアウトの二分探索木 (頂点の並べ方はcommon/tree_layout.hpp)
+ * - 頂点番号は、n頂点の左詰めの完全二分探索木での通りがけ順
+ * - xs: レイアウト, ls/rs: 左右の子のレイアウトでの位置 (なければn), root_pos: 根の位置
+ */
+std::size_t n;
+std::vector<data_t> xs;
+std::vector<std::size_t> ls, rs;
+std::size_t root_pos;
+
+void init()
+{
+    n                                     = Xs.size();
+    const std::size_t TN                  = ceil2(n + 1) - 1;
+    const std::size_t R                   = (TN + 1) / 2;
+    const std::vector<std::size_t> orders = layout::complete_orders(layout::vEB_orders(R), n);
+    std::vector<std::size_t> poss(TN + 1);
+    for (std::size_t i = 0; i < n; i++) { poss[orders[i]] = i; }
+    const auto child_pos = [&](const std::size_t k) { return layout::complete_contains(k, n) ? poss[k] : n; };
+    root_pos             = poss[R];
+    xs.resize(n), ls.resize(n), rs.resize(n);
+    for (std::size_t i = 0; i < n; i++) {
+        const std::size_t k = orders[i];
+        xs[i]               = Xs[layout::complete_rank(k, n) - 1];
+        ls[i]               = (k & 1UL) == 0 ? child_pos(layout::left(k)) : n;
+        rs[i]               = (k & 1UL) == 0 ? child_pos(layout::right(k)) : n;
+    }
+}
+
+inline bool find(const data_t v)
+{
+    for (std::size_t pos = root_pos; pos != n;) {
+        const data_t x = xs[pos];
+        if (x == v) { return true; }
+        pos = x < v ? rs[pos] : ls[pos];
+    }
+    return false;
+}
+
+}  // namespace vEB
+
+namespace b_tree {
+
+/**
+ * 一括構築したB+木 (頂点はconcurrent_b_treeと同じく256バイト, 読み込みだけなのでロック用のversionは持たない)
+ * - 葉: keys[0, count)に昇順のキー (全ての葉を満杯にする)
+ * - 中間ノード: sons[i]に含まれるキーは、keys[i-1]より大きくkeys[i]以下
+ * - 頂点は段ごとに配列に並べ、子は添字で持つ
+ */
+constexpr std::size_t NodeBytes = 256;
+constexpr std::size_t LeafCap   = (NodeBytes - sizeof(uint32_t)) / sizeof(data_t);
+constexpr std::size_t InnerCap  = (NodeBytes - 2 * sizeof(uint32_t)) / (sizeof(data_t) + sizeof(uint32_t));
+struct alignas(64) leaf_t
+{
+    uint32_t count;
+    data_t keys[LeafCap];
+};
+struct alignas(64) inner_t
+{
+    uint32_t count;
+    data_t keys[InnerCap];
+    uint32_t sons[InnerCap + 1];
+};
+static_assert(sizeof(leaf_t) <= NodeBytes and sizeof(inner_t) <= NodeBytes, "node must fit in NodeBytes");
+
+std::vector<leaf_t> leaves;
+std::vector<inner_t> inners;
+std::size_t root, height;  // 段数 (葉だけなら1)
+
+/**
+ * keys[0, count)でk未満のキーの個数
+ */
+inline std::size_t rank(const data_t* keys, const uint32_t count, const data_t k)
+{
+    std::size_t inf = 0, sup = count;
+    while (inf < sup) {
+        const std::size_t mid = (inf + sup) / 2;
+        if (keys[mid] < k) {
+            inf = mid + 1;
+        } else {
+            sup = mid;
+        }
+    }
+    return inf;
+}
+
+/**
+ * 葉の段から順に作る (各段は(頂点の添字, 部分木の最大のキー)の列で、上の段には最後以外の最大値を区切りとして渡す)
+ */
+void init()
+{
+    std::vector<std::pair<uint32_t, data_t>> level;
+    for (std::size_t i = 0; i < Xs.size(); i += LeafCap) {
+        leaf_t leaf{};
+        leaf.count = static_cast<uint32_t>(std::min(LeafCap, Xs.size() - i));
+        std::copy(Xs.begin() + i, Xs.begin() + i + leaf.count, leaf.keys);
+        level.emplace_back(static_cast<uint32_t>(leaves.size()), leaf.keys[leaf.count - 1]);
+        leaves.push_back(leaf);
+    }
+    for (height = 1; level.size() > 1; height++) {
+        std::vector<std::pair<uint32_t, data_t>> upper;
+        for (std::size_t i = 0; i < level.size(); i += InnerCap + 1) {
+            const std::size_t sons = std::min(InnerCap + 1, level.size() - i);
+            inner_t inner{};
+            inner.count = static_cast<uint32_t>(sons - 1);
+            for (std::size_t j = 0; j < sons; j++) {
+                inner.sons[j] = level[i + j].first;
+                if (j + 1 < sons) { inner.keys[j] = level[i + j].second; }
+            }
+            upper.emplace_back(static_cast<uint32_t>(inners.size()), level[i + sons - 1].second);
+            inners.push_back(inner);
+        }
+        level = std::move(upper);
+    }
+    root = level[0].first;
+}
+
+inline bool find(const data_t v)
+{
+    std::size_t node = root;
+    for (std::size_t h = height; h > 1; h--) {
+        const inner_t& inner = inners[node];
+        node                 = inner.sons[rank(inner.keys, inner.count, v)];
+    }
+    const leaf_t& leaf  = leaves[node];
+    const std::size_t i = rank(leaf.keys, leaf.count, v);
+    return i < leaf.count and leaf.keys[i] == v;
+}
+
+}  // namespace b_tree
+
+namespace linear_probing {
+
+/**
+ * 線形探査 (スロット数はキー数の2倍以上の2冪)
+ */
+std::vector<data_t> slots;
+std::size_t mask;
+
+void init()
+{
+    std::size_t num = 1;
+    while (num < 2 * Xs.size()) { num *= 2; }
+    slots.assign(num, Empty);
+    mask = num - 1;
+    for (const data_t x : Xs) {
+        std::size_t i = mix(x, Seed1) & mask;
+        while (slots[i] != Empty) { i = (i + 1) & mask; }
+        slots[i] = x;
+    }
+}
+
+inline bool find(const data_t v)
+{
+    for (std::size_t i = mix(v, Seed1) & mask;; i = (i + 1) & mask) {
+        if (slots[i] == v) { return true; }
+        if (slots[i] == Empty) { return false; }
+    }
+}
+
+}  // namespace linear_probing
+
+namespace cuckoo {
+
+/**
+ * バケット化したCuckooハッシュ (1バケット = 16キー = 1キャッシュライン)
+ * - キーは2つのバケットのどちらかにあり、バケット内はAVX2で一度に比べる
+ */
+constexpr std::size_t BucketSize = 16;
+struct alignas(64) bucket_t
+{
+    data_t keys[BucketSize];
+};
+std::vector<bucket_t> buckets;
+std::size_t mask;
+
+inline std::size_t bucket(const data_t x, const std::size_t i)
+{
+    return mix(x, i == 0 ? Seed1 : Seed2) & mask;
+}
+
+bool insert(data_t x, uint64_t& rnd)
+{
+    std::size_t b = bucket(x, 0);
+    for (std::size_t kick = 0; kick < 500; kick++) {
+        for (const std::size_t c : {bucket(x, 0), bucket(x, 1)}) {
+            for (auto& key : buckets[c].keys) {
+                if (key == Empty) {
+                    key = x;
+                    return true;
+                }
+            }
+        }
+        rnd ^= rnd << 13, rnd ^= rnd >> 7, rnd ^= rnd << 17;  // xorshift
+        b = (b == bucket(x, 0)) ? bucket(x, 1) : bucket(x, 0);
+        std::swap(x, buckets[b].keys[rnd % BucketSize]);
+    }
+    return false;
+}
+
+/**
+ * 充填率0.9以下のバケット数から始め、入らなければ倍にして作り直す
+ */
+void init()
+{
+    std::size_t num = 1;
+    while (static_cast<double>(num * BucketSize) * 0.9 < static_cast<double>(Xs.size())) { num *= 2; }
+    for (;; num *= 2) {
+        buckets.assign(num, bucket_t{});
+        mask         = num - 1;
+        uint64_t rnd = Seed;
+        if (std::all_of(Xs.begin(), Xs.end(), [&](const data_t x) { return insert(x, rnd); })) { break; }
+    }
+}
+
+inline bool contains(const bucket_t& b, const __m256i x)
+{
+    const __m256i lo = _mm256_cmpeq_epi32(x, _mm256_load_si256(reinterpret_cast<const __m256i*>(b.keys)));
+    const __m256i hi = _mm256_cmpeq_epi32(x, _mm256_load_si256(reinterpret_cast<const __m256i*>(b.keys + 8)));
+    return not _mm256_testz_si256(_mm256_or_si256(lo, hi), _mm256_or_si256(lo, hi));
+}
+
+/**
+ * 2つのバケットは独立なので、両方のロードを先に出しておく
+ */
+inline bool find(const data_t v)
+{
+    const __m256i x    = _mm256_set1_epi32(static_cast<int>(v));
+    const bucket_t& b0 = buckets[bucket(v, 0)];
+    const bucket_t& b1 = buckets[bucket(v, 1)];
+    __builtin_prefetch(&b1);
+    return contains(b0, x) or contains(b1, x);
+}
+
+}  // namespace cuckoo
+
+namespace swiss {
+
+/**
+ * Swiss Table
+ * - 制御バイト16個(1グループ)をSSE2で一度に比べ、h2が一致したスロットだけキーを読む
+ * - グループに空きがあれば打ち切る、なければ次のグループへ (三角数で飛ぶ)
+ */
+constexpr std::size_t GroupSize = 16;
+constexpr uint8_t CtrlEmpty     = 0x80;
+std::vector<uint8_t> ctrls;  // グループgの制御バイトは ctrls[16g, 16g+16)
+std::vector<data_t> slots;
+std::size_t mask;
+
+void init()
+{
+    std::size_t num = 1;
+    while (static_cast<double>(num * GroupSize) * 0.875 < static_cast<double>(Xs.size())) { num *= 2; }
+    ctrls.assign(num * GroupSize, CtrlEmpty);
+    slots.assign(num * GroupSize, Empty);
+    mask = num - 1;
+    for (const data_t x : Xs) {
+        const uint64_t h = mix(x, Seed1);
+        for (std::size_t g = (h >> 7) & mask, step = 1;; g = (g + step++) & mask) {
+            const auto it = std::find(ctrls.begin() + g * GroupSize, ctrls.begin() + (g + 1) * GroupSize, CtrlEmpty);
+            if (it == ctrls.begin() + (g + 1) * GroupSize) { continue; }
+            *it                       = static_cast<uint8_t>(h & 0x7F);
+            slots[it - ctrls.begin()] = x;
+            break;
+        }
+    }
+}
+
+inline bool find(const data_t v)
+{
+    const uint64_t h    = mix(v, Seed1);
+    const __m128i h2    = _mm_set1_epi8(static_cast<char>(h & 0x7F));
+    const __m128i empty = _mm_set1_epi8(static_cast<char>(CtrlEmpty));
+    for (std::size_t g = (h >> 7) & mask, step = 1;; g = (g + step++) & mask) {
+        const __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrls.data() + g * GroupSize));
+        for (unsigned m = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, h2))); m != 0; m &= m - 1) {
+            if (slots[g * GroupSize + static_cast<std::size_t>(__builtin_ctz(m))] == v) { return true; }
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, empty)) != 0) { return false; }
+    }
+}
+
+}  // namespace swiss
+
+namespace bloom {
+
+/**
+ * ブロック化したBloom Filter (Split Block Bloom Filter)
+ * - 1ブロック = 256bit = 32bitのレーン8本で、キーごとに各レーンに1bitずつ立てる
+ * - 判定はブロックを1回ロードし、立てるべきビットが全て立っているかをAVX2で調べるだけ (testc)
+ * - falseなら本体を探さずに「無い」と答える
+ */
+constexpr double BitsPerKey = 12.0;  // 偽陽性率は1%程度
+struct alignas(32) block_t
+{
+    uint32_t lanes[8];
+};
+std::vector<block_t> blocks;
+std::size_t skipped = 0;
+
+inline std::size_t block(const uint64_t h)
+{
+    return static_cast<std::size_t>(((h >> 32) * blocks.size()) >> 32);  // 剰余の代わりに掛けてシフト
+}
+
+/**
+ * 下位32bitに奇数の定数を掛けた上位5bitで、各レーンのビット位置を決める
+ */
+inline __m256i mask(const uint64_t h)
+{
+    const __m256i salts = _mm256_setr_epi32(0x47b6137b, 0x44974d91, static_cast<int>(0x8824ad5bU), static_cast<int>(0xa2b7289dU), 0x705495c7, 0x2df1424b, static_cast<int>(0x9efc4947U), 0x5c6bfb31);
+    const __m256i pos   = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(h)), salts), 27);
+    return _mm256_sllv_epi32(_mm256_set1_epi32(1), pos);
+}
+
+void init()
+{
+    blocks.assign(static_cast<std::size_t>(static_cast<double>(Xs.size()) * BitsPerKey / 256) + 1, block_t{});
+    for (const data_t x : Xs) {
+        const uint64_t h = mix(x, Seed1);
+        __m256i* b       = reinterpret_cast<__m256i*>(blocks[block(h)].lanes);
+        _mm256_store_si256(b, _mm256_or_si256(_mm256_load_si256(b), mask(h)));
+    }
+}
+
+inline bool may_contain(const data_t v)
+{
+    const uint64_t h = mix(v, Seed1);
+    return _mm256_testc_si256(_mm256_load_si256(reinterpret_cast<const __m256i*>(blocks[block(h)].lanes)), mask(h));
+}
+
+/**
+ * findの前段に置く (弾いた回数を数える)
+ */
+template<typename Find>
+auto filtered(Find find)
+{
+    return [find](const data_t v) {
+        if (not may_contain(v)) {
+            skipped++;
+            return false;
+        }
+        return find(v);
+    };
+}
+
+}  // namespace bloom
+
+/**
+ * 使い方: point_lookup_bench
+ * - 順序付きの索引(二分探索/Eytzinger/vEB/B+木)とハッシュ表で、キーがあるかどうかを調べる
+ * - ほとんど無いキーの存在確認では、Bloom Filterを前段に置いた場合と比べる
+ */
+int main()
+{
+    data_init();
+    SW.rap();
+    eytzinger::init();
+    vEB::init();
+    b_tree::init();
+    linear_probing::init();
+    cuckoo::init();
+    swiss::init();
+    bloom::init();
+    std::cout << "Build: " << SW.rap() << " ms" << std::endl;
+    std::cout << std::endl;
+
+    const std::size_t vEB_bytes    = vEB::xs.size() * (sizeof(data_t) + 2 * sizeof(std::size_t));
+    const std::size_t b_tree_bytes = b_tree::leaves.size() * sizeof(b_tree::leaf_t) + b_tree::inners.size() * sizeof(b_tree::inner_t);
+    test("[Sol1] Sorting", Xs.size() * sizeof(data_t), sorting::find);
+    test("[Sol2] Eytzinger Layout", eytzinger::xs.size() * sizeof(data_t), eytzinger::find);
+    test("[Sol3] vEB Layout", vEB_bytes, vEB::find);
+    test("[Sol4] B+-tree (Bulk Load, Node: 256 bytes)", b_tree_bytes, b_tree::find);
+    test("[Sol5] Linear Probing (Load: 0.5)", linear_probing::slots.size() * sizeof(data_t), linear_probing::find);
+    test("[Sol6] Cuckoo (Bucket: 16 keys)", cuckoo::buckets.size() * sizeof(cuckoo::bucket_t), cuckoo::find);
+    test("[Sol7] Swiss Table (Group: 16 slots)", swiss::ctrls.size() + swiss::slots.size() * sizeof(data_t), swiss::find);
+
+    const std::size_t filter_bytes = bloom::blocks.size() * sizeof(bloom::block_t);
+    test("[Sol8] Sorting (Mostly Absent)", Xs.size() * sizeof(data_t), sorting::find, Zs);
+    test("[Sol9] Bloom Filter + Sorting (Mostly Absent)", Xs.size() * sizeof(data_t) + filter_bytes, bloom::filtered(sorting::find), Zs);
+    std::cout << "Skipped: " << static_cast<double>(bloom::skipped) / static_cast<double>(Q) << std::endl;
+    std::cout << std::endl;
+    bloom::skipped = 0;
+    test("[Sol10] Eytzinger Layout (Mostly Absent)", eytzinger::xs.size() * sizeof(data_t), eytzinger::find, Zs);
+    test("[Sol11] Bloom Filter + Eytzinger Layout (Mostly Absent)", eytzinger::xs.size() * sizeof(data_t) + filter_bytes, bloom::filtered(eytzinger::find), Zs);
+    std::cout << "Skipped: " << static_cast<double>(bloom::skipped) / static_cast<double>(Q) << std::endl;
+    std::cout << std::endl;
+    return 0;
+}
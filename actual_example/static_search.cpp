@@ -1,55 +1,147 @@
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <immintrin.h>
 #include <iostream>
 #include <limits>
+#include <memory>
+#include <new>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <thread>
+#include <vector>
 
+#include "common/bench.hpp"
 #include "common/bit.hpp"
-#include "common/rng.hpp"
+#include "common/layout_file.hpp"
+#include "common/page_alloc.hpp"
+#include "common/perf_counter.hpp"
 #include "common/stopwatch.hpp"
+#include "common/tree_layout.hpp"
 
 constexpr uint64_t Seed = 20201013;
-rng_base Rng{Seed};
 stopwatch SW;
+perf_counter DTLB{perf_counter::DTLBLoadMiss};
 
-inline std::size_t left(const std::size_t n)  // 二分探索木で頂点 n の左にある頂点番号
+/**
+ * データ列 (Nは実行時に決める)
+ */
+using data_t         = uint32_t;
+constexpr data_t Inf = std::numeric_limits<data_t>::max();  // ∞を表現するためだけの定数
+constexpr data_t Min = 1;
+constexpr data_t Max = Inf >> 1;
+std::size_t N;
+std::vector<data_t> Xs;  // レイアウトをファイルから読んだときは、必要になるまで作らない
+
+/**
+ * 木の大きさ (頂点の並べ方はcommon/tree_layout.hpp)
+ * - TN: x1~xNが含まれる完全二分探索木のサイズ, R: その根, H: その高さ
+ */
+std::size_t TN, R, H;
+const std::size_t Threads = std::max(std::thread::hardware_concurrency(), 1U);  // レイアウトを並べるスレッド数
+
+void size_init(const std::size_t n)
 {
-    const std::size_t i = lsb(n) - 1;
-    return n - (1UL << i);
+    N = n;
+    if (N == 0) {  // 空の木 (根は無く、どのクエリもInfを返す)
+        TN = R = H = 0;
+        return;
+    }
+    TN = ceil2(N + 1) - 1;
+    R  = (TN + 1) / 2;
+    H  = lsb(R) + 1;
 }
-inline std::size_t right(const std::size_t n)  // 二分探索木で頂点 n の右にある頂点番号
+
+/**
+ * 検索する値たち
+ */
+std::size_t Q;
+std::vector<data_t> Ys;
+
+void data_init(const std::string& dist)
 {
-    const std::size_t i = lsb(n) - 1;
-    return n + (1UL << i);
+    Xs = bench::generate<data_t>(dist, N, Min, Max, Seed);
+    std::sort(Xs.begin(), Xs.end());  // ここでソートしてしまう
+}
+
+void query_init(const std::string& dist, const std::size_t q, const data_t xmax)
+{
+    Q  = q;
+    Ys = bench::generate_queries<data_t>(dist, Q, Min, Max, xmax, Seed + 1);
 }
 
 /**
- * データ列
+ * mmapしたレイアウトファイルからセクションを取り出す (要素数がcountでなければfalse)
+ * - 読み取り専用でmapしているので、読み込んだ配列に書き込んではいけない
  */
-using data_t            = uint32_t;
-constexpr data_t Inf    = std::numeric_limits<data_t>::max();  // ∞を表現するためだけの定数
-constexpr data_t Min    = 1;
-constexpr data_t Max    = Inf >> 1;
-constexpr std::size_t N = (1 << 24) + 64;
-data_t* Xs;
+template<typename T>
+bool load_section(const layout_reader& reader, const char* name, const std::size_t count, T*& ptr)
+{
+    std::size_t num;
+    const T* p = reader.get<T>(name, num);
+    if (p == nullptr or num != count) { return false; }
+    ptr = const_cast<T*>(p);
+    return true;
+}
 
 /**
- * 検索する値たち
+ * レイアウトの配列の確保 (ページサイズはPageで切り替える)
+ * - Backing: 実際に使われた確保方法
  */
-constexpr std::size_t Q = (1 << 24);
-data_t* Ys;
+page_alloc::page_t Page       = page_alloc::page_t::Small;
+page_alloc::backing_t Backing = page_alloc::backing_t::Small;
 
-void data_init()
+template<typename T>
+T* allocate(const std::size_t count)
 {
-    Xs = new data_t[N];
-    for (std::size_t i = 0; i < N; i++) {
-        Xs[i] = Rng.val<data_t>(Min, Max);
+    T* ptr = page_alloc::allocate_array<T>(count, Page, &Backing);
+    if (ptr == nullptr) { throw std::bad_alloc{}; }
+    return ptr;
+}
+
+template<typename T>
+void deallocate(T* ptr, const std::size_t count)
+{
+    page_alloc::deallocate_array(ptr, count, Page);
+}
+
+/**
+ * 頂点を並べて配列に置き、子の位置を結ぶ (ブロッキングとvEBで共通)
+ * - build(orders): 高さHの完全二分木の並びをorders[0, TN)に書く (common/tree_layout.hppの配列に直接書く版)
+ * - nodes頂点の左詰めの完全二分木に含まれない頂点を除いて置く (nodes = TNなら除かず、N個を超える部分はInf)
+ * - 子が無いときと番兵の添字はnodes
+ *   xs[nodes]=0はどのクエリよりも小さいので右に進み、自分に戻る
+ * - 根の位置を返す
+ */
+template<typename Build>
+std::size_t place(const std::size_t nodes, Build build, data_t* xs, std::size_t* ls, std::size_t* rs)
+{
+    const std::unique_ptr<std::size_t[]> orders{new std::size_t[TN]};
+    const std::unique_ptr<std::size_t[]> poss{new std::size_t[TN + 1]};  // 頂点番号iは、レイアウトでposs[i]番目に存在
+    build(orders.get());
+    layout::complete_orders(orders.get(), nodes);
+    for (std::size_t i = 0; i < nodes; i++) {
+        poss[orders[i]] = i;
     }
-    std::sort(Xs, Xs + N);  // ここでソートしてしまう
-    Ys = new data_t[Q];
-    for (std::size_t q = 0; q < Q; q++) {
-        Ys[q] = Rng.val<data_t>(Min, Max);
+    const auto child_pos = [&](const std::size_t n) { return layout::complete_contains(n, nodes) ? poss[n] : nodes; };
+    for (std::size_t i = 0; i < nodes; i++) {
+        const std::size_t order = orders[i];
+        const std::size_t rank  = layout::complete_rank(order, nodes);
+        xs[i]                   = rank > N ? Inf : Xs[rank - 1];
+        if ((order & 1UL) == 0) {
+            ls[i] = child_pos(layout::left(order));
+            rs[i] = child_pos(layout::right(order));
+        } else {
+            ls[i] = nodes;  // 無効な添字
+            rs[i] = nodes;  // 無効な添字
+        }
     }
+    xs[nodes] = 0;
+    ls[nodes] = nodes;
+    rs[nodes] = nodes;
+    return poss[R];
 }
 
 namespace sorting {
@@ -62,7 +154,7 @@ data_t* xs;
 
 void init()
 {
-    xs = new data_t[N + 1];
+    xs = allocate<data_t>(N + 1);
     for (std::size_t i = 0; i < N; i++) {
         xs[i] = Xs[i];
     }
@@ -71,7 +163,20 @@ void init()
 
 void fin()
 {
-    delete[] xs;
+    deallocate(xs, N + 1);
+}
+
+/**
+ * ファイルへの保存/ファイルからの読み込み
+ */
+void save(layout_writer& writer)
+{
+    writer.add("sorting.xs", xs, N + 1);
+}
+
+bool load(const layout_reader& reader)
+{
+    return load_section(reader, "sorting.xs", N + 1, xs);
 }
 
 /**
@@ -80,108 +185,138 @@ void fin()
  */
 inline data_t lower_bound(const data_t v)
 {
-    int inf = -1, sup = N;
+    std::ptrdiff_t inf = -1, sup = static_cast<std::ptrdiff_t>(N);  // Nは--nで決まるのでintには収まらないことがある
     while (sup - inf > 1) {
-        const std::size_t mid = (std::size_t)((inf + sup) / 2);
-        const data_t x        = xs[mid];
+        const std::ptrdiff_t mid = (inf + sup) / 2;
+        const data_t x           = xs[mid];
         if (x == v) { return v; }
         (x < v ? inf : sup) = mid;
     }
     return xs[sup];
 }
 
-inline void test()
+/**
+ * バッチクエリ応答
+ * - G個のクエリを同時に進める (分岐なしの二分探索を1段ずつ)
+ * - 各段で次に見る位置をプリフェッチしておく (他のG-1個を進めている間に届く)
+ */
+template<std::size_t G>
+inline void lower_bound_batch(const data_t* qs, data_t* out, const std::size_t n)
 {
-    data_t sum = 0;
-    std::cout << "[Sol1] Sorting" << std::endl;
-    SW.rap();
-    for (std::size_t q = 0; q < Q; q++) {
-        sum += lower_bound(Ys[q]);
+    for (std::size_t q0 = 0; q0 < n; q0 += G) {
+        const std::size_t g_num = std::min(G, n - q0);
+        std::size_t bases[G]    = {};
+        for (std::size_t len = N + 1; len > 1;) {
+            const std::size_t half = len / 2;
+            len -= half;
+            for (std::size_t g = 0; g < g_num; g++) {
+                bases[g] += (xs[bases[g] + half] < qs[q0 + g]) * half;
+                __builtin_prefetch(xs + bases[g] + len / 2);
+            }
+        }
+        for (std::size_t g = 0; g < g_num; g++) {
+            out[q0 + g] = xs[bases[g] + (xs[bases[g]] < qs[q0 + g])];
+        }
     }
-    const auto dur_ms = SW.rap<std::chrono::nanoseconds>();
-    std::cout << "Query Total: " << dur_ms << " ns" << std::endl;
-    std::cout << "Sum(for Debug): " << sum << std::endl;
-    std::cout << std::endl;
 }
 
 }  // namespace sorting
 
 namespace blocking {
 
-constexpr std::size_t TN = ceil2(N + 1) - 1;  // x1~xNが含まれる完全二分探索木のサイズ
-constexpr std::size_t R  = (TN + 1) / 2;      // 完全二分探索木の根
-
-std::size_t* poss;  // 頂点番号iは、レイアウトでpos[i]番目に存在
-std::size_t* inds;  // レイアウトでi番目にあるのは、頂点番号inds[i]
-
 /**
- * メインメモリ上で保持するデータ
+ * メインメモリ上で保持するデータ (ブロッキングの高さHeightsごとに持ち、use()で選んだ高さのものを使う)
+ * - Heights: 作る高さ (1~MaxHeight, 重複なし, --heightsで指定)
+ * - Shape: 木の形 (--shapeで指定)
+ *   Completeは左詰めの完全二分木でN頂点、Paddedは高さHの完全二分木でTN頂点 (N個を超える部分はInf)
+ *   ブロックは下から区切るので、Completeでは最下段が疎なブロックが各経路の一番下に来る
+ * - Nodes: レイアウトの頂点数 (Completeなら N, PaddedならTN)
  * - xs:レイアウト
- * - ls:pos[左の頂点]
- * - rs:pos[右の頂点]
+ * - ls:pos[左の頂点] (なければNodes)
+ * - rs:pos[右の頂点] (なければNodes)
  * - root_pos: 根がレイアウトの何番目にあるか
  */
+constexpr std::size_t MaxHeight = 63;  // 木の高さ以上なら全体が1ブロックになるだけ
+std::vector<std::size_t> Heights{3, 4, 5, 6, 7};
+layout::shape_t Shape = layout::shape_t::Complete;
+std::size_t Nodes;
 data_t* xs;
 std::size_t* ls;
 std::size_t* rs;
 std::size_t root_pos;
+data_t* xss[MaxHeight + 1];
+std::size_t* lss[MaxHeight + 1];
+std::size_t* rss[MaxHeight + 1];
+std::size_t root_poss[MaxHeight + 1];
 
-/**
- * 頂点r以下の部分木に関するLayout
- * - block_height: ブロッキングの高さ
- */
-template<std::size_t block_height>
-void layout(const std::size_t r, std::size_t& index)
+void init_height(const std::size_t block_height)
 {
-    const std::size_t height = lsb(r) + 1;
-    const std::size_t offset = r - (1UL << (height - 1));
-    const std::size_t uh     = (height - 1) % block_height + 1;  // rを含むブロックの高さ
-    const std::size_t dh     = height - uh;
-    for (std::size_t i = 1; i < (1UL << uh); i++) {
-        inds[index++] = i * (1UL << dh) + offset;
-    }
-    if (dh != 0) {
-        for (std::size_t i = 1; i <= (1UL << uh); i++) {
-            layout<block_height>((1UL << (dh - 1)) * (i * 2 - 1) + offset, index);
-        }
-    }
+    xs       = xss[block_height] = allocate<data_t>(Nodes + 1);
+    ls       = lss[block_height] = allocate<std::size_t>(Nodes + 1);
+    rs       = rss[block_height] = allocate<std::size_t>(Nodes + 1);
+    root_pos = root_poss[block_height] = place(Nodes, [block_height](std::size_t* orders) { layout::block_orders(R, block_height, orders, Threads); }, xs, ls, rs);
 }
 
-template<std::size_t block_height>
 void init()
 {
-    poss = new std::size_t[TN + 1];
-    inds = new std::size_t[TN];
-    xs   = new data_t[TN];
-    ls   = new std::size_t[TN];
-    rs   = new std::size_t[TN];
+    Nodes = Shape == layout::shape_t::Padded ? TN : N;
+    for (const std::size_t h : Heights) { init_height(h); }
+}
 
-    std::size_t index = 0;
-    layout<block_height>(R, index);
-    for (std::size_t i = 0; i < TN; i++) {
-        poss[inds[i]] = i;
+void fin()
+{
+    for (const std::size_t h : Heights) {
+        deallocate(xss[h], Nodes + 1);
+        deallocate(lss[h], Nodes + 1);
+        deallocate(rss[h], Nodes + 1);
     }
-    root_pos = poss[R];
-    for (std::size_t i = 0; i < TN; i++) {
-        const std::size_t ind = inds[i];
-        xs[i]                 = ind > N ? Inf : Xs[ind - 1];
-        if ((ind & 1UL) == 0) {
-            ls[i] = poss[left(ind)];
-            rs[i] = poss[right(ind)];
-        } else {
-            ls[i] = TN;  // 無効な添字
-            rs[i] = TN;  // 無効な添字
+}
+
+/**
+ * ファイルへの保存/ファイルからの読み込み (高さhのレイアウトはblocking<h>.*、Paddedならblocking_padded<h>.*に置く)
+ * - Heightsのどれかが無いファイルは読めない (作り直して上書きする)
+ */
+std::string section_prefix(const std::size_t h)
+{
+    return (Shape == layout::shape_t::Padded ? "blocking_padded" : "blocking") + std::to_string(h);
+}
+
+void save(layout_writer& writer)
+{
+    for (const std::size_t h : Heights) {
+        const std::string prefix = section_prefix(h);
+        writer.add(prefix + ".xs", xss[h], Nodes + 1);
+        writer.add(prefix + ".ls", lss[h], Nodes + 1);
+        writer.add(prefix + ".rs", rss[h], Nodes + 1);
+        writer.add(prefix + ".root_pos", &root_poss[h], 1);
+    }
+}
+
+bool load(const layout_reader& reader)
+{
+    Nodes = Shape == layout::shape_t::Padded ? TN : N;
+    for (const std::size_t h : Heights) {
+        const std::string prefix = section_prefix(h);
+        std::size_t* root_pos_ptr;
+        if (not(load_section(reader, (prefix + ".xs").c_str(), Nodes + 1, xss[h]) and load_section(reader, (prefix + ".ls").c_str(), Nodes + 1, lss[h])
+                and load_section(reader, (prefix + ".rs").c_str(), Nodes + 1, rss[h]) and load_section(reader, (prefix + ".root_pos").c_str(), 1, root_pos_ptr))) {
+            return false;
         }
+        root_poss[h] = *root_pos_ptr;
     }
+    return true;
 }
 
-void fin()
+/**
+ * 高さblock_heightのレイアウトを使う
+ */
+void use(const std::size_t block_height)
 {
-    delete[] poss;
-    delete[] inds;
-    delete[] xs;
-    delete[] ls;
-    delete[] rs;
+    assert(std::find(Heights.begin(), Heights.end(), block_height) != Heights.end());
+    xs       = xss[block_height];
+    ls       = lss[block_height];
+    rs       = rss[block_height];
+    root_pos = root_poss[block_height];
 }
 
 /**
@@ -191,7 +326,7 @@ void fin()
 inline data_t lower_bound(const data_t v)
 {
     data_t ans = Inf;
-    for (std::size_t pos = root_pos; pos != TN;) {
+    for (std::size_t pos = root_pos; pos != Nodes;) {
         const data_t x = xs[pos];
         if (x == v) { return v; }
         if (x < v) {
@@ -204,36 +339,49 @@ inline data_t lower_bound(const data_t v)
     return ans;
 }
 
-template<std::size_t block_height>
-inline void test()
+/**
+ * バッチクエリ応答
+ * - G個のクエリを同時にH段ずつ降ろす
+ *   左詰めの木なので最下段の手前で抜けるクエリもあるが、抜けた先は番兵の位置Nodes
+ *   (xs[Nodes]=0はどのクエリよりも小さいので答えを変えず、ls[Nodes]=rs[Nodes]=Nodesで自分に戻る) なので、段数は全員Hで揃えてよい
+ * - 各段で次の頂点をプリフェッチしておく
+ */
+template<std::size_t G>
+inline void lower_bound_batch(const data_t* qs, data_t* out, const std::size_t n)
 {
-    data_t sum = 0;
-    std::cout << "[Sol2] Blocking (Block Height: " << block_height << ")" << std::endl;
-    SW.rap();
-    for (std::size_t q = 0; q < Q; q++) {
-        sum += lower_bound(Ys[q]);
+    for (std::size_t q0 = 0; q0 < n; q0 += G) {
+        const std::size_t g_num = std::min(G, n - q0);
+        std::size_t curs[G];  // 各クエリが今いる位置
+        for (std::size_t g = 0; g < g_num; g++) {
+            curs[g]     = root_pos;
+            out[q0 + g] = Inf;
+        }
+        for (std::size_t h = 0; h < H; h++) {
+            for (std::size_t g = 0; g < g_num; g++) {
+                const data_t x = xs[curs[g]];
+                if (x < qs[q0 + g]) {
+                    curs[g] = rs[curs[g]];
+                } else {
+                    out[q0 + g] = x;
+                    curs[g]     = ls[curs[g]];
+                }
+                __builtin_prefetch(xs + curs[g]);
+                __builtin_prefetch(ls + curs[g]);
+                __builtin_prefetch(rs + curs[g]);
+            }
+        }
     }
-    const auto dur_ms = SW.rap<std::chrono::nanoseconds>();
-    std::cout << "Query Total: " << dur_ms << " ns" << std::endl;
-    std::cout << "Sum(for Debug): " << sum << std::endl;
-    std::cout << std::endl;
 }
 
 }  // namespace blocking
 
 namespace vEB {
 
-constexpr std::size_t TN = ceil2(N + 1) - 1;  // x1~xNが含まれる完全二分探索木のサイズ
-constexpr std::size_t R  = (TN + 1) / 2;      // 完全二分探索木の根
-
-std::size_t* poss;  // 頂点番号iは、レイアウトでpos[i]番目に存在
-std::size_t* inds;  // レイアウトでi番目にあるのは、頂点番号inds[i]
-
 /**
  * メインメモリ上で保持するデータ
  * - xs:レイアウト
- * - ls:pos[左の頂点]
- * - rs:pos[右の頂点]
+ * - ls:pos[左の頂点] (なければN)
+ * - rs:pos[右の頂点] (なければN)
  * - root_pos: 根がレイアウトの何番目にあるか
  */
 data_t* xs;
@@ -241,122 +389,1084 @@ std::size_t* ls;
 std::size_t* rs;
 std::size_t root_pos;
 
+void init()
+{
+    xs       = allocate<data_t>(N + 1);
+    ls       = allocate<std::size_t>(N + 1);
+    rs       = allocate<std::size_t>(N + 1);
+    root_pos = place(N, [](std::size_t* orders) { layout::vEB_orders(R, orders, Threads); }, xs, ls, rs);
+}
+
+void fin()
+{
+    deallocate(xs, N + 1);
+    deallocate(ls, N + 1);
+    deallocate(rs, N + 1);
+}
+
 /**
- * 頂点r以下の部分木に関するLayout
+ * ファイルへの保存/ファイルからの読み込み
  */
-void layout(const std::size_t r, std::size_t& index)
+void save(layout_writer& writer)
 {
-    if (r & 1UL) {
-        inds[index++] = r;
-        return;
+    writer.add("vEB.xs", xs, N + 1);
+    writer.add("vEB.ls", ls, N + 1);
+    writer.add("vEB.rs", rs, N + 1);
+    writer.add("vEB.root_pos", &root_pos, 1);
+}
+
+bool load(const layout_reader& reader)
+{
+    std::size_t* root_pos_ptr;
+    if (not(load_section(reader, "vEB.xs", N + 1, xs) and load_section(reader, "vEB.ls", N + 1, ls) and load_section(reader, "vEB.rs", N + 1, rs) and load_section(reader, "vEB.root_pos", 1, root_pos_ptr))) { return false; }
+    root_pos = *root_pos_ptr;
+    return true;
+}
+
+/**
+ * クエリ応答
+ * - 根から降りる
+ */
+inline data_t lower_bound(const data_t v)
+{
+    data_t ans = Inf;
+    for (std::size_t pos = root_pos; pos != N;) {
+        const data_t x = xs[pos];
+        if (x == v) { return v; }
+        if (x < v) {
+            pos = rs[pos];
+        } else {
+            ans = x;
+            pos = ls[pos];
+        }
     }
-    const std::size_t height = lsb(r) + 1;
-    const std::size_t offset = r - (1UL << (height - 1));
-    const std::size_t uh     = height / 2;
-    const std::size_t dh     = height - uh;
-    std::size_t old_index    = index;
-    layout(r / (1UL << dh), index);
-    for (std::size_t i = old_index; i < index; i++) {
-        inds[i] *= (1UL << dh);
-    }
-    if (dh > 0) {
-        for (std::size_t i = 1; i <= (1UL << uh); i++) {
-            layout((1UL << (dh - 1)) * (i * 2 - 1) + offset, index);
+    return ans;
+}
+
+/**
+ * バッチクエリ応答
+ * - G個のクエリを同時にH段ずつ降ろす
+ *   左詰めの木なので最下段の手前で抜けるクエリもあるが、抜けた先は番兵の位置N
+ *   (xs[N]=0はどのクエリよりも小さいので答えを変えず、ls[N]=rs[N]=Nで自分に戻る) なので、段数は全員Hで揃えてよい
+ * - 各段で次の頂点をプリフェッチしておく
+ */
+template<std::size_t G>
+inline void lower_bound_batch(const data_t* qs, data_t* out, const std::size_t n)
+{
+    for (std::size_t q0 = 0; q0 < n; q0 += G) {
+        const std::size_t g_num = std::min(G, n - q0);
+        std::size_t curs[G];  // 各クエリが今いる位置
+        for (std::size_t g = 0; g < g_num; g++) {
+            curs[g]     = root_pos;
+            out[q0 + g] = Inf;
+        }
+        for (std::size_t h = 0; h < H; h++) {
+            for (std::size_t g = 0; g < g_num; g++) {
+                const data_t x = xs[curs[g]];
+                if (x < qs[q0 + g]) {
+                    curs[g] = rs[curs[g]];
+                } else {
+                    out[q0 + g] = x;
+                    curs[g]     = ls[curs[g]];
+                }
+                __builtin_prefetch(xs + curs[g]);
+                __builtin_prefetch(ls + curs[g]);
+                __builtin_prefetch(rs + curs[g]);
+            }
         }
     }
 }
 
-void init()
+}  // namespace vEB
+
+namespace implicit_vEB {
+
+/**
+ * メインメモリ上で保持するデータ
+ * - xs:レイアウト (キーのみ, 高さHの完全二分木のTN個分でN個を超える部分はInf)
+ *   子の位置を添字の計算だけで求めるので、ブロッキング/vEBと違って左詰めにして葉を間引くことはしない
+ *   (間引く葉はvEBの並びのあちこちに散るので、末尾を切り詰めるだけでは済まない)
+ *   そのためNが2冪を少し超えると、キーの約2倍のメモリを使う
+ * - ts,bs,ds: 深さdの頂点を根とする下の部分木が切り出された段での上の部分木のサイズ, 下の部分木のサイズ, 上の部分木の根の深さ
+ */
+data_t* xs;
+std::size_t ts[64];
+std::size_t bs[64];
+std::size_t ds[64];
+
+/**
+ * 深さdepthを根とする高さheightの部分木の分割を表に書く
+ */
+void tables(const std::size_t depth, const std::size_t height)
 {
-    poss = new std::size_t[TN + 1];
-    inds = new std::size_t[TN];
-    xs   = new data_t[TN];
-    ls   = new std::size_t[TN];
-    rs   = new std::size_t[TN];
+    if (height == 1) { return; }
+    const std::size_t uh = height / 2;
+    const std::size_t dh = height - uh;
+    ts[depth + uh]       = (1UL << uh) - 1;
+    bs[depth + uh]       = (1UL << dh) - 1;
+    ds[depth + uh]       = depth;
+    tables(depth, uh);
+    tables(depth + uh, dh);
+}
 
-    std::size_t index = 0;
-    layout(R, index);
-    for (std::size_t i = 0; i < TN; i++) {
-        poss[inds[i]] = i;
-    }
-    root_pos = poss[R];
+void init()
+{
+    const std::unique_ptr<std::size_t[]> orders{new std::size_t[TN]};
+    layout::vEB_orders(R, orders.get(), Threads);
+    xs = allocate<data_t>(TN);
     for (std::size_t i = 0; i < TN; i++) {
-        const std::size_t ind = inds[i];
-        xs[i]                 = ind > N ? Inf : Xs[ind - 1];
-        if ((ind & 1UL) == 0) {
-            ls[i] = poss[left(ind)];
-            rs[i] = poss[right(ind)];
-        } else {
-            ls[i] = TN;  // 無効な添字
-            rs[i] = TN;  // 無効な添字
-        }
+        xs[i] = orders[i] > N ? Inf : Xs[orders[i] - 1];
     }
+    tables(0, H);
 }
 
 void fin()
 {
-    delete[] poss;
-    delete[] inds;
-    delete[] xs;
-    delete[] ls;
-    delete[] rs;
+    deallocate(xs, TN);
+}
+
+/**
+ * ファイルへの保存/ファイルからの読み込み (深さごとの表は作り直す)
+ */
+void save(layout_writer& writer)
+{
+    writer.add("implicit_vEB.xs", xs, TN);
+}
+
+bool load(const layout_reader& reader)
+{
+    tables(0, H);
+    return load_section(reader, "implicit_vEB.xs", TN, xs);
 }
 
 /**
  * クエリ応答
  * - 根から降りる
+ * - BFS番号iの深さdの頂点の位置は poss[ds[d]] + ts[d] + (i & ts[d]) * bs[d]
  */
 inline data_t lower_bound(const data_t v)
 {
     data_t ans = Inf;
-    for (std::size_t pos = root_pos; pos != TN;) {
-        const data_t x = xs[pos];
+    std::size_t poss[64];  // poss[d]: 今いる頂点の深さdの祖先の位置
+    poss[0]       = 0;
+    std::size_t i = 1;
+    for (std::size_t d = 0;;) {
+        const data_t x = xs[poss[d]];
         if (x == v) { return v; }
         if (x < v) {
-            pos = rs[pos];
+            i = 2 * i + 1;
         } else {
             ans = x;
-            pos = ls[pos];
+            i   = 2 * i;
         }
+        if (++d == H) { break; }
+        poss[d] = poss[ds[d]] + ts[d] + (i & ts[d]) * bs[d];
     }
     return ans;
 }
 
-inline void test()
+}  // namespace implicit_vEB
+
+namespace eytzinger {
+
+/**
+ * メインメモリ上で保持するデータ
+ * - xs:BFS順のレイアウト (1-indexed, xs[0]はInf)
+ *   xs[16k]がキャッシュラインの先頭に来るように64byte境界に置く
+ */
+data_t* xs;
+
+/**
+ * 頂点k以下の部分木に昇順の値を中順で詰める
+ */
+void layout(const std::size_t k, std::size_t& index)
+{
+    if (k > N) { return; }
+    layout(2 * k, index);
+    xs[k] = Xs[index++];
+    layout(2 * k + 1, index);
+}
+
+void init()
+{
+    xs                = allocate<data_t>(N + 1);
+    xs[0]             = Inf;
+    std::size_t index = 0;
+    layout(1, index);
+}
+
+void fin()
 {
-    data_t sum = 0;
-    std::cout << "[Sol3] vEB Layout" << std::endl;
+    deallocate(xs, N + 1);
+}
+
+/**
+ * ファイルへの保存/ファイルからの読み込み (セクションは64byte境界に置かれる)
+ */
+void save(layout_writer& writer)
+{
+    writer.add("eytzinger.xs", xs, N + 1);
+}
+
+bool load(const layout_reader& reader)
+{
+    return load_section(reader, "eytzinger.xs", N + 1, xs);
+}
+
+/**
+ * クエリ応答
+ * - 分岐なしで葉まで降りる
+ * - 4段先の子孫16個(1キャッシュライン)をプリフェッチする
+ * - 最後に左に降りた頂点が答え
+ */
+inline data_t lower_bound(const data_t v)
+{
+    std::size_t k = 1;
+    while (k <= N) {
+        __builtin_prefetch(xs + 16 * k);
+        k = 2 * k + (xs[k] < v);
+    }
+    k >>= __builtin_ctzll(~k) + 1;
+    return xs[k];
+}
+
+}  // namespace eytzinger
+
+namespace s_tree {
+
+constexpr std::size_t B = 16;               // 頂点あたりのキー数 (1キャッシュライン)
+constexpr data_t Bias   = data_t{1} << 31;  // 符号付き比較のためにキーに足しておく値
+std::size_t NB;                             // 頂点数 (Nで決まるのでinit/loadで計算する)
+
+/**
+ * 頂点
+ * - キーはBiasとのxorを取って符号付き整数として比較する
+ */
+struct alignas(64) node_t
+{
+    data_t keys[B];
+};
+
+/**
+ * メインメモリ上で保持するデータ
+ * - nodes: 頂点単位のBFS順のレイアウト (頂点kのi番目の子は k*(B+1)+i+1)
+ */
+node_t* nodes;
+
+inline std::size_t child(const std::size_t k, const std::size_t i)
+{
+    return k * (B + 1) + i + 1;
+}
+
+/**
+ * 頂点k以下の部分木に昇順の値を中順で詰める
+ */
+void layout(const std::size_t k, std::size_t& index)
+{
+    if (k >= NB) { return; }
+    for (std::size_t i = 0; i < B; i++) {
+        layout(child(k, i), index);
+        nodes[k].keys[i] = (index < N ? Xs[index++] : Inf) ^ Bias;
+    }
+    layout(child(k, B), index);
+}
+
+void init()
+{
+    NB                = (N + B - 1) / B;
+    nodes             = allocate<node_t>(NB);
+    std::size_t index = 0;
+    layout(0, index);
+}
+
+void fin()
+{
+    deallocate(nodes, NB);
+}
+
+/**
+ * ファイルへの保存/ファイルからの読み込み
+ */
+void save(layout_writer& writer)
+{
+    writer.add("s_tree.nodes", nodes, NB);
+}
+
+bool load(const layout_reader& reader)
+{
+    NB = (N + B - 1) / B;
+    return load_section(reader, "s_tree.nodes", NB, nodes);
+}
+
+/**
+ * 頂点内でx未満のキーの個数
+ * - 8キーずつ比較してmovemask -> popcount
+ */
+inline std::size_t rank(const node_t& node, const __m256i x)
+{
+    const __m256i lo  = _mm256_load_si256(reinterpret_cast<const __m256i*>(node.keys));
+    const __m256i hi  = _mm256_load_si256(reinterpret_cast<const __m256i*>(node.keys + 8));
+    const int lo_mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, lo)));
+    const int hi_mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, hi)));
+    return static_cast<std::size_t>(__builtin_popcount(static_cast<unsigned>(lo_mask | (hi_mask << 8))));
+}
+
+/**
+ * クエリ応答
+ * - 根から降りる (1段で1頂点)
+ */
+inline data_t lower_bound(const data_t v)
+{
+    const __m256i x = _mm256_set1_epi32(static_cast<int>(v ^ Bias));
+    data_t ans      = Inf;
+    for (std::size_t k = 0; k < NB;) {
+        const std::size_t r = rank(nodes[k], x);
+        if (r < B) { ans = nodes[k].keys[r] ^ Bias; }
+        k = child(k, r);
+    }
+    return ans;
+}
+
+}  // namespace s_tree
+
+namespace css_tree {
+
+constexpr std::size_t B      = 16;               // 頂点あたりのキー数 (1キャッシュライン)
+constexpr std::size_t Fanout = B + 1;            // 中間ノードの子の数
+constexpr data_t Bias        = data_t{1} << 31;  // 符号付き比較のためにキーに足しておく値
+
+/**
+ * 段の数と段ごとの頂点数 (段0が葉)
+ * - 葉はソート済み配列をB個ずつに区切ったもの (少なくとも1個のInfで埋める)
+ * - Nums[h]: 段hの頂点数, Offsets[h]: 段hの先頭の頂点の位置 (根から段ごとに並べる)
+ * - 降りるたびに計算しないように表にしておく (段数はNで決まるのでinit/loadで計算する)
+ */
+std::size_t H, NB;
+std::size_t Nums[16];
+std::size_t Offsets[16];
+
+void levels()
+{
+    Nums[0] = N / B + 1;
+    for (H = 1; Nums[H - 1] > 1; H++) { Nums[H] = (Nums[H - 1] + Fanout - 1) / Fanout; }
+    NB = 0;
+    for (std::size_t h = H; h-- > 0;) {
+        Offsets[h] = NB;
+        NB += Nums[h];
+    }
+}
+
+/**
+ * 頂点
+ * - キーはBiasとのxorを取って符号付き整数として比較する
+ */
+struct alignas(64) node_t
+{
+    data_t keys[B];
+};
+
+/**
+ * メインメモリ上で保持するデータ
+ * - nodes: 段ごとのレイアウト (段hのk番目の頂点のi番目の子は段h-1のk*Fanout+i番目, ポインタは持たない)
+ *   中間ノードのi番目のキーはi番目の子の部分木の最大値 (子が無ければInf)
+ */
+node_t* nodes;
+
+void init()
+{
+    levels();
+    nodes           = allocate<node_t>(NB);
+    const auto leaf = [](const std::size_t l, const std::size_t j) { return l * B + j < N ? Xs[l * B + j] : Inf; };
+    for (std::size_t l = 0; l < Nums[0]; l++) {
+        for (std::size_t j = 0; j < B; j++) { nodes[Offsets[0] + l].keys[j] = leaf(l, j) ^ Bias; }
+    }
+    std::size_t span = 1;  // 段h-1の頂点の部分木に含まれる葉の個数
+    for (std::size_t h = 1; h < H; h++) {
+        for (std::size_t k = 0; k < Nums[h]; k++) {
+            for (std::size_t j = 0; j < B; j++) {
+                const std::size_t c           = k * Fanout + j;
+                nodes[Offsets[h] + k].keys[j] = (c < Nums[h - 1] ? leaf(std::min((c + 1) * span, Nums[0]) - 1, B - 1) : Inf) ^ Bias;
+            }
+        }
+        span *= Fanout;
+    }
+}
+
+void fin()
+{
+    deallocate(nodes, NB);
+}
+
+/**
+ * ファイルへの保存/ファイルからの読み込み
+ */
+void save(layout_writer& writer)
+{
+    writer.add("css_tree.nodes", nodes, NB);
+}
+
+bool load(const layout_reader& reader)
+{
+    levels();
+    return load_section(reader, "css_tree.nodes", NB, nodes);
+}
+
+/**
+ * 頂点内でx未満のキーの個数 (s_treeと同じ)
+ */
+inline std::size_t rank(const node_t& node, const __m256i x)
+{
+    const __m256i lo  = _mm256_load_si256(reinterpret_cast<const __m256i*>(node.keys));
+    const __m256i hi  = _mm256_load_si256(reinterpret_cast<const __m256i*>(node.keys + 8));
+    const int lo_mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, lo)));
+    const int hi_mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, hi)));
+    return static_cast<std::size_t>(__builtin_popcount(static_cast<unsigned>(lo_mask | (hi_mask << 8))));
+}
+
+/**
+ * クエリ応答
+ * - 子の位置を計算しながら葉まで降りる (途中で答えを覚えておく必要はない)
+ * - 葉で見つけたキーが答え
+ */
+inline data_t lower_bound(const data_t v)
+{
+    const __m256i x = _mm256_set1_epi32(static_cast<int>(v ^ Bias));
+    std::size_t k   = 0;
+    for (std::size_t h = H - 1; h > 0; h--) {
+        k = k * Fanout + rank(nodes[Offsets[h] + k], x);
+    }
+    const node_t& leaf = nodes[Offsets[0] + k];
+    return leaf.keys[rank(leaf, x)] ^ Bias;
+}
+
+}  // namespace css_tree
+
+namespace compressed_css_tree {
+
+constexpr std::size_t LeafBytes = 56;  // 葉のうち差分を詰める部分のバイト数
+
+/**
+ * 葉 (1キャッシュライン)
+ * - 先頭のキーbaseとの差分(Frame of Reference)をwidthビット(8/16/32)のレーンに詰める
+ * - 差分は符号付き比較のためにレーンの最上位ビットとxorを取っておく
+ * - レーン幅をバイト単位にしているのは、AVX2でそのまま比較できるようにするため (展開しなくてよい)
+ */
+struct alignas(64) leaf_t
+{
+    union
+    {
+        uint8_t d8[LeafBytes];
+        uint16_t d16[LeafBytes / 2];
+        uint32_t d32[LeafBytes / 4];
+    };
+    data_t base;
+    uint16_t count;
+    uint16_t width;
+};
+static_assert(sizeof(leaf_t) == 64, "leaf_t must be a cache line");
+
+/**
+ * メインメモリ上で保持するデータ
+ * - leaves: 葉 (NL個, 末尾にInfを足したデータを先頭から貪欲に詰める)
+ * - nodes: 葉の上の中間ノード (css_treeと同じく段ごとのレイアウト, NB個)
+ * - Offsets[h]: 段h(>=1)の先頭の頂点の位置 (段数Hは葉の数で決まる)
+ */
+leaf_t* leaves;
+css_tree::node_t* nodes;
+std::size_t NL, NB, H;
+std::size_t Offsets[16];
+
+inline data_t key(const std::size_t i)
+{
+    return i < N ? Xs[i] : Inf;
+}
+
+/**
+ * Xs[i]から始まる葉に入るキーの個数とレーン幅 (一番多く入る幅を選ぶ)
+ */
+std::size_t fill(const std::size_t i, uint16_t& width)
+{
+    std::size_t best = 0;
+    for (const uint16_t w : {uint16_t{8}, uint16_t{16}, uint16_t{32}}) {
+        const std::size_t cap = LeafBytes * 8 / w;
+        const data_t lim      = w == 32 ? Inf : (data_t{1} << w) - 1;
+        std::size_t c         = 0;
+        while (c < cap and i + c <= N and key(i + c) - key(i) <= lim) { c++; }
+        if (c > best) { best = c, width = w; }
+    }
+    return best;
+}
+
+/**
+ * 葉の数から中間ノードの段を決める
+ */
+void levels(const std::size_t leaf_num)
+{
+    NL                   = leaf_num;
+    std::size_t nums[16] = {NL};
+    for (H = 1; nums[H - 1] > 1; H++) { nums[H] = (nums[H - 1] + css_tree::Fanout - 1) / css_tree::Fanout; }
+    NB = 0;
+    for (std::size_t h = H; h-- > 1;) {
+        Offsets[h] = NB;
+        NB += nums[h];
+    }
+}
+
+void init()
+{
+    std::vector<std::size_t> starts;  // starts[l]: 葉lの先頭のキーの位置
+    for (std::size_t i = 0; i <= N;) {
+        uint16_t width;
+        starts.push_back(i);
+        i += fill(i, width);
+    }
+    levels(starts.size());
+    starts.push_back(N + 1);
+
+    leaves = allocate<leaf_t>(NL);
+    for (std::size_t l = 0; l < NL; l++) {
+        leaf_t& leaf = leaves[l];
+        leaf         = leaf_t{};
+        leaf.base    = key(starts[l]);
+        leaf.count   = static_cast<uint16_t>(fill(starts[l], leaf.width));
+        for (std::size_t j = 0; j < leaf.count; j++) {
+            const data_t d = key(starts[l] + j) - leaf.base;
+            if (leaf.width == 8) {
+                leaf.d8[j] = static_cast<uint8_t>(d ^ 0x80U);
+            } else if (leaf.width == 16) {
+                leaf.d16[j] = static_cast<uint16_t>(d ^ 0x8000U);
+            } else {
+                leaf.d32[j] = d ^ css_tree::Bias;
+            }
+        }
+    }
+
+    nodes            = allocate<css_tree::node_t>(NB);
+    std::size_t span = 1;  // 段h-1の頂点の部分木に含まれる葉の個数
+    for (std::size_t h = 1; h < H; h++) {
+        const std::size_t sons = (NL + span - 1) / span;  // 段h-1の頂点数
+        for (std::size_t k = 0; k < (sons + css_tree::Fanout - 1) / css_tree::Fanout; k++) {
+            for (std::size_t j = 0; j < css_tree::B; j++) {
+                const std::size_t c           = k * css_tree::Fanout + j;
+                nodes[Offsets[h] + k].keys[j] = (c < sons ? key(starts[std::min((c + 1) * span, NL)] - 1) : Inf) ^ css_tree::Bias;
+            }
+        }
+        span *= css_tree::Fanout;
+    }
+}
+
+void fin()
+{
+    deallocate(leaves, NL);
+    deallocate(nodes, NB);
+}
+
+/**
+ * ファイルへの保存/ファイルからの読み込み (葉の数はファイルから決める)
+ */
+void save(layout_writer& writer)
+{
+    writer.add("compressed_css_tree.leaves", leaves, NL);
+    writer.add("compressed_css_tree.nodes", nodes, NB);
+}
+
+bool load(const layout_reader& reader)
+{
+    std::size_t num;
+    if (reader.get<leaf_t>("compressed_css_tree.leaves", num) == nullptr) { return false; }
+    levels(num);
+    return load_section(reader, "compressed_css_tree.leaves", NL, leaves) and load_section(reader, "compressed_css_tree.nodes", NB, nodes);
+}
+
+/**
+ * 葉の中で差分がd未満のキーの個数
+ * - 64byteを丸ごと2回に分けて比較し、movemaskのうち差分のレーンの部分だけpopcountする (1レーン = width/8ビット)
+ */
+inline std::size_t rank(const leaf_t& leaf, const data_t d)
+{
+    const __m256i lo = _mm256_load_si256(reinterpret_cast<const __m256i*>(leaf.d8));
+    const __m256i hi = _mm256_load_si256(reinterpret_cast<const __m256i*>(leaf.d8 + 32));
+    __m256i lo_lt, hi_lt;
+    if (leaf.width == 8) {
+        const __m256i x = _mm256_set1_epi8(static_cast<char>(std::min<data_t>(d, 0xFFU) ^ 0x80U));
+        lo_lt           = _mm256_cmpgt_epi8(x, lo);
+        hi_lt           = _mm256_cmpgt_epi8(x, hi);
+    } else if (leaf.width == 16) {
+        const __m256i x = _mm256_set1_epi16(static_cast<short>(std::min<data_t>(d, 0xFFFFU) ^ 0x8000U));
+        lo_lt           = _mm256_cmpgt_epi16(x, lo);
+        hi_lt           = _mm256_cmpgt_epi16(x, hi);
+    } else {
+        const __m256i x = _mm256_set1_epi32(static_cast<int>(d ^ css_tree::Bias));
+        lo_lt           = _mm256_cmpgt_epi32(x, lo);
+        hi_lt           = _mm256_cmpgt_epi32(x, hi);
+    }
+    const uint64_t mask      = static_cast<uint32_t>(_mm256_movemask_epi8(lo_lt)) | (uint64_t{static_cast<uint32_t>(_mm256_movemask_epi8(hi_lt))} << 32);
+    const std::size_t lane   = leaf.width / 8;
+    const std::size_t filled = leaf.count * lane;
+    return static_cast<std::size_t>(__builtin_popcountll(mask & ((uint64_t{1} << filled) - 1))) / lane;
+}
+
+/**
+ * クエリ応答
+ * - 中間ノードはcss_treeと同じく降りる
+ * - 葉ではvとbaseの差分を、差分のまま比較する
+ *   (降りてきた葉の最大値はv以上なので、差分はレーンに収まる)
+ */
+inline data_t lower_bound(const data_t v)
+{
+    const __m256i x = _mm256_set1_epi32(static_cast<int>(v ^ css_tree::Bias));
+    std::size_t k   = 0;
+    for (std::size_t h = H - 1; h > 0; h--) {
+        k = k * css_tree::Fanout + css_tree::rank(nodes[Offsets[h] + k], x);
+    }
+    const leaf_t& leaf = leaves[k];
+    if (v <= leaf.base) { return leaf.base; }
+    const std::size_t r = rank(leaf, v - leaf.base);
+    return leaf.base + (leaf.width == 8 ? leaf.d8[r] ^ 0x80U : leaf.width == 16 ? leaf.d16[r] ^ 0x8000U : leaf.d32[r] ^ css_tree::Bias);
+}
+
+}  // namespace compressed_css_tree
+
+namespace rmi {
+
+constexpr std::size_t L = (1 << 18);  // 2段目のモデル数
+
+/**
+ * 線形モデル (pos = slope * x + icpt, 担当するキーの位置は [pos - lo_err, pos + hi_err] に入る)
+ */
+struct model_t
+{
+    double slope;
+    double icpt;
+    uint32_t lo_err;
+    uint32_t hi_err;
+};
+
+/**
+ * メインメモリ上で保持するデータ
+ * - root: 1段目のモデル (キー -> 2段目のモデル番号)
+ * - models: 2段目のモデル (キー -> sorting::xs上の位置)
+ * - データ自体はsorting::xsをそのまま使う
+ */
+model_t* root;
+model_t* models;
+
+inline double predict(const model_t& model, const data_t v)
+{
+    return model.slope * static_cast<double>(v) + model.icpt;
+}
+
+inline std::size_t select(const data_t v)
+{
+    return static_cast<std::size_t>(std::clamp(predict(*root, v), 0.0, static_cast<double>(L - 1)));
+}
+
+/**
+ * 最小二乗法で pos ~ slope * Xs[i] + icpt を求める (傾きは負にしない)
+ */
+model_t fit(const std::size_t first, const std::size_t last, const double scale)
+{
+    model_t model{0.0, 0.0, 0, 0};
+    if (first == last) { return model; }
+    const double n = static_cast<double>(last - first);
+    double mx      = 0.0;
+    double mp      = 0.0;
+    for (std::size_t i = first; i < last; i++) {
+        mx += static_cast<double>(Xs[i]) / n;
+        mp += static_cast<double>(i) * scale / n;
+    }
+    double sxx = 0.0;
+    double sxp = 0.0;
+    for (std::size_t i = first; i < last; i++) {
+        const double dx = static_cast<double>(Xs[i]) - mx;
+        sxx += dx * dx;
+        sxp += dx * (static_cast<double>(i) * scale - mp);
+    }
+    model.slope = sxx > 0.0 ? std::max(sxp / sxx, 0.0) : 0.0;
+    model.icpt  = mp - model.slope * mx;
+    return model;
+}
+
+void init()
+{
+    root   = allocate<model_t>(1);
+    models = allocate<model_t>(L);
+    *root  = fit(0, N, static_cast<double>(L) / static_cast<double>(N));
+    // 1段目の予測は単調なので、各モデルが担当するキーは区間になる
+    for (std::size_t m = 0, first = 0; m < L; m++) {
+        std::size_t last = first;
+        while (last < N and select(Xs[last]) == m) { last++; }
+        model_t model = fit(first, last, 1.0);
+        for (std::size_t i = first; i < last; i++) {
+            const auto p = static_cast<long long>(std::clamp(predict(model, Xs[i]), 0.0, static_cast<double>(N)));
+            const auto a = static_cast<long long>(i);
+            model.lo_err = std::max(model.lo_err, static_cast<uint32_t>(std::max(p - a, 0LL)));
+            model.hi_err = std::max(model.hi_err, static_cast<uint32_t>(std::max(a - p, 0LL)));
+        }
+        models[m] = model;
+        first     = last;
+    }
+}
+
+void fin()
+{
+    deallocate(root, 1);
+    deallocate(models, L);
+}
+
+/**
+ * ファイルへの保存/ファイルからの読み込み
+ */
+void save(layout_writer& writer)
+{
+    writer.add("rmi.root", root, 1);
+    writer.add("rmi.models", models, L);
+}
+
+bool load(const layout_reader& reader)
+{
+    return load_section(reader, "rmi.root", 1, root) and load_section(reader, "rmi.models", L, models);
+}
+
+/**
+ * sorting::xsの[lo, hi)の中でv以上の最初の位置 (なければhi, 分岐なし)
+ */
+inline std::size_t search(std::size_t lo, const std::size_t hi, const data_t v)
+{
+    for (std::size_t len = hi - lo; len > 0;) {
+        const std::size_t half = len / 2;
+        const bool less        = sorting::xs[lo + half] < v;
+        lo                     = less ? lo + half + 1 : lo;
+        len                    = less ? len - half - 1 : half;
+    }
+    return lo;
+}
+
+/**
+ * クエリ応答
+ * - モデルを1つ読み、予測した位置の周り(誤差の範囲)だけ二分探索する
+ * - 範囲の端に来たら答えは外にあるかもしれないので、外側に倍々で広げて探す (キー以外のクエリのみ)
+ */
+inline data_t lower_bound(const data_t v)
+{
+    const model_t& model = models[select(v)];
+    // 遠いクエリの予測はlong longに収まらないことがあるので、実数のまま[0, N]に抑えてから整数にする
+    const auto p         = static_cast<long long>(std::clamp(predict(model, v), 0.0, static_cast<double>(N)));
+    const std::size_t lo = static_cast<std::size_t>(std::clamp(p - static_cast<long long>(model.lo_err), 0LL, static_cast<long long>(N)));
+    const std::size_t hi = static_cast<std::size_t>(std::clamp(p + static_cast<long long>(model.hi_err) + 1, static_cast<long long>(lo), static_cast<long long>(N)));
+    std::size_t i        = search(lo, hi, v);
+    if (i == lo and lo > 0 and sorting::xs[lo - 1] >= v) {
+        std::size_t r = lo - 1, step = 1;  // xs[r] >= v
+        for (; r > 0 and sorting::xs[r - std::min(step, r)] >= v; step *= 2) { r -= std::min(step, r); }
+        i = search(r - std::min(step, r), r, v);
+    } else if (i == hi and hi < N) {
+        std::size_t l = hi, step = 1;  // xs[l - 1] < v
+        for (; l < N and sorting::xs[std::min(l + step, N) - 1] < v; step *= 2) { l = std::min(l + step, N); }
+        i = search(l, std::min(l + step, N), v);
+    }
+    return sorting::xs[i];
+}
+
+}  // namespace rmi
+
+/**
+ * データとレイアウト (N/分布が変わったときだけ作り直す)
+ * - LayoutPathを指定したら <LayoutPath>.<分布>.<N> から読む (無ければ作って保存する)
+ * - キーの型かデータのシード(Seed)が違うファイル、Verifyでチェックサムが合わないファイルは作り直して上書きする
+ */
+std::string LayoutPath;
+bool Verify = true;
+std::string Dist;
+layout_reader Reader;
+bool Loaded = false;
+
+void layouts_fin()
+{
+    if (Loaded) {
+        Reader.close();
+        return;
+    }
+    sorting::fin();
+    blocking::fin();
+    vEB::fin();
+    implicit_vEB::fin();
+    eytzinger::fin();
+    s_tree::fin();
+    css_tree::fin();
+    compressed_css_tree::fin();
+    rmi::fin();
+}
+
+void workload(const bench::params_t& p)
+{
+    if (N != p.n or Dist != p.dist) {
+        if (not Dist.empty()) { layouts_fin(); }
+        size_init(p.n);
+        Dist = p.dist;
+        Xs.clear();
+        Ys.clear();
+        const std::string path = LayoutPath.empty() ? "" : LayoutPath + "." + Dist + "." + std::to_string(N);
+        const unsigned flags   = layout_reader::Populate | (Page == page_alloc::page_t::Huge ? layout_reader::HugePage : 0U) | (Verify ? layout_reader::Verify : 0U);
+        SW.rap();
+        Loaded = not path.empty() and Reader.open(path, layout_file::key_kind_of<data_t>(), flags) and Reader.data_seed() == Seed
+                 and sorting::load(Reader) and blocking::load(Reader) and vEB::load(Reader) and implicit_vEB::load(Reader) and eytzinger::load(Reader) and s_tree::load(Reader)
+                 and css_tree::load(Reader) and compressed_css_tree::load(Reader) and rmi::load(Reader);
+        if (Loaded) {
+            std::cout << "Load: " << SW.rap<std::chrono::microseconds>() << " us (" << Reader.size() << " bytes)" << std::endl;
+        } else {
+            Reader.close();
+            data_init(Dist);
+            sorting::init();
+            blocking::init();
+            vEB::init();
+            implicit_vEB::init();
+            eytzinger::init();
+            s_tree::init();
+            css_tree::init();
+            compressed_css_tree::init();
+            rmi::init();
+            std::cout << "Build: " << SW.rap() << " ms" << std::endl;
+            std::cout << "Page: " << (Backing == page_alloc::backing_t::Small ? "4K" : Backing == page_alloc::backing_t::HugeTLB ? "2M (HugeTLB)" : "2M (THP)") << std::endl;
+            if (not path.empty()) {
+                layout_writer writer{layout_file::key_kind_of<data_t>(), Seed};
+                sorting::save(writer);
+                blocking::save(writer);
+                vEB::save(writer);
+                implicit_vEB::save(writer);
+                eytzinger::save(writer);
+                s_tree::save(writer);
+                css_tree::save(writer);
+                compressed_css_tree::save(writer);
+                rmi::save(writer);
+                const bool ok = writer.write(path);
+                std::cout << "Save: " << SW.rap() << " ms" << (ok ? "" : " (failed)") << std::endl;
+            }
+        }
+    }
+    if (Ys.size() != p.q) { query_init(Dist, p.q, sorting::xs[N - 1]); }
+}
+
+/**
+ * 1回分の計測
+ * - run(first, last): Ys[first, last)を流して答えの和を返す
+ * - Ysをスレッド数で等分し、スレッドtはコアt (mod コア数) に固定する (1スレッドなら呼び出したスレッドで流す)
+ * - レイアウトは全スレッドで共有する (読み込みのみ)
+ * - 指標: スレッドごとの1クエリあたりの時間の平均, 全体のスループット,
+ *         スレッドkの1クエリあたりの時間 ns_per_query_t<k> (2スレッド以上のときだけ, 遅いコアやNUMAの偏りを見る),
+ *         dTLBミス (1スレッドでperf_event_openが使えるときだけ), レイアウトのバイト数, 答えの和 (デバッグ用)
+ */
+template<typename Run>
+bench::metrics_t measure(const bench::params_t& p, const std::size_t bytes, Run run)
+{
+    const std::size_t cpus = std::max(std::thread::hardware_concurrency(), 1U);
+    std::vector<long long> durs(p.threads);
+    std::vector<data_t> sums(p.threads);
+    uint64_t dtlb = 0;
     SW.rap();
-    for (std::size_t q = 0; q < Q; q++) {
-        sum += lower_bound(Ys[q]);
+    if (p.threads == 1) {
+        DTLB.start();
+        sums[0] = run(0, Q);
+        dtlb    = DTLB.stop();
+        durs[0] = SW.rap<std::chrono::nanoseconds>();
+    } else {
+        std::vector<std::thread> ths;
+        for (std::size_t t = 0; t < p.threads; t++) {
+            ths.emplace_back([&, t] {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(t % cpus, &set);
+                pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+                stopwatch sw;
+                sums[t] = run(Q * t / p.threads, Q * (t + 1) / p.threads);
+                durs[t] = sw.rap<std::chrono::nanoseconds>();
+            });
+        }
+        for (auto& th : ths) { th.join(); }
+    }
+    const auto dur_ns = p.threads == 1 ? durs[0] : SW.rap<std::chrono::nanoseconds>();
+    std::vector<double> per_queries(p.threads);
+    double per_query = 0.0;
+    data_t sum       = 0;
+    for (std::size_t t = 0; t < p.threads; t++) {
+        const std::size_t num = Q * (t + 1) / p.threads - Q * t / p.threads;
+        per_queries[t]        = static_cast<double>(durs[t]) / static_cast<double>(std::max<std::size_t>(num, 1));
+        per_query += per_queries[t] / static_cast<double>(p.threads);
+        sum += sums[t];
+    }
+    bench::metrics_t ms{{"ns_per_query", per_query}, {"queries_per_s", static_cast<double>(Q) * 1e9 / static_cast<double>(std::max(dur_ns, 1LL))}};
+    if (p.threads > 1) {
+        for (std::size_t t = 0; t < p.threads; t++) { ms.emplace_back("ns_per_query_t" + std::to_string(t), per_queries[t]); }
     }
-    const auto dur_ms = SW.rap<std::chrono::nanoseconds>();
-    std::cout << "Query Total: " << dur_ms << " ns" << std::endl;
-    std::cout << "Sum(for Debug): " << sum << std::endl;
-    std::cout << std::endl;
+    if (p.threads == 1 and DTLB.available()) { ms.emplace_back("dtlb_miss_per_query", static_cast<double>(dtlb) / static_cast<double>(Q)); }
+    ms.emplace_back("bytes", static_cast<double>(bytes));
+    ms.emplace_back("sum", static_cast<double>(sum));
+    return ms;
 }
 
-}  // namespace vEB
+/**
+ * 1つずつ答えるクエリ / G個ずつまとめて答えるクエリ
+ */
+template<typename LowerBound>
+bench::trial_t queries(const bench::params_t& p, const std::size_t bytes, LowerBound lower_bound)
+{
+    return [p, bytes, lower_bound] {
+        return measure(p, bytes, [&](const std::size_t first, const std::size_t last) {
+            data_t sum = 0;
+            for (std::size_t q = first; q < last; q++) {
+                sum += lower_bound(Ys[q]);
+            }
+            return sum;
+        });
+    };
+}
+
+/**
+ * - 答えはBatchChunk個ずつスタック上のバッファに書いて足す (Q個分の配列を計測中に確保しない)
+ * - BatchChunkはGの倍数なので、最後以外の区切りでグループが途切れることはない
+ */
+constexpr std::size_t BatchChunk = 1024;
+
+template<typename LowerBoundBatch>
+bench::trial_t batch_queries(const bench::params_t& p, const std::size_t bytes, LowerBoundBatch lower_bound_batch)
+{
+    return [p, bytes, lower_bound_batch] {
+        return measure(p, bytes, [&](const std::size_t first, const std::size_t last) {
+            data_t out[BatchChunk];
+            data_t sum = 0;
+            for (std::size_t q0 = first; q0 < last; q0 += BatchChunk) {
+                const std::size_t num = std::min(BatchChunk, last - q0);
+                lower_bound_batch(Ys.data() + q0, out, num);
+                for (std::size_t i = 0; i < num; i++) { sum += out[i]; }
+            }
+            return sum;
+        });
+    };
+}
+
+constexpr std::size_t BlockingBytes = sizeof(data_t) + 2 * sizeof(std::size_t);  // ブロッキング/vEBの1頂点あたりのバイト数
+
+std::string blocking_name(const std::size_t block_height)
+{
+    return "[Sol2] Blocking (Block Height: " + std::to_string(block_height) + (blocking::Shape == layout::shape_t::Padded ? ", Padded)" : ")");
+}
 
-int main()
+void add_blocking(bench::registry& reg)
 {
-    data_init();
+    for (const std::size_t block_height : blocking::Heights) {
+        reg.add(blocking_name(block_height), [block_height](const bench::params_t& p) {
+            workload(p);
+            blocking::use(block_height);
+            return queries(p, (blocking::Nodes + 1) * BlockingBytes, [](const data_t v) { return blocking::lower_bound(v); });
+        });
+    }
+}
+
+template<std::size_t G>
+void add_batch(bench::registry& reg)
+{
+    static_assert(BatchChunk % G == 0, "batch size must divide BatchChunk");
+    const std::string batch = " (Batch: " + std::to_string(G) + ")";
+    reg.add("[Sol1] Sorting" + batch, [](const bench::params_t& p) {
+        workload(p);
+        return batch_queries(p, (N + 1) * sizeof(data_t), sorting::lower_bound_batch<G>);
+    });
+    for (const std::size_t block_height : blocking::Heights) {
+        reg.add(blocking_name(block_height) + batch, [block_height](const bench::params_t& p) {
+            workload(p);
+            blocking::use(block_height);
+            return batch_queries(p, (blocking::Nodes + 1) * BlockingBytes, blocking::lower_bound_batch<G>);
+        });
+    }
+    reg.add("[Sol3] vEB Layout" + batch, [](const bench::params_t& p) {
+        workload(p);
+        return batch_queries(p, (N + 1) * BlockingBytes, vEB::lower_bound_batch<G>);
+    });
+}
 
-    sorting::init();
-    blocking::init<3>();
-    blocking::init<4>();
-    blocking::init<5>();
-    blocking::init<6>();
-    blocking::init<7>();
-    vEB::init();
+/**
+ * 使い方: static_search_bench [bench.hppの引数] [--heights=3,4,5,6,7] [--shape=complete|padded] [--layout=パス] [--verify=1|0] [--page=4k|2m]
+ * - heights: ブロッキングの高さ (バッチ版も同じ高さを全部測る)
+ * - shape: ブロッキングの木の形 (既定は左詰めの完全二分木、paddedなら高さHの完全二分木をInfで埋める)
+ *   両方を比べるときはページと同じく、同じ引数でshapeだけ変えて2回実行する
+ * - layout: レイアウトを <パス>.<分布>.<N> から読む (無ければ作って保存する)
+ * - verify: 読むときにチェックサムを確認する (既定は1、0なら確認しないのでLoadの時間はmmapとPopulateだけになる)
+ * - page: 2mならレイアウトを2Mページに置く (既定は4Kページ)
+ *   ファイルから読んだ場合はMADV_HUGEPAGEを指定するだけ (ファイルのmapが2Mページになるかはカーネル次第)
+ * - 4Kページと2Mページの比較は同じ引数でページだけ変えて2回実行する
+ * - スレッド数の既定は1とコア数
+ */
+int main(int argc, char* argv[])
+{
+    bench::options_t opts;
+    opts.ns      = {(1 << 24) + 64};
+    opts.qs      = {1 << 24};
+    opts.warmup  = 1;
+    opts.trials  = 3;
+    opts.threads = {1};
+    if (std::thread::hardware_concurrency() > 1) { opts.threads.push_back(std::thread::hardware_concurrency()); }
+    std::string err;
+    if (not bench::parse(argc, argv, opts, {"heights", "shape", "layout", "verify", "page"}, err)) {
+        std::cerr << err << std::endl;
+        return 1;
+    }
+    if (std::count(opts.ns.begin(), opts.ns.end(), 0) != 0) {  // RMIやS-treeなどは1個以上のキーを前提にしている
+        std::cerr << "invalid value: --n=0 (N must be positive)" << std::endl;
+        return 1;
+    }
+    if (opts.extra.count("heights")
+        and (not bench::parse_sizes(opts.extra["heights"], blocking::Heights)
+             or std::any_of(blocking::Heights.begin(), blocking::Heights.end(), [](const std::size_t h) { return h < 1 or h > blocking::MaxHeight; }))) {
+        std::cerr << "invalid value: --heights=" << opts.extra["heights"] << " (1 <= height <= " << blocking::MaxHeight << ")" << std::endl;
+        return 1;
+    }
+    if (opts.extra.count("shape") and opts.extra["shape"] != "complete" and opts.extra["shape"] != "padded") {
+        std::cerr << "invalid value: --shape=" << opts.extra["shape"] << " (complete or padded)" << std::endl;
+        return 1;
+    }
+    blocking::Shape = opts.extra["shape"] == "padded" ? layout::shape_t::Padded : layout::shape_t::Complete;
+    std::sort(blocking::Heights.begin(), blocking::Heights.end());
+    blocking::Heights.erase(std::unique(blocking::Heights.begin(), blocking::Heights.end()), blocking::Heights.end());
+    LayoutPath = opts.extra["layout"];
+    Verify     = opts.extra["verify"] != "0";
+    Page       = opts.extra["page"] == "2m" ? page_alloc::page_t::Huge : page_alloc::page_t::Small;
 
-    sorting::test();
-    blocking::test<3>();
-    blocking::test<4>();
-    blocking::test<5>();
-    blocking::test<6>();
-    blocking::test<7>();
-    vEB::test();
+    bench::registry reg;
+    reg.add("[Sol1] Sorting", [](const bench::params_t& p) {
+        workload(p);
+        return queries(p, (N + 1) * sizeof(data_t), [](const data_t v) { return sorting::lower_bound(v); });
+    });
+    add_blocking(reg);
+    reg.add("[Sol3] vEB Layout", [](const bench::params_t& p) {
+        workload(p);
+        return queries(p, (N + 1) * BlockingBytes, [](const data_t v) { return vEB::lower_bound(v); });
+    });
+    reg.add("[Sol4] Implicit vEB Layout", [](const bench::params_t& p) {
+        workload(p);
+        return queries(p, TN * sizeof(data_t), [](const data_t v) { return implicit_vEB::lower_bound(v); });
+    });
+    reg.add("[Sol5] Eytzinger Layout", [](const bench::params_t& p) {
+        workload(p);
+        return queries(p, (N + 1) * sizeof(data_t), [](const data_t v) { return eytzinger::lower_bound(v); });
+    });
+    reg.add("[Sol6] S-tree", [](const bench::params_t& p) {
+        workload(p);
+        return queries(p, s_tree::NB * sizeof(s_tree::node_t), [](const data_t v) { return s_tree::lower_bound(v); });
+    });
+    reg.add("[Sol9] CSS-tree", [](const bench::params_t& p) {
+        workload(p);
+        return queries(p, css_tree::NB * sizeof(css_tree::node_t), [](const data_t v) { return css_tree::lower_bound(v); });
+    });
+    reg.add("[Sol10] Compressed CSS-tree", [](const bench::params_t& p) {
+        workload(p);
+        return queries(p, (compressed_css_tree::NL + compressed_css_tree::NB) * 64, [](const data_t v) { return compressed_css_tree::lower_bound(v); });
+    });
+    reg.add("[Sol11] RMI", [](const bench::params_t& p) {
+        workload(p);
+        return queries(p, (rmi::L + 1) * sizeof(rmi::model_t), [](const data_t v) { return rmi::lower_bound(v); });  // (+ Sorting)
+    });
+    add_batch<8>(reg);
+    add_batch<16>(reg);
+    add_batch<32>(reg);
 
-    return 0;
+    return reg.run(opts);
 }
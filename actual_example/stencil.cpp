@@ -0,0 +1,307 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "common/rng.hpp"
+#include "common/stopwatch.hpp"
+
+constexpr uint64_t Seed = 20201013;
+rng_base Rng{Seed};
+stopwatch SW;
+
+/**
+ * 台形分割の打ち切り
+ * - XBase: これ以下の幅なら空間方向に切らない
+ * - TBase: これ以下の高さなら時間方向に切らない
+ * - PBase: これ以上の幅なら並列に切る
+ */
+constexpr long long XBase = 256;
+constexpr long long TBase = 8;
+constexpr long long PBase = 1 << 14;
+
+/**
+ * 簡易Fork-Join
+ * - 空きスレッドがあればfを別スレッドで実行し、gと並行に走らせる
+ * - なければその場でf,gの順に実行する
+ */
+std::atomic<int> g_idle{0};
+
+template<typename F, typename G>
+void fork_join(F f, G g)
+{
+    int idle = g_idle.load();
+    while (idle > 0 and not g_idle.compare_exchange_weak(idle, idle - 1)) {}
+    if (idle > 0) {
+        std::thread th{f};
+        g();
+        th.join();
+        g_idle++;
+    } else {
+        f(), g();
+    }
+}
+
+namespace one_dim {
+
+/**
+ * 1次元3点ステンシル (熱方程式)
+ * - us[t&1]: 時刻tの値
+ */
+constexpr std::size_t N = (1 << 22);
+constexpr std::size_t T = (1 << 9);
+double* Init;
+double* us[2];
+
+inline double kernel(const double l, const double c, const double r)
+{
+    return c + 0.25 * (l - 2 * c + r);
+}
+
+inline void update(const long long t, const long long xa, const long long xb)
+{
+    const double* src = us[t & 1];
+    double* dst       = us[(t + 1) & 1];
+    if (xa == 0) { dst[0] = src[0]; }
+    if (xb == static_cast<long long>(N)) { dst[N - 1] = src[N - 1]; }
+    for (long long x = std::max(xa, 1LL); x < std::min(xb, static_cast<long long>(N) - 1); x++) {
+        dst[x] = kernel(src[x - 1], src[x], src[x + 1]);
+    }
+}
+
+void reset()
+{
+    std::copy(Init, Init + N, us[0]);
+    std::copy(Init, Init + N, us[1]);
+}
+
+void naive()
+{
+    for (std::size_t t = 0; t < T; t++) { update(static_cast<long long>(t), 0, N); }
+}
+
+/**
+ * 時刻[t0,t1), 時刻t0で[x0,x1)・辺の傾きdx0,dx1の台形
+ */
+void walk(const long long t0, const long long t1, const long long x0, const long long dx0, const long long x1, const long long dx1)
+{
+    const long long dt = t1 - t0;
+    if (x1 - x0 > XBase and 2 * (x1 - x0) + (dx1 - dx0) * dt >= 4 * dt) {
+        const long long xm = (2 * (x0 + x1) + (2 + dx0 + dx1) * dt) / 4;
+        walk(t0, t1, x0, dx0, xm, -1);
+        walk(t0, t1, xm, -1, x1, dx1);
+    } else if (dt > TBase) {
+        const long long s = dt / 2;
+        walk(t0, t0 + s, x0, dx0, x1, dx1);
+        walk(t0 + s, t1, x0 + dx0 * s, dx0, x1 + dx1 * s, dx1);
+    } else {
+        for (long long t = t0; t < t1; t++) { update(t, x0 + dx0 * (t - t0), x1 + dx1 * (t - t0)); }
+    }
+}
+
+/**
+ * 並列版
+ * - 上辺が狭い台形: 左右の正台形を並列に -> 真ん中の逆三角形
+ * - 上辺が広い台形: 真ん中の正三角形 -> 左右の台形を並列に
+ */
+void pwalk(const long long t0, const long long t1, const long long x0, const long long dx0, const long long x1, const long long dx1)
+{
+    const long long dt    = t1 - t0;
+    const long long w_bot = x1 - x0, w_top = w_bot + (dx1 - dx0) * dt;
+    if (w_bot >= PBase and std::min(w_bot, w_top) >= 2 * dt) {
+        if (dx1 - dx0 <= 0) {
+            const long long xm = (x0 + x1 + (dx0 + dx1) * dt) / 2;
+            fork_join([=] { pwalk(t0, t1, x0, dx0, xm, -1); }, [=] { pwalk(t0, t1, xm, 1, x1, dx1); });
+            walk(t0, t1, xm, -1, xm, 1);
+        } else {
+            const long long xm = (x0 + x1) / 2;
+            walk(t0, t1, xm - dt, 1, xm + dt, -1);
+            fork_join([=] { pwalk(t0, t1, x0, dx0, xm - dt, 1); }, [=] { pwalk(t0, t1, xm + dt, -1, x1, dx1); });
+        }
+    } else if (w_bot >= PBase and dt > TBase) {
+        const long long s = dt / 2;
+        pwalk(t0, t0 + s, x0, dx0, x1, dx1);
+        pwalk(t0 + s, t1, x0 + dx0 * s, dx0, x1 + dx1 * s, dx1);
+    } else {
+        walk(t0, t1, x0, dx0, x1, dx1);
+    }
+}
+
+void trapezoid()
+{
+    walk(0, T, 0, 0, N, 0);
+}
+
+void parallel_trapezoid()
+{
+    pwalk(0, T, 0, 0, N, 0);
+}
+
+}  // namespace one_dim
+
+namespace two_dim {
+
+/**
+ * 2次元5点ステンシル (熱方程式)
+ * - us[t&1]: 時刻tの値 (行優先, x行y列)
+ */
+constexpr std::size_t X = (1 << 12);
+constexpr std::size_t Y = (1 << 12);
+constexpr std::size_t T = (1 << 6);
+double* Init;
+double* us[2];
+
+inline double kernel(const double c, const double n, const double s, const double w, const double e)
+{
+    return c + 0.125 * (n + s + w + e - 4 * c);
+}
+
+inline void update(const long long t, const long long xa, const long long xb, const long long ya, const long long yb)
+{
+    const double* src = us[t & 1];
+    double* dst       = us[(t + 1) & 1];
+    for (long long x = xa; x < xb; x++) {
+        const std::size_t row = static_cast<std::size_t>(x) * Y;
+        if (x == 0 or x + 1 == static_cast<long long>(X)) {
+            std::copy(src + row + ya, src + row + yb, dst + row + ya);
+            continue;
+        }
+        if (ya == 0) { dst[row] = src[row]; }
+        if (yb == static_cast<long long>(Y)) { dst[row + Y - 1] = src[row + Y - 1]; }
+        for (long long y = std::max(ya, 1LL); y < std::min(yb, static_cast<long long>(Y) - 1); y++) {
+            const std::size_t i = row + static_cast<std::size_t>(y);
+            dst[i]              = kernel(src[i], src[i - Y], src[i + Y], src[i - 1], src[i + 1]);
+        }
+    }
+}
+
+void reset()
+{
+    std::copy(Init, Init + X * Y, us[0]);
+    std::copy(Init, Init + X * Y, us[1]);
+}
+
+void naive()
+{
+    for (std::size_t t = 0; t < T; t++) { update(static_cast<long long>(t), 0, X, 0, Y); }
+}
+
+void walk(const long long t0, const long long t1,
+          const long long x0, const long long dx0, const long long x1, const long long dx1,
+          const long long y0, const long long dy0, const long long y1, const long long dy1)
+{
+    const long long dt = t1 - t0;
+    if (x1 - x0 > XBase / 16 and 2 * (x1 - x0) + (dx1 - dx0) * dt >= 4 * dt) {
+        const long long xm = (2 * (x0 + x1) + (2 + dx0 + dx1) * dt) / 4;
+        walk(t0, t1, x0, dx0, xm, -1, y0, dy0, y1, dy1);
+        walk(t0, t1, xm, -1, x1, dx1, y0, dy0, y1, dy1);
+    } else if (y1 - y0 > XBase and 2 * (y1 - y0) + (dy1 - dy0) * dt >= 4 * dt) {
+        const long long ym = (2 * (y0 + y1) + (2 + dy0 + dy1) * dt) / 4;
+        walk(t0, t1, x0, dx0, x1, dx1, y0, dy0, ym, -1);
+        walk(t0, t1, x0, dx0, x1, dx1, ym, -1, y1, dy1);
+    } else if (dt > TBase) {
+        const long long s = dt / 2;
+        walk(t0, t0 + s, x0, dx0, x1, dx1, y0, dy0, y1, dy1);
+        walk(t0 + s, t1, x0 + dx0 * s, dx0, x1 + dx1 * s, dx1, y0 + dy0 * s, dy0, y1 + dy1 * s, dy1);
+    } else {
+        for (long long t = t0; t < t1; t++) {
+            const long long d = t - t0;
+            update(t, x0 + dx0 * d, x1 + dx1 * d, y0 + dy0 * d, y1 + dy1 * d);
+        }
+    }
+}
+
+/**
+ * 並列版 (x方向にだけ並列に切る, 切り方は1次元と同じ)
+ */
+void pwalk(const long long t0, const long long t1,
+           const long long x0, const long long dx0, const long long x1, const long long dx1,
+           const long long y0, const long long dy0, const long long y1, const long long dy1)
+{
+    const long long dt    = t1 - t0;
+    const long long w_bot = x1 - x0, w_top = w_bot + (dx1 - dx0) * dt;
+    if (w_bot * (y1 - y0) >= PBase and std::min(w_bot, w_top) >= 2 * dt) {
+        if (dx1 - dx0 <= 0) {
+            const long long xm = (x0 + x1 + (dx0 + dx1) * dt) / 2;
+            fork_join([=] { pwalk(t0, t1, x0, dx0, xm, -1, y0, dy0, y1, dy1); }, [=] { pwalk(t0, t1, xm, 1, x1, dx1, y0, dy0, y1, dy1); });
+            walk(t0, t1, xm, -1, xm, 1, y0, dy0, y1, dy1);
+        } else {
+            const long long xm = (x0 + x1) / 2;
+            walk(t0, t1, xm - dt, 1, xm + dt, -1, y0, dy0, y1, dy1);
+            fork_join([=] { pwalk(t0, t1, x0, dx0, xm - dt, 1, y0, dy0, y1, dy1); }, [=] { pwalk(t0, t1, xm + dt, -1, x1, dx1, y0, dy0, y1, dy1); });
+        }
+    } else if (w_bot * (y1 - y0) >= PBase and dt > TBase) {
+        const long long s = dt / 2;
+        pwalk(t0, t0 + s, x0, dx0, x1, dx1, y0, dy0, y1, dy1);
+        pwalk(t0 + s, t1, x0 + dx0 * s, dx0, x1 + dx1 * s, dx1, y0 + dy0 * s, dy0, y1 + dy1 * s, dy1);
+    } else {
+        walk(t0, t1, x0, dx0, x1, dx1, y0, dy0, y1, dy1);
+    }
+}
+
+void trapezoid()
+{
+    walk(0, T, 0, 0, X, 0, 0, 0, Y, 0);
+}
+
+void parallel_trapezoid()
+{
+    pwalk(0, T, 0, 0, X, 0, 0, 0, Y, 0);
+}
+
+}  // namespace two_dim
+
+/**
+ * 実行して時間と結果のチェックサムを出力
+ */
+template<typename Reset, typename Run>
+void test(const char* title, Reset reset, Run run, const double* result, const std::size_t size)
+{
+    std::cout << title << std::endl;
+    reset();
+    SW.rap();
+    run();
+    const auto dur = SW.rap<std::chrono::nanoseconds>();
+    double sum     = 0;
+    for (std::size_t i = 0; i < size; i++) { sum += result[i]; }
+    std::cout << "Total: " << dur << " ns" << std::endl;
+    std::cout << "Sum(for Debug): " << std::setprecision(17) << sum << std::endl;
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    const int threads = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(std::thread::hardware_concurrency());
+    g_idle            = std::max(threads, 1) - 1;
+    std::cout << "Threads: " << std::max(threads, 1) << std::endl
+              << std::endl;
+
+    one_dim::Init = new double[one_dim::N];
+    for (std::size_t i = 0; i < one_dim::N; i++) { one_dim::Init[i] = static_cast<double>(Rng.val<int>(0, 1000)); }
+    one_dim::us[0]     = new double[one_dim::N];
+    one_dim::us[1]     = new double[one_dim::N];
+    const double* res1 = one_dim::us[one_dim::T & 1];
+    test("[1D Sol1] Naive", one_dim::reset, one_dim::naive, res1, one_dim::N);
+    test("[1D Sol2] Trapezoid", one_dim::reset, one_dim::trapezoid, res1, one_dim::N);
+    test("[1D Sol3] Parallel Trapezoid", one_dim::reset, one_dim::parallel_trapezoid, res1, one_dim::N);
+    delete[] one_dim::Init;
+    delete[] one_dim::us[0];
+    delete[] one_dim::us[1];
+
+    two_dim::Init = new double[two_dim::X * two_dim::Y];
+    for (std::size_t i = 0; i < two_dim::X * two_dim::Y; i++) { two_dim::Init[i] = static_cast<double>(Rng.val<int>(0, 1000)); }
+    two_dim::us[0]     = new double[two_dim::X * two_dim::Y];
+    two_dim::us[1]     = new double[two_dim::X * two_dim::Y];
+    const double* res2 = two_dim::us[two_dim::T & 1];
+    test("[2D Sol1] Naive", two_dim::reset, two_dim::naive, res2, two_dim::X * two_dim::Y);
+    test("[2D Sol2] Trapezoid", two_dim::reset, two_dim::trapezoid, res2, two_dim::X * two_dim::Y);
+    test("[2D Sol3] Parallel Trapezoid", two_dim::reset, two_dim::parallel_trapezoid, res2, two_dim::X * two_dim::Y);
+    delete[] two_dim::Init;
+    delete[] two_dim::us[0];
+    delete[] two_dim::us[1];
+
+    return 0;
+}
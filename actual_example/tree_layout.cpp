@@ -0,0 +1,74 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "common/bit.hpp"
+#include "common/stopwatch.hpp"
+#include "common/tree_layout.hpp"
+#include "common/tree_layout_reference.hpp"
+
+stopwatch SW;
+
+/**
+ * 作る木の高さ (頂点数は2^H-1)
+ */
+constexpr std::size_t MinH      = 17;
+constexpr std::size_t MaxH      = 25;
+constexpr std::size_t BlockH    = 7;
+constexpr std::size_t NoThreads = 1;
+
+/**
+ * 並びを作る時間を測る
+ * - checksum: 結果確認用 (位置で重み付けした和)
+ */
+template<typename Build>
+void test(const char* name, const std::size_t H, Build build)
+{
+    SW.rap();
+    const std::vector<std::size_t> orders = build();
+    const auto dur_us                     = SW.rap<std::chrono::microseconds>();
+    std::size_t checksum                  = 0;
+    for (std::size_t i = 0; i < orders.size(); i++) { checksum += (i + 1) * orders[i]; }
+    std::cout << name << " (N: 2^" << H << "-1)" << std::endl;
+    std::cout << "Build: " << dur_us << " us" << std::endl;
+    std::cout << "Checksum(for Debug): " << checksum << std::endl;
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    const std::size_t threads = argc > 1 ? static_cast<std::size_t>(std::max(std::atoi(argv[1]), 1)) : std::max(std::thread::hardware_concurrency(), 1U);
+    std::cout << "Threads: " << threads << std::endl
+              << std::endl;
+
+    for (std::size_t H = MinH; H <= MaxH; H += 2) {
+        const std::size_t root = 1UL << (H - 1);
+        const std::size_t size = (1UL << H) - 1;
+        test("[vEB Sol1] Copying", H, [&] { return layout_reference::vEB_orders(root); });
+        test("[vEB Sol2] In-place", H, [&] {
+            std::vector<std::size_t> orders(size);
+            layout::vEB_orders(root, orders.data(), NoThreads);
+            return orders;
+        });
+        test("[vEB Sol3] In-place Parallel", H, [&] {
+            std::vector<std::size_t> orders(size);
+            layout::vEB_orders(root, orders.data(), threads);
+            return orders;
+        });
+        test("[Block Sol1] Copying", H, [&] { return layout_reference::block_orders(root, BlockH); });
+        test("[Block Sol2] In-place", H, [&] {
+            std::vector<std::size_t> orders(size);
+            layout::block_orders(root, BlockH, orders.data(), NoThreads);
+            return orders;
+        });
+        test("[Block Sol3] In-place Parallel", H, [&] {
+            std::vector<std::size_t> orders(size);
+            layout::block_orders(root, BlockH, orders.data(), threads);
+            return orders;
+        });
+    }
+
+    return 0;
+}
@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "bench.hpp"
+
+namespace {
+
+const std::vector<std::string> Dists{"uniform", "skewed", "dense"};
+
+std::vector<std::string> split(const std::string& s)
+{
+    std::vector<std::string> ts;
+    std::string t;
+    std::istringstream is{s};
+    while (std::getline(is, t, ',')) { ts.push_back(t); }
+    return ts;
+}
+
+/**
+ * CSVの1欄 (カンマや引用符を含むなら引用符で囲む)
+ */
+std::string csv_field(const std::string& s)
+{
+    if (s.find_first_of(",\"\n") == std::string::npos) { return s; }
+    std::string t = "\"";
+    for (const char c : s) { t += (c == '"' ? std::string{"\"\""} : std::string{c}); }
+    return t + "\"";
+}
+
+std::string json_string(const std::string& s)
+{
+    std::string t = "\"";
+    for (const char c : s) {
+        if (c == '"' or c == '\\') {
+            t += '\\';
+            t += c;
+        } else if (c == '\n') {
+            t += "\\n";
+        } else {
+            t += c;
+        }
+    }
+    return t + "\"";
+}
+
+/**
+ * 数値の出力 (有限でなければJSONに書けないのでnull)
+ */
+std::string number(const double x)
+{
+    if (not std::isfinite(x)) { return "null"; }
+    std::ostringstream os;
+    os.precision(12);
+    os << x;
+    return os.str();
+}
+
+std::string describe(const bench::params_t& p)
+{
+    std::ostringstream os;
+    os << "N: " << p.n << ", Q: " << p.q;
+    if (p.b != 0) { os << ", B: " << p.b; }
+    if (p.m != 0) { os << ", M: " << p.m; }
+    os << ", Dist: " << p.dist << ", Threads: " << p.threads;
+    return os.str();
+}
+
+}  // anonymous namespace
+
+namespace bench {
+
+bool parse_size(const std::string& s, std::size_t& x)
+{
+    std::size_t pos = 0;
+    try {
+        if (s.size() >= 2 and s[0] == '2' and s[1] == '^') {
+            const unsigned long k = std::stoul(s.substr(2), &pos);
+            if (k >= 64) { return false; }
+            pos += 2;
+            x = std::size_t{1} << k;
+            if (pos < s.size()) {
+                if (s[pos] != '+' and s[pos] != '-') { return false; }
+                std::size_t len;
+                const unsigned long long c = std::stoull(s.substr(pos + 1), &len);
+                if (s[pos] == '-' and c > x) { return false; }
+                x   = s[pos] == '+' ? x + c : x - c;
+                pos = pos + 1 + len;
+            }
+        } else {
+            if (s.empty() or s[0] == '-') { return false; }
+            x = std::stoull(s, &pos);
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    return pos == s.size();
+}
+
+bool parse_sizes(const std::string& s, std::vector<std::size_t>& xs)
+{
+    std::vector<std::size_t> ys;
+    for (const auto& t : split(s)) {
+        std::size_t y;
+        if (not parse_size(t, y)) { return false; }
+        ys.push_back(y);
+    }
+    if (ys.empty()) { return false; }
+    xs = ys;
+    return true;
+}
+
+bool parse(int argc, char* argv[], options_t& opts, const std::vector<std::string>& extra_keys, std::string& err)
+{
+    for (int i = 1; i < argc; i++) {
+        const std::string arg{argv[i]};
+        const auto eq = arg.find('=');
+        if (arg.rfind("--", 0) != 0 or eq == std::string::npos) {
+            err = "invalid argument: " + arg;
+            return false;
+        }
+        const std::string key = arg.substr(2, eq - 2);
+        const std::string val = arg.substr(eq + 1);
+        bool ok               = true;
+        if (key == "n") {
+            ok = parse_sizes(val, opts.ns);
+        } else if (key == "q") {
+            ok = parse_sizes(val, opts.qs);
+        } else if (key == "b") {
+            ok = parse_sizes(val, opts.bs);
+        } else if (key == "m") {
+            ok = parse_sizes(val, opts.ms);
+        } else if (key == "threads") {
+            ok = parse_sizes(val, opts.threads) and std::count(opts.threads.begin(), opts.threads.end(), 0) == 0;
+        } else if (key == "dist") {
+            opts.dists = split(val);
+            ok         = not opts.dists.empty() and std::all_of(opts.dists.begin(), opts.dists.end(), [](const std::string& d) { return std::find(Dists.begin(), Dists.end(), d) != Dists.end(); });
+        } else if (key == "warmup") {
+            ok = parse_size(val, opts.warmup);
+        } else if (key == "trials") {
+            ok = parse_size(val, opts.trials) and opts.trials > 0;
+        } else if (key == "csv") {
+            opts.csv = val;
+        } else if (key == "json") {
+            opts.json = val;
+        } else if (key == "filter") {
+            opts.filter = val;
+        } else if (key == "tag") {
+            opts.tag = val;
+        } else if (std::find(extra_keys.begin(), extra_keys.end(), key) != extra_keys.end()) {
+            opts.extra[key] = val;
+        } else {
+            err = "unknown option: " + arg;
+            return false;
+        }
+        if (not ok) {
+            err = "invalid value: " + arg;
+            return false;
+        }
+    }
+    return true;
+}
+
+stat_t summarize(std::vector<double> xs)
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    if (xs.empty()) { return stat_t{nan, nan, nan, nan, nan}; }
+    std::sort(xs.begin(), xs.end());
+    const std::size_t n = xs.size();
+    stat_t s;
+    s.median = n % 2 == 1 ? xs[n / 2] : (xs[n / 2 - 1] + xs[n / 2]) / 2.0;
+    s.mean   = 0.0;
+    for (const double x : xs) { s.mean += x / static_cast<double>(n); }
+    double var = 0.0;
+    for (const double x : xs) { var += (x - s.mean) * (x - s.mean); }
+    s.stddev = n > 1 ? std::sqrt(var / static_cast<double>(n - 1)) : 0.0;
+    s.min    = xs.front();
+    s.max    = xs.back();
+    return s;
+}
+
+std::vector<std::pair<std::string, stat_t>> result_t::stats() const
+{
+    std::vector<std::pair<std::string, stat_t>> ss;
+    if (trials.empty()) { return ss; }
+    for (const auto& [key, val] : trials.front()) {
+        std::vector<double> xs;
+        for (const auto& trial : trials) {
+            const auto it = std::find_if(trial.begin(), trial.end(), [&](const auto& kv) { return kv.first == key; });
+            if (it != trial.end()) { xs.push_back(it->second); }
+        }
+        ss.emplace_back(key, summarize(xs));
+    }
+    return ss;
+}
+
+bool write_csv(const std::string& path, const std::string& tag, const std::vector<result_t>& results)
+{
+    std::ofstream os{path};
+    if (not os) { return false; }
+    os << "tag,name,n,q,b,m,dist,threads,metric,trials,median,mean,stddev,min,max\n";
+    for (const auto& r : results) {
+        const auto& p = r.params;
+        for (const auto& [key, s] : r.stats()) {
+            os << csv_field(tag) << ',' << csv_field(r.name) << ',' << p.n << ',' << p.q << ',' << p.b << ',' << p.m << ',' << csv_field(p.dist) << ',' << p.threads << ',' << csv_field(key) << ',' << r.trials.size() << ','
+               << number(s.median) << ',' << number(s.mean) << ',' << number(s.stddev) << ',' << number(s.min) << ',' << number(s.max) << '\n';
+        }
+    }
+    return static_cast<bool>(os);
+}
+
+bool write_json(const std::string& path, const std::string& tag, const std::vector<result_t>& results)
+{
+    std::ofstream os{path};
+    if (not os) { return false; }
+    os << "[";
+    bool first = true;
+    for (const auto& r : results) {
+        const auto& p = r.params;
+        os << (first ? "\n" : ",\n");
+        first = false;
+        os << "  {\"tag\": " << json_string(tag) << ", \"name\": " << json_string(r.name) << ", \"n\": " << p.n << ", \"q\": " << p.q << ", \"b\": " << p.b << ", \"m\": " << p.m
+           << ", \"dist\": " << json_string(p.dist) << ", \"threads\": " << p.threads << ", \"trials\": " << r.trials.size() << ", \"metrics\": {";
+        bool first_key = true;
+        for (const auto& [key, s] : r.stats()) {
+            os << (first_key ? "" : ", ") << json_string(key) << ": {\"median\": " << number(s.median) << ", \"mean\": " << number(s.mean) << ", \"stddev\": " << number(s.stddev)
+               << ", \"min\": " << number(s.min) << ", \"max\": " << number(s.max) << "}";
+            first_key = false;
+        }
+        os << "}}";
+    }
+    os << "\n]\n";
+    return static_cast<bool>(os);
+}
+
+void registry::add(const std::string& name, builder_t builder, std::function<void()> fin)
+{
+    m_entries.push_back(entry_t{name, std::move(builder), std::move(fin)});
+}
+
+/**
+ * データを作り直さなくてよいように、分布とNを一番外側に回す
+ * - 各アルゴリズムの前計算はその内側で、Q/B/M/スレッド数を変えるたびに行う
+ */
+std::vector<result_t> registry::measure(const options_t& opts, std::ostream& log) const
+{
+    std::vector<result_t> results;
+    for (const auto& dist : opts.dists) {
+        for (const std::size_t n : opts.ns) {
+            for (const auto& e : m_entries) {
+                if (e.name.find(opts.filter) == std::string::npos) { continue; }
+                for (const std::size_t q : opts.qs) {
+                    for (const std::size_t b : opts.bs) {
+                        for (const std::size_t m : opts.ms) {
+                            for (const std::size_t threads : opts.threads) {
+                                const params_t p{n, q, b, m, threads, dist};
+                                log << e.name << " (" << describe(p) << ")" << std::endl;
+                                const trial_t trial = e.builder(p);
+                                if (not trial) {
+                                    log << "Skipped." << std::endl << std::endl;
+                                    continue;
+                                }
+                                result_t r{e.name, p, {}};
+                                for (std::size_t t = 0; t < opts.warmup; t++) { trial(); }
+                                for (std::size_t t = 0; t < opts.trials; t++) { r.trials.push_back(trial()); }
+                                if (e.fin) { e.fin(); }
+                                for (const auto& [key, s] : r.stats()) {
+                                    log << key << ": " << s.median;
+                                    if (r.trials.size() > 1) { log << " (Median, Stddev: " << s.stddev << ", Min: " << s.min << ", Max: " << s.max << ")"; }
+                                    log << std::endl;
+                                }
+                                log << std::endl;
+                                results.push_back(std::move(r));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return results;
+}
+
+int registry::run(const options_t& opts) const
+{
+    const auto results = measure(opts, std::cout);
+    bool ok            = true;
+    if (not opts.csv.empty() and not write_csv(opts.csv, opts.tag, results)) {
+        std::cerr << "Failed to write " << opts.csv << std::endl;
+        ok = false;
+    }
+    if (not opts.json.empty() and not write_json(opts.json, opts.tag, results)) {
+        std::cerr << "Failed to write " << opts.json << std::endl;
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
+
+}  // namespace bench
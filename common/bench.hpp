@@ -0,0 +1,198 @@
+#pragma once
+/**
+ * @file bench.hpp
+ * @brief ベンチマークの登録と実行 (パラメータの掃引, 繰り返し計測, CSV/JSON出力)
+ * @note
+ * - アルゴリズムは「パラメータを受け取って前計算し、1回分の計測を返す関数」(builder)として登録する
+ * - N/Q/B/M/分布/スレッド数はコマンドライン引数で指定し、全ての組み合わせを順に試す
+ * - 各組み合わせでwarmup回捨ててからtrials回計測し、指標ごとに中央値/平均/標準偏差/最小/最大を出す
+ * - 使い方: --n=2^24+64 --q=2^20,2^22 --b=512 --m=2^18 --dist=uniform,skewed --threads=1,8
+ *           --warmup=1 --trials=5 --csv=out.csv --json=out.json --filter=CSS --tag=abc123
+ *   (値はカンマ区切りで複数指定できる, 数は10進か2^k(+c/-c)で書く, 上以外の--key=valueは例ごとの設定でextraに入る)
+ */
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rng.hpp"
+
+namespace bench {
+
+/**
+ * @brief 1回の計測に使うパラメータ
+ * - 使わないもの(実機でのB/Mなど)は0のままにしておく
+ */
+struct params_t
+{
+    std::size_t n       = 0;  // データ数
+    std::size_t q       = 0;  // クエリ数
+    std::size_t b       = 0;  // ブロックサイズ (シミュレータ)
+    std::size_t m       = 0;  // キャッシュサイズ (シミュレータ)
+    std::size_t threads = 1;  // スレッド数
+    std::string dist    = "uniform";
+};
+
+/**
+ * @brief 1回の計測結果 (指標名と値, 登録順に出力する)
+ */
+using metrics_t = std::vector<std::pair<std::string, double>>;
+
+/**
+ * @brief 1回分の計測 / パラメータから前計算して計測を返す関数
+ * - builderが空のtrialを返したら、そのパラメータでは飛ばす (対応していないBなど)
+ */
+using trial_t   = std::function<metrics_t()>;
+using builder_t = std::function<trial_t(const params_t&)>;
+
+/**
+ * @brief コマンドライン引数
+ */
+struct options_t
+{
+    std::vector<std::size_t> ns{1};
+    std::vector<std::size_t> qs{1};
+    std::vector<std::size_t> bs{0};
+    std::vector<std::size_t> ms{0};
+    std::vector<std::size_t> threads{1};
+    std::vector<std::string> dists{"uniform"};
+    std::size_t warmup = 0;
+    std::size_t trials = 1;
+    std::string csv;     // 空なら書かない
+    std::string json;    // 空なら書かない
+    std::string filter;  // 名前にこの文字列を含むものだけ実行する
+    std::string tag;     // 出力の各行に付ける文字列 (コミットIDなど)
+    std::map<std::string, std::string> extra;
+};
+
+/**
+ * @brief 引数を解析してoptsを上書きする (指定されなかったものはそのまま)
+ * @param extra_keys[in] extraに入れてよいキー (それ以外の知らないキーは失敗にする)
+ * @param err[out] 失敗したときの理由
+ */
+bool parse(int argc, char* argv[], options_t& opts, const std::vector<std::string>& extra_keys, std::string& err);
+
+/**
+ * @brief 数の解析 (10進, または 2^k, 2^k+c, 2^k-c)
+ */
+bool parse_size(const std::string& s, std::size_t& x);
+
+/**
+ * @brief カンマ区切りの数の解析 (失敗したらxsは変えない)
+ */
+bool parse_sizes(const std::string& s, std::vector<std::size_t>& xs);
+
+/**
+ * @brief 指標の要約
+ * - stddevは不偏分散の平方根 (1回だけなら0)
+ */
+struct stat_t
+{
+    double median;
+    double mean;
+    double stddev;
+    double min;
+    double max;
+};
+stat_t summarize(std::vector<double> xs);
+
+/**
+ * @brief 1つのパラメータでの計測結果
+ */
+struct result_t
+{
+    std::string name;
+    params_t params;
+    std::vector<metrics_t> trials;
+
+    /**
+     * @brief 指標ごとの要約 (最初の計測での順)
+     */
+    std::vector<std::pair<std::string, stat_t>> stats() const;
+};
+
+bool write_csv(const std::string& path, const std::string& tag, const std::vector<result_t>& results);
+bool write_json(const std::string& path, const std::string& tag, const std::vector<result_t>& results);
+
+/**
+ * @brief ベンチマークの登録先
+ */
+class registry
+{
+public:
+    /**
+     * @brief 登録
+     * @param name[in] 名前 (出力にそのまま使う)
+     * @param builder[in] 前計算して計測を返す関数
+     * @param fin[in] そのパラメータでの計測が終わった後の後始末 (省略可)
+     */
+    void add(const std::string& name, builder_t builder, std::function<void()> fin = nullptr);
+
+    /**
+     * @brief 全ての組み合わせで計測する (経過はlogに出す)
+     */
+    std::vector<result_t> measure(const options_t& opts, std::ostream& log) const;
+
+    /**
+     * @brief 計測して標準出力に経過を出し、指定があればCSV/JSONを書く (mainの戻り値を返す)
+     */
+    int run(const options_t& opts) const;
+
+private:
+    struct entry_t
+    {
+        std::string name;
+        builder_t builder;
+        std::function<void()> fin;
+    };
+    std::vector<entry_t> m_entries;
+};
+
+/**
+ * @brief 分布に従うn個の整数値
+ * - uniform: [min, max]の一様分布
+ * - skewed: 一様乱数の2乗で[min, max]に写す (minの近くに偏る)
+ * - dense: minから1~3刻みで増える列 (maxで頭打ち, 連続したキーに近い)
+ */
+template<typename T>
+std::vector<T> generate(const std::string& dist, const std::size_t n, const T min, const T max, const uint64_t seed)
+{
+    rng_base rng{seed};
+    std::vector<T> xs(n);
+    if (dist == "uniform") {
+        for (auto& x : xs) { x = rng.val<T>(min, max); }
+    } else if (dist == "skewed") {
+        constexpr uint64_t One = uint64_t{1} << 53;
+        for (auto& x : xs) {
+            const double u = static_cast<double>(rng.val<uint64_t>(0, One - 1)) / static_cast<double>(One);
+            x              = min + static_cast<T>(static_cast<double>(max - min) * u * u);
+        }
+    } else if (dist == "dense") {
+        T v = min;
+        for (auto& x : xs) {
+            x = v;
+            v = max - v < T{3} ? max : static_cast<T>(v + rng.val<T>(T{1}, T{3}));
+        }
+    } else {
+        throw std::invalid_argument{"unknown distribution: " + dist};
+    }
+    return xs;
+}
+
+/**
+ * @brief q個のクエリ (データの最大値がxmaxのとき)
+ * - denseはそのままだとデータの先頭の方しか引かないので、[min, xmax]の一様分布にする
+ * - それ以外はデータと同じ分布
+ */
+template<typename T>
+std::vector<T> generate_queries(const std::string& dist, const std::size_t q, const T min, const T max, const T xmax, const uint64_t seed)
+{
+    return dist == "dense" ? generate<T>("uniform", q, min, xmax, seed) : generate<T>(dist, q, min, max, seed);
+}
+
+}  // namespace bench
@@ -13,7 +13,7 @@
  */
 constexpr std::size_t lg(const std::size_t x)
 {
-    return 32 - __builtin_clz(x);
+    return static_cast<std::size_t>(63 - __builtin_clzll(x));
 }
 
 /**
@@ -21,7 +21,7 @@ constexpr std::size_t lg(const std::size_t x)
  */
 constexpr std::size_t clg(const std::size_t x)
 {
-    return x <= 1 ? 1 : lg(x - 1) + 1;
+    return x <= 1 ? 0 : lg(x - 1) + 1;
 }
 
 /**
@@ -31,7 +31,7 @@ constexpr std::size_t clg(const std::size_t x)
  */
 constexpr std::size_t lsb(const std::size_t x)
 {
-    return __builtin_ffs(x) - 1;
+    return static_cast<std::size_t>(__builtin_ffsll(static_cast<long long>(x)) - 1);
 }
 
 /**
@@ -0,0 +1,41 @@
+#include <cassert>
+#include <thread>
+
+#include "epoch.hpp"
+
+epoch_domain::epoch_domain(const std::size_t readers) : m_readers{readers}, m_slots{new slot_t[readers]} {}
+
+/**
+ * 枠に書いてから読み始める
+ * - 書き手は外してからadvance()して枠を見るので、外す前のものを読んだ読み手の枠は必ず書き手から見える (seq_cst)
+ */
+void epoch_domain::enter(const std::size_t reader)
+{
+    assert(reader < m_readers);
+    m_slots[reader].epoch.store(m_epoch.load());
+}
+
+void epoch_domain::leave(const std::size_t reader)
+{
+    assert(reader < m_readers);
+    m_slots[reader].epoch.store(0, std::memory_order_release);
+}
+
+uint64_t epoch_domain::advance()
+{
+    return m_epoch.fetch_add(1) + 1;
+}
+
+bool epoch_domain::quiescent(const uint64_t e) const
+{
+    for (std::size_t i = 0; i < m_readers; i++) {
+        const uint64_t local = m_slots[i].epoch.load();
+        if (local != 0 and local < e) { return false; }
+    }
+    return true;
+}
+
+void epoch_domain::wait(const uint64_t e) const
+{
+    while (not quiescent(e)) { std::this_thread::yield(); }
+}
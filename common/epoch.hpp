@@ -0,0 +1,68 @@
+#pragma once
+/**
+ * @file epoch.hpp
+ * @brief エポックによる読み手の追跡 (遅延解放用)
+ * @note
+ * - 読み手は番号(0 <= reader < 読み手の数)ごとに自分の枠を持ち、読んでいる間だけ入ったときのエポックを書いておく
+ * - 書き手は古いものを外した後にエポックを進め、それより前に入った読み手が全員出たら解放してよい
+ * - 読み手はロックもCASもしない (自分の枠への書き込み2回だけ)
+ */
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief エポック
+ */
+class epoch_domain
+{
+public:
+    /**
+     * @brief コンストラクタ
+     * @param readers[in] 読み手の数
+     */
+    explicit epoch_domain(const std::size_t readers);
+
+    /**
+     * @brief 読み始め
+     * @param reader[in] 読み手の番号 (同時に同じ番号を使ってはいけない)
+     */
+    void enter(const std::size_t reader);
+
+    /**
+     * @brief 読み終わり
+     * @param reader[in] 読み手の番号
+     */
+    void leave(const std::size_t reader);
+
+    /**
+     * @brief エポックを進める
+     * @return 進めた後のエポック
+     */
+    uint64_t advance();
+
+    /**
+     * @brief エポックe未満で入った読み手が残っていなければtrue
+     */
+    bool quiescent(const uint64_t e) const;
+
+    /**
+     * @brief quiescent(e)になるまで待つ
+     */
+    void wait(const uint64_t e) const;
+
+    /**
+     * @brief 読み手の数
+     */
+    std::size_t readers() const { return m_readers; }
+
+private:
+    struct alignas(64) slot_t
+    {
+        std::atomic<uint64_t> epoch{0};  // 0なら読んでいない
+    };
+
+    std::size_t m_readers;
+    std::unique_ptr<slot_t[]> m_slots;
+    alignas(64) std::atomic<uint64_t> m_epoch{1};
+};
@@ -0,0 +1,136 @@
+#pragma once
+/**
+ * @file hot_swap.hpp
+ * @brief 読み手を止めずにデータ構造を差し替える (RCU風)
+ * @note
+ * - 読み手はread()で今のものを掴み、guardが生きている間はそれを使う (ロックしない)
+ * - 書き手は新しいものを作ってからpublish()でポインタを1回で差し替える
+ * - 古いものは、差し替え前に読み始めた読み手が全員読み終わってから解放する (epoch_domain)
+ */
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/epoch.hpp"
+
+/**
+ * @brief 差し替え可能なTの入れ物
+ */
+template<typename T>
+class hot_swap
+{
+public:
+    /**
+     * @brief 読み手が掴んでいる間のT
+     */
+    class guard
+    {
+    public:
+        guard(epoch_domain& domain, const std::size_t reader, const T* ptr) : m_domain{&domain}, m_reader{reader}, m_ptr{ptr} {}
+        guard(const guard&) = delete;
+        guard& operator=(const guard&) = delete;
+        guard(guard&& other) noexcept : m_domain{std::exchange(other.m_domain, nullptr)}, m_reader{other.m_reader}, m_ptr{other.m_ptr} {}
+        ~guard()
+        {
+            if (m_domain != nullptr) { m_domain->leave(m_reader); }
+        }
+        const T& operator*() const { return *m_ptr; }
+        const T* operator->() const { return m_ptr; }
+
+    private:
+        epoch_domain* m_domain;
+        std::size_t m_reader;
+        const T* m_ptr;
+    };
+
+    /**
+     * @brief コンストラクタ
+     * @param readers[in] 読み手の数
+     * @param init[in] 最初のT
+     */
+    hot_swap(const std::size_t readers, std::unique_ptr<T> init) : m_domain{readers}, m_ptr{init.release()} {}
+    hot_swap(const hot_swap&) = delete;
+    hot_swap& operator=(const hot_swap&) = delete;
+    ~hot_swap()
+    {
+        for (const auto& retired : m_retired) { delete retired.first; }
+        delete m_ptr.load();
+    }
+
+    /**
+     * @brief 今のTを掴む
+     * @param reader[in] 読み手の番号 (guardが生きている間は他で使わない)
+     */
+    guard read(const std::size_t reader)
+    {
+        m_domain.enter(reader);
+        return guard{m_domain, reader, m_ptr.load()};
+    }
+
+    /**
+     * @brief 差し替え
+     * @param next[in] 新しいT
+     * @details 古いものは解放待ちにし、解放してよいものだけ解放する (待たない)
+     */
+    void publish(std::unique_ptr<T> next)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        T* old = m_ptr.exchange(next.release());
+        m_retired.emplace_back(old, m_domain.advance());
+        reclaim_locked();
+    }
+
+    /**
+     * @brief 別スレッドでbuild()を呼んで作り、できたら差し替える
+     * @param build[in] std::unique_ptr<T>を返す関数
+     */
+    template<typename Build>
+    std::thread rebuild(Build build)
+    {
+        return std::thread{[this, build = std::move(build)]() mutable { publish(build()); }};
+    }
+
+    /**
+     * @brief 解放待ちを全部解放する (読み手が読み終わるまで待つ)
+     */
+    void synchronize()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        for (const auto& retired : m_retired) {
+            m_domain.wait(retired.second);
+            delete retired.first;
+        }
+        m_retired.clear();
+    }
+
+    /**
+     * @brief 解放待ちの個数
+     */
+    std::size_t retired_num()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_retired.size();
+    }
+
+private:
+    void reclaim_locked()
+    {
+        std::vector<std::pair<T*, uint64_t>> rest;
+        for (const auto& retired : m_retired) {
+            if (m_domain.quiescent(retired.second)) {
+                delete retired.first;
+            } else {
+                rest.push_back(retired);
+            }
+        }
+        m_retired = std::move(rest);
+    }
+
+    epoch_domain m_domain;
+    std::atomic<T*> m_ptr;
+    std::mutex m_mutex;
+    std::vector<std::pair<T*, uint64_t>> m_retired;  // (古いもの, 外した後のエポック)
+};
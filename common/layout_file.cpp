@@ -0,0 +1,185 @@
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "layout_file.hpp"
+
+namespace layout_file {
+
+uint64_t checksum(const void* data, const std::size_t bytes, uint64_t seed)
+{
+    constexpr uint64_t Prime = 0x100000001B3ULL;
+    const auto* p            = static_cast<const uint8_t*>(data);
+    std::size_t i            = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t w;
+        std::memcpy(&w, p + i, 8);
+        seed = (seed ^ w) * Prime;
+        seed ^= seed >> 29;
+    }
+    for (; i < bytes; i++) { seed = (seed ^ p[i]) * Prime; }
+    return seed;
+}
+
+}  // namespace layout_file
+
+namespace {
+
+constexpr uint64_t Seed = 0xCBF29CE484222325ULL;
+
+constexpr std::size_t align_up(const std::size_t x)
+{
+    return (x + layout_file::Align - 1) / layout_file::Align * layout_file::Align;
+}
+
+}  // anonymous namespace
+
+layout_writer::layout_writer(const layout_file::key_kind kind, const uint64_t data_seed) : m_kind{kind}, m_data_seed{data_seed} {}
+
+bool layout_writer::add_raw(const std::string& name, const void* data, const std::size_t elem_size, const std::size_t count)
+{
+    if (name.empty() or name.size() >= layout_file::NameLen) { return false; }
+    for (const auto& entry : m_entries) {
+        if (entry.name == name) { return false; }
+    }
+    m_entries.push_back(entry_t{name, data, elem_size, count});
+    return true;
+}
+
+/**
+ * ヘッダ -> セクション表 -> 各セクションの順に先頭から書く
+ * - オフセットとチェックサムは書く前にメモリ上で計算しておく
+ */
+bool layout_writer::write(const std::string& path) const
+{
+    std::vector<layout_file::section_t> sections(m_entries.size());
+    std::size_t offset = align_up(sizeof(layout_file::header_t) + sizeof(layout_file::section_t) * m_entries.size());
+    uint64_t sum       = Seed;
+    for (std::size_t i = 0; i < m_entries.size(); i++) {
+        const auto& entry = m_entries[i];
+        auto& section     = sections[i];
+        std::memset(&section, 0, sizeof(section));
+        std::memcpy(section.name, entry.name.data(), entry.name.size());
+        section.offset    = offset;
+        section.elem_size = entry.elem_size;
+        section.count     = entry.count;
+        sum               = layout_file::checksum(entry.data, entry.elem_size * entry.count, sum);
+        offset            = align_up(offset + entry.elem_size * entry.count);
+    }
+    layout_file::header_t header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, layout_file::Magic, sizeof(header.magic));
+    header.version     = layout_file::Version;
+    header.key_size    = static_cast<uint32_t>(layout_file::key_size_of(m_kind));
+    header.key_tag     = static_cast<uint32_t>(m_kind);
+    header.section_num = m_entries.size();
+    header.file_size   = offset;
+    header.checksum    = sum;
+    header.data_seed   = m_data_seed;
+
+    const std::string tmp_path = path + ".tmp";
+    std::FILE* fp              = std::fopen(tmp_path.c_str(), "wb");
+    if (fp == nullptr) { return false; }
+    static const uint8_t Zeros[layout_file::Align] = {};
+    std::size_t written                            = 0;
+    const auto put = [&](const void* data, const std::size_t bytes) {
+        written += bytes;
+        return std::fwrite(data, 1, bytes, fp) == bytes;
+    };
+    bool ok = put(&header, sizeof(header)) and put(sections.data(), sizeof(layout_file::section_t) * sections.size());
+    for (std::size_t i = 0; ok and i < m_entries.size(); i++) {
+        ok = put(Zeros, sections[i].offset - written) and put(m_entries[i].data, m_entries[i].elem_size * m_entries[i].count);
+    }
+    ok = ok and put(Zeros, offset - written);
+    ok = (std::fclose(fp) == 0) and ok;
+    if (ok) { ok = std::rename(tmp_path.c_str(), path.c_str()) == 0; }
+    if (not ok) { std::remove(tmp_path.c_str()); }
+    return ok;
+}
+
+layout_reader::~layout_reader()
+{
+    close();
+}
+
+bool layout_reader::open(const std::string& path, const layout_file::key_kind kind, const unsigned flags)
+{
+    close();
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) { return false; }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 or static_cast<std::size_t>(st.st_size) < sizeof(layout_file::header_t)) {
+        ::close(fd);
+        return false;
+    }
+    const std::size_t size = static_cast<std::size_t>(st.st_size);
+    void* addr             = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE | ((flags & Populate) ? MAP_POPULATE : 0), fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) { return false; }
+    if (flags & HugePage) { ::madvise(addr, size, MADV_HUGEPAGE); }
+    m_addr = static_cast<const uint8_t*>(addr);
+    m_size = size;
+    if (not validate(kind, flags)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void layout_reader::close()
+{
+    if (m_addr != nullptr) { ::munmap(const_cast<uint8_t*>(m_addr), m_size); }
+    m_addr = nullptr;
+    m_size = 0;
+}
+
+std::size_t layout_reader::key_size() const
+{
+    return m_addr == nullptr ? 0 : reinterpret_cast<const layout_file::header_t*>(m_addr)->key_size;
+}
+
+uint64_t layout_reader::data_seed() const
+{
+    return m_addr == nullptr ? 0 : reinterpret_cast<const layout_file::header_t*>(m_addr)->data_seed;
+}
+
+/**
+ * ヘッダとセクション表がファイルの中に収まっているか、キーの型が一致するかを確認する
+ */
+bool layout_reader::validate(const layout_file::key_kind kind, const unsigned flags) const
+{
+    const auto* header = reinterpret_cast<const layout_file::header_t*>(m_addr);
+    if (std::memcmp(header->magic, layout_file::Magic, sizeof(header->magic)) != 0) { return false; }
+    if (header->version != layout_file::Version or header->file_size != m_size) { return false; }
+    if (header->key_tag != static_cast<uint32_t>(kind) or header->key_size != layout_file::key_size_of(kind)) { return false; }
+    if (header->section_num > (m_size - sizeof(layout_file::header_t)) / sizeof(layout_file::section_t)) { return false; }
+    const auto* sections = reinterpret_cast<const layout_file::section_t*>(m_addr + sizeof(layout_file::header_t));
+    uint64_t sum         = Seed;
+    for (std::size_t i = 0; i < header->section_num; i++) {
+        const auto& section = sections[i];
+        if (section.name[layout_file::NameLen - 1] != '\0' or section.offset % layout_file::Align != 0) { return false; }
+        if (section.elem_size != 0 and section.count > m_size / section.elem_size) { return false; }
+        const std::size_t bytes = section.elem_size * section.count;
+        if (section.offset > m_size or bytes > m_size - section.offset) { return false; }
+        if (flags & Verify) { sum = layout_file::checksum(m_addr + section.offset, bytes, sum); }
+    }
+    return not(flags & Verify) or sum == header->checksum;
+}
+
+const void* layout_reader::get_raw(const std::string& name, const std::size_t elem_size, std::size_t& count) const
+{
+    count = 0;
+    if (m_addr == nullptr) { return nullptr; }
+    const auto* header   = reinterpret_cast<const layout_file::header_t*>(m_addr);
+    const auto* sections = reinterpret_cast<const layout_file::section_t*>(m_addr + sizeof(layout_file::header_t));
+    for (std::size_t i = 0; i < header->section_num; i++) {
+        if (name != sections[i].name) { continue; }
+        if (sections[i].elem_size != elem_size) { return nullptr; }
+        count = sections[i].count;
+        return m_addr + sections[i].offset;
+    }
+    return nullptr;
+}
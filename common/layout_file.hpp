@@ -0,0 +1,228 @@
+#pragma once
+/**
+ * @file layout_file.hpp
+ * @brief 構築済みのレイアウトをファイルに保存し、mmapでそのまま読み込む
+ * @note
+ * - ファイル形式 (リトルエンディアン)
+ *   [ヘッダ(64byte)][セクション表(64byte x セクション数)][セクション0][セクション1]...
+ * - 各セクションの先頭は64byte境界に置く (キャッシュライン単位のレイアウトをそのまま使える)
+ * - チェックサムは全セクションの中身(パディングを除く)に対して計算する
+ * - キーの型はバイト数ではなく型そのもの(key_kind)で記録し、開くときに一致を確認する
+ * - データ生成のシードも記録する (別のシードで作った古いファイルを使わないよう、呼び出し側で確認する)
+ * - 失敗はboolで返す
+ */
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace layout_file {
+
+constexpr char Magic[8]       = {'C', 'O', 'L', 'A', 'Y', 'O', 'U', 'T'};
+constexpr uint32_t Version    = 2;
+constexpr std::size_t Align   = 64;
+constexpr std::size_t NameLen = 32;
+
+/**
+ * @brief キーの型 (バイト数だけではuint32とint32/floatを区別できない)
+ */
+enum class key_kind : uint32_t
+{
+    UInt32 = 1,
+    Int32  = 2,
+    Float  = 3,
+    UInt64 = 4,
+    Int64  = 5,
+    Double = 6,
+};
+
+/**
+ * @brief 型Tのkey_kind
+ */
+template<typename T>
+constexpr key_kind key_kind_of()
+{
+    if constexpr (std::is_same_v<T, uint32_t>) {
+        return key_kind::UInt32;
+    } else if constexpr (std::is_same_v<T, int32_t>) {
+        return key_kind::Int32;
+    } else if constexpr (std::is_same_v<T, float>) {
+        return key_kind::Float;
+    } else if constexpr (std::is_same_v<T, uint64_t>) {
+        return key_kind::UInt64;
+    } else if constexpr (std::is_same_v<T, int64_t>) {
+        return key_kind::Int64;
+    } else {
+        static_assert(std::is_same_v<T, double>, "unsupported key type");
+        return key_kind::Double;
+    }
+}
+
+/**
+ * @brief key_kindのバイト数
+ */
+constexpr std::size_t key_size_of(const key_kind kind)
+{
+    return kind == key_kind::UInt64 or kind == key_kind::Int64 or kind == key_kind::Double ? 8 : 4;
+}
+
+/**
+ * @brief ファイルヘッダ
+ */
+struct header_t
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t key_size;  // キーのバイト数
+    uint64_t section_num;
+    uint64_t file_size;
+    uint64_t checksum;
+    uint64_t data_seed;  // データ生成のシード
+    uint32_t key_tag;    // キーの型 (key_kind)
+    uint8_t reserved[12];
+};
+static_assert(sizeof(header_t) == 64, "header_t must be 64 bytes");
+
+/**
+ * @brief セクション表の要素
+ */
+struct section_t
+{
+    char name[NameLen];  // 0終端
+    uint64_t offset;     // ファイル先頭からのバイト数 (Alignの倍数)
+    uint64_t elem_size;
+    uint64_t count;
+    uint64_t reserved;
+};
+static_assert(sizeof(section_t) == 64, "section_t must be 64 bytes");
+
+/**
+ * @brief チェックサム (8byteずつ混ぜる)
+ */
+uint64_t checksum(const void* data, const std::size_t bytes, uint64_t seed);
+
+}  // namespace layout_file
+
+/**
+ * @brief レイアウトの書き出し
+ * @details
+ * - add()で配列を登録し(コピーはしない)、write()で先頭から順に1回で書く
+ */
+class layout_writer
+{
+public:
+    /**
+     * @brief コンストラクタ
+     * @param kind[in] キーの型
+     * @param data_seed[in] データ生成のシード
+     */
+    explicit layout_writer(const layout_file::key_kind kind, const uint64_t data_seed = 0);
+
+    /**
+     * @brief セクションの登録
+     * @param name[in] セクション名 (NameLen-1文字まで)
+     * @param data[in] 配列の先頭 (write()まで生きていること)
+     * @param count[in] 要素数
+     */
+    template<typename T>
+    bool add(const std::string& name, const T* data, const std::size_t count)
+    {
+        return add_raw(name, data, sizeof(T), count);
+    }
+
+    /**
+     * @brief 書き出し
+     * @param path[in] 出力先 (一時ファイルに書いてからrenameする)
+     */
+    bool write(const std::string& path) const;
+
+private:
+    struct entry_t
+    {
+        std::string name;
+        const void* data;
+        std::size_t elem_size;
+        std::size_t count;
+    };
+    bool add_raw(const std::string& name, const void* data, const std::size_t elem_size, const std::size_t count);
+
+    layout_file::key_kind m_kind;
+    uint64_t m_data_seed;
+    std::vector<entry_t> m_entries;
+};
+
+/**
+ * @brief レイアウトの読み込み
+ * @details
+ * - ファイルを読み取り専用でmmapし、各セクションはそのままポインタで返す (コピーしない)
+ */
+class layout_reader
+{
+public:
+    /**
+     * @brief open()のフラグ
+     * - Populate: MAP_POPULATEで先に全ページを読み込む
+     * - HugePage: MADV_HUGEPAGEを指定する (使えなければ無視)
+     * - Verify: チェックサムを確認する (全体を1回読む)
+     */
+    enum flag_t : unsigned
+    {
+        Populate = 1U << 0,
+        HugePage = 1U << 1,
+        Verify   = 1U << 2,
+    };
+
+    layout_reader() = default;
+    layout_reader(const layout_reader&) = delete;
+    layout_reader& operator=(const layout_reader&) = delete;
+    ~layout_reader();
+
+    /**
+     * @brief ファイルを開く
+     * @param path[in] ファイル
+     * @param kind[in] キーの型 (ファイルに記録された型と違えば失敗)
+     * @param flags[in] flag_tの論理和
+     * @return ヘッダ・セクション表が正しく、キーの型が一致し、(Verifyなら)チェックサムが一致すればtrue
+     */
+    bool open(const std::string& path, const layout_file::key_kind kind, const unsigned flags = 0);
+
+    /**
+     * @brief 閉じる (セクションへのポインタは無効になる)
+     */
+    void close();
+
+    /**
+     * @brief セクションの取得
+     * @param name[in] セクション名
+     * @param count[out] 要素数
+     * @return 先頭へのポインタ (無いか要素のサイズが違えばnullptr)
+     */
+    template<typename T>
+    const T* get(const std::string& name, std::size_t& count) const
+    {
+        return static_cast<const T*>(get_raw(name, sizeof(T), count));
+    }
+
+    /**
+     * @brief キーのバイト数
+     */
+    std::size_t key_size() const;
+
+    /**
+     * @brief データ生成のシード
+     */
+    uint64_t data_seed() const;
+
+    /**
+     * @brief ファイルのバイト数
+     */
+    std::size_t size() const { return m_size; }
+
+private:
+    const void* get_raw(const std::string& name, const std::size_t elem_size, std::size_t& count) const;
+    bool validate(const layout_file::key_kind kind, const unsigned flags) const;
+
+    const uint8_t* m_addr = nullptr;
+    std::size_t m_size    = 0;
+};
@@ -0,0 +1,360 @@
+#pragma once
+/**
+ * @file olc_b_tree.hpp
+ * @brief 楽観的ロックカップリング(Optimistic Lock Coupling)による並行B+木
+ * @note
+ * - 読み手はロックを取らない。頂点のversionを読んでから中身を読み、versionが変わっていなければ読んだ内容を使う
+ *   (変わっていれば根からやり直す)
+ *   子のversionを読んだ後にも親のversionを確かめる (分割は親もロックするので、子がその間に分割されていないことが分かる)
+ * - 書き手は書き換える頂点だけversionをCASしてロックする
+ *   満杯の頂点は降りる途中で分割する (分割時にロックするのは親とその頂点だけ)
+ * - 葉は右隣の葉へのポインタを持つ (lower_boundが葉の右端を越えたとき用)
+ * - 削除は無いので頂点は解放しない (読み手が古い頂点を読んでいても安全)
+ * - 読み手が書き込み中に読みうるフィールド(count, keys, sons, next)はrelaxedなatomicにする (データ競合にしない)
+ *   順序はseqlockと同じく、書き手はロック直後にreleaseフェンス、読み手はversionの再確認の直前にacquireフェンスで保証する
+ *   x86ではどちらも命令にならないので、普通のload/storeと同じコードになる
+ */
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+#include <limits>
+
+namespace olc {
+
+/**
+ * @brief relaxedで読み書きするT (代入と変換だけ)
+ */
+template<typename T>
+class relaxed
+{
+public:
+    relaxed() = default;
+    explicit relaxed(const T v) : m_value{v} {}
+    relaxed& operator=(const T v)
+    {
+        m_value.store(v, std::memory_order_relaxed);
+        return *this;
+    }
+    relaxed& operator=(const relaxed& other) { return *this = static_cast<T>(other); }
+    operator T() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<T> m_value;
+};
+
+/**
+ * @brief 頂点の共通部分
+ * - version: 書き込みのたびに4増える。2のbitが立っている間は書き込み中
+ */
+struct node_t
+{
+    explicit node_t(const bool leaf_) : leaf{leaf_} {}
+    std::atomic<uint64_t> version{0};
+    relaxed<uint32_t> count{0U};
+    const bool leaf;
+};
+
+/**
+ * @brief 読み始め (書き込み中ならやり直し)
+ */
+inline uint64_t read_lock(const node_t* node, bool& restart)
+{
+    const uint64_t v = node->version.load();
+    if (v & 2) {
+        _mm_pause();
+        restart = true;
+    }
+    return v;
+}
+
+/**
+ * @brief 読み終わり (読み始めからversionが変わっていればやり直し)
+ */
+inline void check(const node_t* node, const uint64_t v, bool& restart)
+{
+    std::atomic_thread_fence(std::memory_order_acquire);  // 中身を読み終えてからversionを読む
+    if (node->version.load(std::memory_order_relaxed) != v) { restart = true; }
+}
+
+/**
+ * @brief 読み始めたときのversionのままなら書き込みロックを取る
+ */
+inline void upgrade(node_t* node, uint64_t v, bool& restart)
+{
+    if (not node->version.compare_exchange_strong(v, v + 2)) {
+        restart = true;
+        return;
+    }
+    std::atomic_thread_fence(std::memory_order_release);  // 書き込み中の印を中身より先に見せる
+}
+
+inline void write_unlock(node_t* node)
+{
+    node->version.fetch_add(2);
+}
+
+/**
+ * @brief 並行B+木
+ * @tparam Key キー (整数)
+ * @tparam NodeBytes 頂点のバイト数
+ * @note
+ * 探索木としての性質として以下が成立している
+ * - 葉: keys[0, count)に昇順のキー
+ * - 中間ノード: sons[i]に含まれるキーは、keys[i-1]より大きくkeys[i]以下
+ */
+template<typename Key, std::size_t NodeBytes = 256>
+class tree
+{
+public:
+    static constexpr std::size_t LeafCap  = (NodeBytes - sizeof(node_t) - sizeof(void*)) / sizeof(Key);
+    static constexpr std::size_t InnerCap = (NodeBytes - sizeof(node_t) - sizeof(void*)) / (sizeof(Key) + sizeof(void*));
+    static constexpr Key Inf              = std::numeric_limits<Key>::max();  // lower_boundで見つからないとき
+    static_assert(LeafCap >= 2 and InnerCap >= 2, "NodeBytes is too small");
+
+    tree() : m_root{new leaf_t} {}
+    tree(const tree&) = delete;
+    tree& operator=(const tree&) = delete;
+    ~tree() { destroy(m_root.load()); }
+
+    /**
+     * @brief 挿入 (既にあれば何もせずfalse)
+     */
+    bool insert(const Key k)
+    {
+        while (true) {
+            bool restart = false;
+            node_t* node = m_root.load();
+            uint64_t v   = read_lock(node, restart);
+            if (restart or node != m_root.load()) { continue; }
+            inner_t* parent = nullptr;
+            uint64_t pv     = 0;
+            while (not node->leaf) {
+                inner_t* inner = static_cast<inner_t*>(node);
+                if (inner->count == InnerCap) {
+                    split_node(parent, pv, inner, v);
+                    restart = true;
+                    break;
+                }
+                if (parent != nullptr) {
+                    check(parent, pv, restart);
+                    if (restart) { break; }
+                }
+                parent = inner;
+                pv     = v;
+                node   = inner->sons[rank<InnerCap>(inner->keys, inner->count, k)];
+                check(inner, v, restart);
+                if (restart) { break; }
+                v = read_lock(node, restart);
+                if (restart) { break; }
+            }
+            if (restart) { continue; }
+
+            leaf_t* leaf = static_cast<leaf_t*>(node);
+            if (leaf->count == LeafCap) {
+                split_node(parent, pv, leaf, v);
+                continue;
+            }
+            upgrade(leaf, v, restart);
+            if (restart) { continue; }
+            if (parent != nullptr) {
+                check(parent, pv, restart);
+                if (restart) {
+                    write_unlock(leaf);
+                    continue;
+                }
+            }
+            const uint32_t count = leaf->count;
+            const std::size_t i  = rank<LeafCap>(leaf->keys, count, k);
+            if (i < count and leaf->keys[i] == k) {
+                write_unlock(leaf);
+                return false;
+            }
+            std::copy_backward(leaf->keys + i, leaf->keys + count, leaf->keys + count + 1);
+            leaf->keys[i] = k;
+            leaf->count   = count + 1;
+            write_unlock(leaf);
+            return true;
+        }
+    }
+
+    /**
+     * @brief k以上の最小のキー (無ければInf)
+     * - ロックは取らない
+     */
+    Key lower_bound(const Key k) const
+    {
+        while (true) {
+            bool restart       = false;
+            const node_t* node = m_root.load();
+            uint64_t v         = read_lock(node, restart);
+            if (restart or node != m_root.load()) { continue; }
+            while (not node->leaf) {
+                const inner_t* parent = static_cast<const inner_t*>(node);
+                const uint64_t pv     = v;
+                node                  = parent->sons[rank<InnerCap>(parent->keys, parent->count, k)];
+                check(parent, pv, restart);
+                if (restart) { break; }
+                v = read_lock(node, restart);
+                if (restart) { break; }
+                check(parent, pv, restart);  // 子のversionを読むまでに子が分割されていたら、子はもうkの範囲を持っていないかもしれない
+                if (restart) { break; }
+            }
+            if (restart) { continue; }
+
+            const leaf_t* leaf   = static_cast<const leaf_t*>(node);
+            const uint32_t count = leaf->count;
+            const std::size_t i  = rank<LeafCap>(leaf->keys, count, k);
+            if (i < count) {
+                const Key ans = leaf->keys[i];
+                check(leaf, v, restart);
+                if (restart) { continue; }
+                return ans;
+            }
+            const leaf_t* next = leaf->next;
+            check(leaf, v, restart);
+            if (restart) { continue; }
+            if (next == nullptr) { return Inf; }
+            const uint64_t nv = read_lock(next, restart);
+            if (restart) { continue; }
+            const Key ans = next->keys[0];
+            check(next, nv, restart);
+            if (restart) { continue; }
+            return ans;
+        }
+    }
+
+private:
+    /**
+     * 葉: keys[0, count)に昇順のキー
+     */
+    struct alignas(64) leaf_t : node_t
+    {
+        leaf_t() : node_t{true} {}
+        relaxed<leaf_t*> next{nullptr};
+        relaxed<Key> keys[LeafCap];
+    };
+
+    /**
+     * 中間ノード: sons[0, count]とkeys[0, count)
+     */
+    struct alignas(64) inner_t : node_t
+    {
+        inner_t() : node_t{false} {}
+        relaxed<node_t*> sons[InnerCap + 1];
+        relaxed<Key> keys[InnerCap];
+    };
+    static_assert(sizeof(leaf_t) <= NodeBytes and sizeof(inner_t) <= NodeBytes, "node must fit in NodeBytes");
+
+    /**
+     * keys[0, count)でk未満のキーの個数
+     * - countは書き込み中に読んだ値かもしれないので上限で抑える
+     */
+    template<std::size_t Cap>
+    static std::size_t rank(const relaxed<Key>* keys, const uint32_t count, const Key k)
+    {
+        std::size_t inf = 0, sup = std::min<std::size_t>(count, Cap);
+        while (inf < sup) {
+            const std::size_t mid = (inf + sup) / 2;
+            if (keys[mid] < k) {
+                inf = mid + 1;
+            } else {
+                sup = mid;
+            }
+        }
+        return inf;
+    }
+
+    /**
+     * 満杯の頂点nodeを2つに分け、区切りのキーを親に入れる (根なら新しい根を作る)
+     * - 親とnodeだけ書き込みロックする。取れなければ何もしない (呼び出し側は根からやり直す)
+     * - 親は降りてくるときに満杯でなかった (満杯なら先に分割している) ので、versionが同じなら入る
+     */
+    template<typename Node>
+    void split_node(inner_t* parent, const uint64_t pv, Node* node, const uint64_t v)
+    {
+        bool restart = false;
+        if (parent != nullptr) {
+            upgrade(parent, pv, restart);
+            if (restart) { return; }
+        }
+        upgrade(node, v, restart);
+        if (restart) {
+            if (parent != nullptr) { write_unlock(parent); }
+            return;
+        }
+        if (parent == nullptr and node != m_root.load()) {
+            write_unlock(node);
+            return;
+        }
+        Key sep;
+        Node* right = split(node, sep);
+        if (parent != nullptr) {
+            const uint32_t count = parent->count;
+            const std::size_t i  = rank<InnerCap>(parent->keys, count, sep);
+            std::copy_backward(parent->keys + i, parent->keys + count, parent->keys + count + 1);
+            std::copy_backward(parent->sons + i + 1, parent->sons + count + 1, parent->sons + count + 2);
+            parent->keys[i]     = sep;
+            parent->sons[i + 1] = right;
+            parent->count       = count + 1;
+        } else {
+            inner_t* root = new inner_t;
+            root->count   = 1;
+            root->keys[0] = sep;
+            root->sons[0] = node;
+            root->sons[1] = right;
+            m_root.store(root);
+        }
+        write_unlock(node);
+        if (parent != nullptr) { write_unlock(parent); }
+    }
+
+    /**
+     * 葉: 後ろ半分を新しい葉に移し、左の最大のキーを区切りにする (右の葉は葉の列に挟む)
+     */
+    static leaf_t* split(leaf_t* leaf, Key& sep)
+    {
+        leaf_t* right         = new leaf_t;
+        const uint32_t count  = leaf->count;
+        const std::size_t mid = count / 2;
+        std::copy(leaf->keys + mid, leaf->keys + count, right->keys);
+        right->count = static_cast<uint32_t>(count - mid);
+        right->next  = leaf->next;
+        leaf->count  = static_cast<uint32_t>(mid);
+        leaf->next   = right;
+        sep          = leaf->keys[mid - 1];
+        return right;
+    }
+
+    /**
+     * 中間ノード: 真ん中のキーを区切りとして上げ、後ろ半分を新しい頂点に移す
+     */
+    static inner_t* split(inner_t* inner, Key& sep)
+    {
+        inner_t* right        = new inner_t;
+        const uint32_t count  = inner->count;
+        const std::size_t mid = count / 2;
+        std::copy(inner->keys + mid + 1, inner->keys + count, right->keys);
+        std::copy(inner->sons + mid + 1, inner->sons + count + 1, right->sons);
+        right->count = static_cast<uint32_t>(count - mid - 1);
+        inner->count = static_cast<uint32_t>(mid);
+        sep          = inner->keys[mid];
+        return right;
+    }
+
+    static void destroy(node_t* node)
+    {
+        if (node->leaf) {
+            delete static_cast<leaf_t*>(node);
+        } else {
+            inner_t* inner = static_cast<inner_t*>(node);
+            for (std::size_t i = 0; i <= inner->count; i++) { destroy(inner->sons[i]); }
+            delete inner;
+        }
+    }
+
+    std::atomic<node_t*> m_root;
+};
+
+}  // namespace olc
@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <cstdint>
+#include <sys/mman.h>
+
+#include "page_alloc.hpp"
+
+namespace page_alloc {
+
+namespace {
+
+std::size_t round_up(const std::size_t bytes, const std::size_t unit)
+{
+    return (std::max<std::size_t>(bytes, 1) + unit - 1) / unit * unit;
+}
+
+void* map(const std::size_t bytes, const int extra_flags)
+{
+    void* addr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extra_flags, -1, 0);
+    return addr == MAP_FAILED ? nullptr : addr;
+}
+
+}  // anonymous namespace
+
+/**
+ * THPの場合は2M余分に確保して2M境界に切り揃え、前後の余りはすぐ返す
+ * (munmapするときの範囲がMAP_HUGETLBと同じになる)
+ */
+void* allocate(const std::size_t bytes, const page_t page, backing_t* backing)
+{
+    if (page == page_t::Small) {
+        const std::size_t size = round_up(bytes, SmallPage);
+        void* addr             = map(size, 0);
+        if (addr == nullptr) { return nullptr; }
+        ::madvise(addr, size, MADV_NOHUGEPAGE);
+        if (backing != nullptr) { *backing = backing_t::Small; }
+        return addr;
+    }
+    const std::size_t size = round_up(bytes, HugePage);
+    if (void* addr = map(size, MAP_HUGETLB); addr != nullptr) {
+        if (backing != nullptr) { *backing = backing_t::HugeTLB; }
+        return addr;
+    }
+    uint8_t* raw = static_cast<uint8_t*>(map(size + HugePage, 0));
+    if (raw == nullptr) { return nullptr; }
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(raw);
+    uint8_t* addr         = raw + (HugePage - begin % HugePage) % HugePage;
+    if (addr != raw) { ::munmap(raw, static_cast<std::size_t>(addr - raw)); }
+    if (addr != raw + HugePage) { ::munmap(addr + size, static_cast<std::size_t>(raw + HugePage - addr)); }
+    ::madvise(addr, size, MADV_HUGEPAGE);
+    if (backing != nullptr) { *backing = backing_t::THP; }
+    return addr;
+}
+
+void deallocate(void* ptr, const std::size_t bytes, const page_t page)
+{
+    if (ptr == nullptr) { return; }
+    ::munmap(ptr, round_up(bytes, page == page_t::Small ? SmallPage : HugePage));
+}
+
+}  // namespace page_alloc
@@ -0,0 +1,64 @@
+#pragma once
+/**
+ * @file page_alloc.hpp
+ * @brief ページサイズ(4K/2M)を選べるメモリ確保
+ * @note
+ * - 大きな配列をランダムに辿るとき、4Kページだと深い段でほぼ毎回dTLBミスする
+ * - Huge: MAP_HUGETLB(予約済みの2Mページ)を試し、無ければ2M境界に置いてMADV_HUGEPAGE(THP)を指定する
+ * - Small: MADV_NOHUGEPAGEを指定して4Kページに固定する (THPがalwaysでも比較できるように)
+ * - 先頭はページ境界 (64byte境界でもある)
+ * - 失敗はnullptrで返す
+ */
+#include <cstddef>
+
+namespace page_alloc {
+
+constexpr std::size_t SmallPage = std::size_t{1} << 12;
+constexpr std::size_t HugePage  = std::size_t{1} << 21;
+
+enum class page_t
+{
+    Small,
+    Huge,
+};
+
+/**
+ * @brief 実際に使われた確保方法
+ */
+enum class backing_t
+{
+    Small,    // 4Kページ
+    HugeTLB,  // MAP_HUGETLB
+    THP,      // MADV_HUGEPAGE (カーネルが2Mページにするかは保証されない)
+};
+
+/**
+ * @brief 確保
+ * @param bytes[in] バイト数 (ページサイズの倍数に切り上げる)
+ * @param page[in] ページサイズ
+ * @param backing[out] 実際に使われた確保方法 (nullptrなら返さない)
+ * @return 先頭 (失敗したらnullptr)
+ */
+void* allocate(const std::size_t bytes, const page_t page, backing_t* backing = nullptr);
+
+/**
+ * @brief 解放
+ * @param ptr[in] allocate()の返り値 (nullptrなら何もしない)
+ * @param bytes[in] allocate()に渡したバイト数
+ * @param page[in] allocate()に渡したページサイズ
+ */
+void deallocate(void* ptr, const std::size_t bytes, const page_t page);
+
+template<typename T>
+T* allocate_array(const std::size_t count, const page_t page, backing_t* backing = nullptr)
+{
+    return static_cast<T*>(allocate(count * sizeof(T), page, backing));
+}
+
+template<typename T>
+void deallocate_array(T* ptr, const std::size_t count, const page_t page)
+{
+    deallocate(ptr, count * sizeof(T), page);
+}
+
+}  // namespace page_alloc
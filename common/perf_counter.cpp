@@ -0,0 +1,51 @@
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "perf_counter.hpp"
+
+namespace {
+
+uint64_t hw_cache_config(const uint64_t cache, const uint64_t op, const uint64_t result)
+{
+    return cache | (op << 8) | (result << 16);
+}
+
+}  // anonymous namespace
+
+perf_counter::perf_counter(const event_t event)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.type           = PERF_TYPE_HW_CACHE;
+    attr.config         = event == DTLBLoadMiss ? hw_cache_config(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)
+                                                : hw_cache_config(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS);
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    m_fd                = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+perf_counter::~perf_counter()
+{
+    if (m_fd >= 0) { ::close(m_fd); }
+}
+
+void perf_counter::start()
+{
+    if (m_fd < 0) { return; }
+    ::ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+    ::ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+uint64_t perf_counter::stop()
+{
+    if (m_fd < 0) { return 0; }
+    ::ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+    uint64_t count = 0;
+    if (::read(m_fd, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count))) { return 0; }
+    return count;
+}
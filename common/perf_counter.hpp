@@ -0,0 +1,50 @@
+#pragma once
+/**
+ * @file perf_counter.hpp
+ * @brief perf_event_openによるハードウェアカウンタ
+ * @note
+ * - 呼び出したスレッドのユーザー空間だけを数える
+ * - 権限が無い・仮想環境などで使えないときはavailable()がfalseになり、stop()は常に0を返す
+ */
+#include <cstdint>
+
+/**
+ * @brief ハードウェアカウンタ
+ */
+class perf_counter
+{
+public:
+    /**
+     * @brief 数えるイベント
+     * - DTLBLoadMiss: 読み込みのdTLBミス
+     * - LLCLoadMiss: 読み込みの最終段キャッシュミス
+     */
+    enum event_t
+    {
+        DTLBLoadMiss,
+        LLCLoadMiss,
+    };
+
+    explicit perf_counter(const event_t event);
+    perf_counter(const perf_counter&) = delete;
+    perf_counter& operator=(const perf_counter&) = delete;
+    ~perf_counter();
+
+    /**
+     * @brief 使えるかどうか
+     */
+    bool available() const { return m_fd >= 0; }
+
+    /**
+     * @brief 0から数え始める
+     */
+    void start();
+
+    /**
+     * @brief 止めてstart()からの回数を返す
+     */
+    uint64_t stop();
+
+private:
+    int m_fd = -1;
+};
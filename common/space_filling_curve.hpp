@@ -0,0 +1,179 @@
+#pragma once
+/**
+ * @file space_filling_curve.hpp
+ * @brief 空間充填曲線(Z-order / Hilbert order)の添字計算
+ * @note
+ * - 2次元の添字(i,j)を1次元の添字に変換する
+ * - BMI2が使える場合はPDEP/PEXTで計算する
+ */
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#ifdef __BMI2__
+#    include <immintrin.h>
+#endif
+
+namespace sfc_detail {
+
+constexpr uint64_t EvenMask = 0x5555555555555555ULL;
+constexpr uint64_t OddMask  = 0xAAAAAAAAAAAAAAAAULL;
+
+/**
+ * @brief xの各bitの間に0を挟む (b31...b0 -> 0b31...0b0)
+ */
+constexpr uint64_t spread(uint64_t x)
+{
+    x &= 0x00000000FFFFFFFFULL;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    x = (x | (x << 2)) & 0x3333333333333333ULL;
+    x = (x | (x << 1)) & 0x5555555555555555ULL;
+    return x;
+}
+
+/**
+ * @brief spreadの逆変換 (偶数bitだけを詰める)
+ */
+constexpr uint64_t compact(uint64_t x)
+{
+    x &= 0x5555555555555555ULL;
+    x = (x | (x >> 1)) & 0x3333333333333333ULL;
+    x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+    x = (x | (x >> 4)) & 0x00FF00FF00FF00FFULL;
+    x = (x | (x >> 8)) & 0x0000FFFF0000FFFFULL;
+    x = (x | (x >> 16)) & 0x00000000FFFFFFFFULL;
+    return x;
+}
+
+}  // namespace sfc_detail
+
+/**
+ * @brief Morton符号 (Z-order)
+ * @param i[in] 行番号 (奇数bitに入る)
+ * @param j[in] 列番号 (偶数bitに入る)
+ * @details 同じ行で隣り合う2マスが隣接するように、列番号を下位bitに置く
+ */
+inline uint64_t morton_encode(const uint64_t i, const uint64_t j)
+{
+#ifdef __BMI2__
+    return _pdep_u64(i, sfc_detail::OddMask) | _pdep_u64(j, sfc_detail::EvenMask);
+#else
+    return (sfc_detail::spread(i) << 1) | sfc_detail::spread(j);
+#endif
+}
+
+/**
+ * @brief Morton符号から(i,j)を復元
+ * @param z[in] Morton符号
+ */
+inline std::pair<uint64_t, uint64_t> morton_decode(const uint64_t z)
+{
+#ifdef __BMI2__
+    return {_pext_u64(z, sfc_detail::OddMask), _pext_u64(z, sfc_detail::EvenMask)};
+#else
+    return {sfc_detail::compact(z >> 1), sfc_detail::compact(z)};
+#endif
+}
+
+/**
+ * @brief 列方向に1つ進んだMorton符号
+ * @param z[in] Morton符号
+ * @details 偶数bitだけで+1する (復号->符号化をしなくて済む)
+ */
+constexpr uint64_t morton_next_col(const uint64_t z)
+{
+    return (((z | sfc_detail::OddMask) + 1) & sfc_detail::EvenMask) | (z & sfc_detail::OddMask);
+}
+
+/**
+ * @brief 行方向に1つ進んだMorton符号
+ * @param z[in] Morton符号
+ */
+constexpr uint64_t morton_next_row(const uint64_t z)
+{
+    return (((z | sfc_detail::EvenMask) + 1) & sfc_detail::OddMask) | (z & sfc_detail::EvenMask);
+}
+
+namespace sfc_detail {
+
+/**
+ * @brief Hilbert曲線の状態遷移表
+ * @details
+ * - 状態は下位bitに掛かる変換(転置sw/両軸反転fl)の2bit (2つの変換は可換)
+ * - 4bitずつまとめて処理する
+ *   encode: [状態(2bit)|i(4bit)|j(4bit)] -> [次の状態(2bit)|d(8bit)]
+ *   decode: [状態(2bit)|d(8bit)] -> [次の状態(2bit)|i(4bit)|j(4bit)]
+ */
+struct hilbert_table
+{
+    constexpr hilbert_table() : encode{}, decode{}
+    {
+        for (uint32_t state = 0; state < 4; state++) {
+            for (uint32_t ij = 0; ij < 256; ij++) {
+                uint32_t sw = state >> 1, fl = state & 1, d = 0;
+                for (uint32_t s = 4; s-- > 0;) {
+                    uint32_t ri      = ((ij >> (s + 4)) & 1) ^ fl;
+                    uint32_t rj      = ((ij >> s) & 1) ^ fl;
+                    const uint32_t t = sw & (ri ^ rj);
+                    ri ^= t, rj ^= t;
+                    d = (d << 2) | ((3 * rj) ^ ri);
+                    sw ^= ri ^ 1, fl ^= (ri ^ 1) & rj;
+                }
+                encode[(state << 8) | ij] = static_cast<uint16_t>((((sw << 1) | fl) << 8) | d);
+                decode[(state << 8) | d]  = static_cast<uint16_t>((((sw << 1) | fl) << 8) | ij);
+            }
+        }
+    }
+    uint16_t encode[1024];
+    uint16_t decode[1024];
+};
+
+constexpr hilbert_table HilbertTable{};
+
+}  // namespace sfc_detail
+
+/**
+ * @brief Hilbert順序での添字
+ * @param lg_side[in] 一辺の長さの対数 (一辺は2^lg_side)
+ * @param i[in] 行番号
+ * @param j[in] 列番号
+ * @details
+ * - 上位bitから4bitずつ表引きする
+ * - lg_sideを4の倍数に切り上げて上位に0を足す (0の段1つごとに転置されるので、奇数段足すときは転置状態から始める)
+ */
+inline uint64_t hilbert_encode(const std::size_t lg_side, const uint64_t i, const uint64_t j)
+{
+    const std::size_t lg = (lg_side + 3) & ~std::size_t{3};
+    uint64_t d           = 0;
+    uint64_t state       = ((lg - lg_side) & 1) << 1;
+    for (std::size_t s = lg; s > 0;) {
+        s -= 4;
+        const uint64_t ij = (((i >> s) & 0xF) << 4) | ((j >> s) & 0xF);
+        const uint64_t e  = sfc_detail::HilbertTable.encode[(state << 8) | ij];
+        d                 = (d << 8) | (e & 0xFF);
+        state             = e >> 8;
+    }
+    return d;
+}
+
+/**
+ * @brief Hilbert順序での添字から(i,j)を復元
+ * @param lg_side[in] 一辺の長さの対数 (一辺は2^lg_side)
+ * @param d[in] Hilbert順序での添字
+ */
+inline std::pair<uint64_t, uint64_t> hilbert_decode(const std::size_t lg_side, const uint64_t d)
+{
+    const std::size_t lg = (lg_side + 3) & ~std::size_t{3};
+    uint64_t i           = 0;
+    uint64_t j           = 0;
+    uint64_t state       = ((lg - lg_side) & 1) << 1;
+    for (std::size_t s = lg; s > 0;) {
+        s -= 4;
+        const uint64_t e = sfc_detail::HilbertTable.decode[(state << 8) | ((d >> (2 * s)) & 0xFF)];
+        i                = (i << 4) | ((e >> 4) & 0xF);
+        j                = (j << 4) | (e & 0xF);
+        state            = e >> 8;
+    }
+    return {i, j};
+}
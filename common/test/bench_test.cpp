@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "common/bench.hpp"
+
+namespace {
+
+const std::string csv_path  = ::testing::TempDir() + "bench_test.csv";
+const std::string json_path = ::testing::TempDir() + "bench_test.json";
+
+std::string read_all(const std::string& path)
+{
+    std::ifstream is{path};
+    std::stringstream ss;
+    ss << is.rdbuf();
+    return ss.str();
+}
+
+}  // anonymous namespace
+
+TEST(BenchTest, ParseSize)
+{
+    std::size_t x;
+    ASSERT_TRUE(bench::parse_size("123", x));
+    ASSERT_EQ(123U, x);
+    ASSERT_TRUE(bench::parse_size("2^20", x));
+    ASSERT_EQ(1U << 20, x);
+    ASSERT_TRUE(bench::parse_size("2^24+64", x));
+    ASSERT_EQ((1U << 24) + 64, x);
+    ASSERT_TRUE(bench::parse_size("2^10-1", x));
+    ASSERT_EQ(1023U, x);
+    for (const char* s : {"", "-1", "abc", "12x", "2^", "2^64", "2^3*2", "2^3-9"}) { ASSERT_FALSE(bench::parse_size(s, x)) << s; }
+
+    std::vector<std::size_t> xs{1};
+    ASSERT_TRUE(bench::parse_sizes("3,2^2,5", xs));
+    ASSERT_EQ((std::vector<std::size_t>{3, 4, 5}), xs);
+    ASSERT_FALSE(bench::parse_sizes("3,,5", xs));
+    ASSERT_EQ((std::vector<std::size_t>{3, 4, 5}), xs);
+}
+
+TEST(BenchTest, Parse)
+{
+    const char* args[] = {"bench", "--n=2^10,100", "--dist=uniform,dense", "--threads=1,4", "--trials=5", "--csv=out.csv", "--layout=path"};
+    bench::options_t opts;
+    opts.qs = {7};
+    std::string err;
+    ASSERT_TRUE(bench::parse(7, const_cast<char**>(args), opts, {"layout"}, err)) << err;
+    ASSERT_EQ((std::vector<std::size_t>{1024, 100}), opts.ns);
+    ASSERT_EQ((std::vector<std::size_t>{7}), opts.qs);  // 指定されなければそのまま
+    ASSERT_EQ((std::vector<std::string>{"uniform", "dense"}), opts.dists);
+    ASSERT_EQ((std::vector<std::size_t>{1, 4}), opts.threads);
+    ASSERT_EQ(5U, opts.trials);
+    ASSERT_EQ("out.csv", opts.csv);
+    ASSERT_EQ("path", opts.extra["layout"]);
+
+    for (const char* bad : {"--n=", "--n=x", "--dist=normal", "--threads=0", "--trials=0", "-n=3", "--n", "--layuot=path"}) {
+        const char* bad_args[] = {"bench", bad};
+        ASSERT_FALSE(bench::parse(2, const_cast<char**>(bad_args), opts, {"layout"}, err)) << bad;
+    }
+}
+
+TEST(BenchTest, Summarize)
+{
+    const auto s = bench::summarize({4.0, 1.0, 3.0, 2.0});
+    ASSERT_DOUBLE_EQ(2.5, s.median);
+    ASSERT_DOUBLE_EQ(2.5, s.mean);
+    ASSERT_DOUBLE_EQ(std::sqrt(5.0 / 3.0), s.stddev);
+    ASSERT_DOUBLE_EQ(1.0, s.min);
+    ASSERT_DOUBLE_EQ(4.0, s.max);
+    const auto one = bench::summarize({7.0});
+    ASSERT_DOUBLE_EQ(7.0, one.median);
+    ASSERT_DOUBLE_EQ(0.0, one.stddev);
+}
+
+TEST(BenchTest, Generate)
+{
+    for (const std::string dist : {"uniform", "skewed", "dense"}) {
+        const auto xs = bench::generate<uint32_t>(dist, 1000, 10, 100000, 1);
+        ASSERT_EQ(1000U, xs.size());
+        ASSERT_TRUE(std::all_of(xs.begin(), xs.end(), [](const uint32_t x) { return 10 <= x and x <= 100000; })) << dist;
+        ASSERT_EQ(xs, (bench::generate<uint32_t>(dist, 1000, 10, 100000, 1))) << dist;  // 同じシードなら同じ列
+    }
+    const auto ds = bench::generate<uint32_t>("dense", 1000, 10, 100000, 1);
+    ASSERT_TRUE(std::is_sorted(ds.begin(), ds.end()));
+    ASSERT_LE(ds.back(), 10U + 3 * 999);
+    const auto ss = bench::generate<uint32_t>("skewed", 1000, 0, 100000, 1);
+    ASSERT_GT(std::count_if(ss.begin(), ss.end(), [](const uint32_t x) { return x < 25000; }), 400);  // 約半分が下1/4に入る
+    const auto clamp = bench::generate<uint32_t>("dense", 100, 0, 50, 1);
+    ASSERT_EQ(50U, clamp.back());
+    ASSERT_THROW(bench::generate<uint32_t>("normal", 10, 0, 10, 1), std::invalid_argument);
+
+    const auto qs = bench::generate_queries<uint32_t>("dense", 1000, 10, 100000, ds.back(), 2);
+    ASSERT_TRUE(std::all_of(qs.begin(), qs.end(), [&](const uint32_t x) { return 10 <= x and x <= ds.back(); }));
+    ASSERT_GT(*std::max_element(qs.begin(), qs.end()), ds[500]);  // データの範囲全体から取る
+    ASSERT_EQ((bench::generate<uint32_t>("skewed", 10, 0, 100, 2)), (bench::generate_queries<uint32_t>("skewed", 10, 0, 100, 50, 2)));
+}
+
+TEST(BenchTest, Registry)
+{
+    bench::registry reg;
+    std::size_t builds = 0, fins = 0, calls = 0;
+    reg.add("Count, Twice", [&](const bench::params_t& p) -> bench::trial_t {
+        builds++;
+        return [&calls, p] {
+            calls++;
+            return bench::metrics_t{{"value", static_cast<double>(p.n * 2)}, {"call", static_cast<double>(calls)}};
+        };
+    }, [&] { fins++; });
+    reg.add("Skip", [](const bench::params_t& p) -> bench::trial_t {
+        if (p.n == 10) { return nullptr; }
+        return [] { return bench::metrics_t{{"value", 1.0}}; };
+    });
+
+    bench::options_t opts;
+    opts.ns      = {10, 20};
+    opts.threads = {1, 2};
+    opts.warmup  = 1;
+    opts.trials  = 3;
+    std::ostringstream log;
+    const auto results = reg.measure(opts, log);
+    ASSERT_EQ(4U, builds);
+    ASSERT_EQ(4U, fins);
+    ASSERT_EQ(16U, calls);
+    ASSERT_EQ(6U, results.size());  // Skipは2つ飛ばす
+    ASSERT_NE(std::string::npos, log.str().find("Skipped."));
+
+    // データを作り直さないようにNが外側
+    ASSERT_EQ("Count, Twice", results[0].name);
+    ASSERT_EQ(10U, results[0].params.n);
+    ASSERT_EQ(1U, results[0].params.threads);
+    ASSERT_EQ(2U, results[1].params.threads);
+    ASSERT_EQ("Count, Twice", results[2].name);
+    ASSERT_EQ(20U, results[2].params.n);
+    ASSERT_EQ("Skip", results[4].name);
+
+    const auto stats = results[0].stats();
+    ASSERT_EQ(2U, stats.size());
+    ASSERT_EQ("value", stats[0].first);
+    ASSERT_DOUBLE_EQ(20.0, stats[0].second.median);
+    ASSERT_DOUBLE_EQ(0.0, stats[0].second.stddev);
+    ASSERT_EQ("call", stats[1].first);
+    ASSERT_DOUBLE_EQ(3.0, stats[1].second.median);  // warmupの1回目は捨てる
+    ASSERT_DOUBLE_EQ(2.0, stats[1].second.min);
+
+    opts.filter = "Skip";
+    ASSERT_EQ(2U, reg.measure(opts, log).size());
+}
+
+TEST(BenchTest, Write)
+{
+    bench::result_t r{"A, \"B\"", bench::params_t{100, 10, 64, 1024, 2, "dense"}, {{{"miss", 1.0}}, {{"miss", 3.0}}}};
+    ASSERT_TRUE(bench::write_csv(csv_path, "v1", {r}));
+    const auto csv = read_all(csv_path);
+    ASSERT_EQ("tag,name,n,q,b,m,dist,threads,metric,trials,median,mean,stddev,min,max\n"
+              "v1,\"A, \"\"B\"\"\",100,10,64,1024,dense,2,miss,2,2,2,1.41421356237,1,3\n",
+              csv);
+    ASSERT_TRUE(bench::write_json(json_path, "v1", {r}));
+    const auto json = read_all(json_path);
+    ASSERT_NE(std::string::npos, json.find("\"name\": \"A, \\\"B\\\"\""));
+    ASSERT_NE(std::string::npos, json.find("\"miss\": {\"median\": 2, \"mean\": 2, \"stddev\": 1.41421356237, \"min\": 1, \"max\": 3}"));
+    ASSERT_FALSE(bench::write_csv("/nonexistent/dir/out.csv", "", {r}));
+    std::remove(csv_path.c_str());
+    std::remove(json_path.c_str());
+}
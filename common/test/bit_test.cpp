@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+
+#include "common/bit.hpp"
+
+TEST(BitTest, Log)
+{
+    EXPECT_EQ(0UL, lg(1));
+    EXPECT_EQ(1UL, lg(2));
+    EXPECT_EQ(1UL, lg(3));
+    EXPECT_EQ(24UL, lg((1UL << 24) + 64));
+    EXPECT_EQ(40UL, lg(1UL << 40));
+    EXPECT_EQ(0UL, clg(1));
+    EXPECT_EQ(1UL, clg(2));
+    EXPECT_EQ(2UL, clg(3));
+    EXPECT_EQ(2UL, clg(4));
+    EXPECT_EQ(25UL, clg((1UL << 24) + 65));
+}
+
+TEST(BitTest, Pow2)
+{
+    EXPECT_EQ(1UL, ceil2(1));
+    EXPECT_EQ(4UL, ceil2(3));
+    EXPECT_EQ(4UL, ceil2(4));
+    EXPECT_EQ(1UL << 25, ceil2((1UL << 24) + 65));
+    EXPECT_EQ(1UL << 24, floor2((1UL << 24) + 65));
+    EXPECT_EQ(1UL << 40, floor2(1UL << 40));
+}
+
+TEST(BitTest, Lsb)
+{
+    EXPECT_EQ(0UL, lsb(1));
+    EXPECT_EQ(3UL, lsb(24));
+    EXPECT_EQ(40UL, lsb(1UL << 40));
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "common/hot_swap.hpp"
+
+namespace {
+
+std::atomic<int> alive{0};
+
+/**
+ * 中身が全部versionと一致しているか読み手が確かめる
+ */
+struct item_t
+{
+    explicit item_t(const int version_) : version{version_}, values(1000, version_) { alive++; }
+    ~item_t()
+    {
+        std::fill(values.begin(), values.end(), -1);
+        alive--;
+    }
+    int version;
+    std::vector<int> values;
+};
+
+}  // anonymous namespace
+
+TEST(HotSwapTest, EpochDomain)
+{
+    epoch_domain domain{2};
+    domain.enter(0);
+    const uint64_t e = domain.advance();
+    ASSERT_FALSE(domain.quiescent(e));
+    domain.enter(1);  // 進めた後に入った読み手は待たなくてよい
+    domain.leave(0);
+    ASSERT_TRUE(domain.quiescent(e));
+    ASSERT_FALSE(domain.quiescent(domain.advance()));
+    domain.leave(1);
+    domain.wait(domain.advance());
+}
+
+TEST(HotSwapTest, Publish)
+{
+    {
+        hot_swap<item_t> swap{2, std::make_unique<item_t>(0)};
+        {
+            const auto guard = swap.read(0);
+            swap.publish(std::make_unique<item_t>(1));
+            ASSERT_EQ(1UL, swap.retired_num());  // 読み手0が古いものを掴んでいる
+            ASSERT_EQ(0, guard->version);
+            ASSERT_EQ(0, guard->values.back());
+            ASSERT_EQ(1, swap.read(1)->version);
+        }
+        swap.publish(std::make_unique<item_t>(2));
+        ASSERT_EQ(0UL, swap.retired_num());
+        ASSERT_EQ(1, alive.load());
+        ASSERT_EQ(2, swap.read(0)->version);
+    }
+    ASSERT_EQ(0, alive.load());
+}
+
+TEST(HotSwapTest, Concurrent)
+{
+    constexpr std::size_t Readers = 3;
+    constexpr int Versions        = 200;
+    {
+        hot_swap<item_t> swap{Readers, std::make_unique<item_t>(0)};
+        std::atomic<bool> done{false};
+        std::atomic<bool> ok{true};
+        std::vector<std::thread> ths;
+        for (std::size_t r = 0; r < Readers; r++) {
+            ths.emplace_back([&, r] {
+                int last = 0;
+                while (not done.load()) {
+                    const auto guard = swap.read(r);
+                    const int v      = guard->version;
+                    for (const int x : guard->values) { ok = ok and x == v; }
+                    ok   = ok and last <= v;  // 差し替えた後に古いものは見えない
+                    last = v;
+                }
+            });
+        }
+        for (int v = 1; v <= Versions; v++) {
+            auto th = swap.rebuild([v] { return std::make_unique<item_t>(v); });
+            th.join();
+        }
+        done = true;
+        for (auto& th : ths) { th.join(); }
+        swap.synchronize();
+        ASSERT_TRUE(ok.load());
+        ASSERT_EQ(0UL, swap.retired_num());
+        ASSERT_EQ(1, alive.load());
+    }
+    ASSERT_EQ(0, alive.load());
+}
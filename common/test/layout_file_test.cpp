@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+
+#include "common/layout_file.hpp"
+
+namespace {
+
+const std::string path = ::testing::TempDir() + "layout_file_test.bin";
+
+struct alignas(64) node_t
+{
+    uint32_t keys[16];
+};
+
+}  // anonymous namespace
+
+TEST(LayoutFileTest, WriteRead)
+{
+    std::vector<uint32_t> xs{1, 3, 5, 7, 9};
+    std::vector<std::size_t> ls{1, 2, 3};
+    std::vector<node_t> nodes(3);
+    for (std::size_t i = 0; i < 3; i++) {
+        for (uint32_t j = 0; j < 16; j++) { nodes[i].keys[j] = static_cast<uint32_t>(i * 16 + j); }
+    }
+    layout_writer writer{layout_file::key_kind_of<uint32_t>(), 20201013};
+    ASSERT_TRUE(writer.add("xs", xs.data(), xs.size()));
+    ASSERT_TRUE(writer.add("ls", ls.data(), ls.size()));
+    ASSERT_TRUE(writer.add("empty", xs.data(), 0));
+    ASSERT_TRUE(writer.add("nodes", nodes.data(), nodes.size()));
+    ASSERT_FALSE(writer.add("xs", xs.data(), xs.size()));  // 名前の重複
+    ASSERT_TRUE(writer.write(path));
+
+    for (const unsigned flags : {0U, layout_reader::Populate | layout_reader::HugePage | layout_reader::Verify}) {
+        layout_reader reader;
+        ASSERT_TRUE(reader.open(path, layout_file::key_kind::UInt32, flags));
+        ASSERT_EQ(sizeof(uint32_t), reader.key_size());
+        ASSERT_EQ(20201013UL, reader.data_seed());
+        std::size_t count;
+        const uint32_t* rxs = reader.get<uint32_t>("xs", count);
+        ASSERT_NE(nullptr, rxs);
+        ASSERT_EQ(xs, std::vector<uint32_t>(rxs, rxs + count));
+        const std::size_t* rls = reader.get<std::size_t>("ls", count);
+        ASSERT_NE(nullptr, rls);
+        ASSERT_EQ(ls, std::vector<std::size_t>(rls, rls + count));
+        ASSERT_NE(nullptr, reader.get<uint32_t>("empty", count));
+        ASSERT_EQ(0UL, count);
+        const node_t* rnodes = reader.get<node_t>("nodes", count);
+        ASSERT_NE(nullptr, rnodes);
+        ASSERT_EQ(0UL, reinterpret_cast<uintptr_t>(rnodes) % layout_file::Align);
+        ASSERT_EQ(3UL, count);
+        ASSERT_EQ(47U, rnodes[2].keys[15]);
+        ASSERT_EQ(nullptr, reader.get<uint64_t>("xs", count));  // 要素のサイズが違う
+        ASSERT_EQ(nullptr, reader.get<uint32_t>("ys", count));  // 無い
+    }
+    layout_reader reader;
+    for (const auto kind : {layout_file::key_kind::Int32, layout_file::key_kind::Float, layout_file::key_kind::UInt64}) {
+        ASSERT_FALSE(reader.open(path, kind));  // キーの型が違う
+    }
+    std::remove(path.c_str());
+}
+
+TEST(LayoutFileTest, Broken)
+{
+    layout_reader reader;
+    ASSERT_FALSE(reader.open(path + ".none", layout_file::key_kind::UInt32));
+
+    std::vector<uint32_t> xs(1000);
+    for (std::size_t i = 0; i < xs.size(); i++) { xs[i] = static_cast<uint32_t>(i * i); }
+    layout_writer writer{layout_file::key_kind_of<uint32_t>()};
+    ASSERT_TRUE(writer.add("xs", xs.data(), xs.size()));
+    ASSERT_TRUE(writer.write(path));
+    {
+        std::fstream fs{path, std::ios::in | std::ios::out | std::ios::binary};  // 中身を1byte壊す
+        fs.seekp(1000);
+        fs.put('\x7f');
+    }
+    ASSERT_TRUE(reader.open(path, layout_file::key_kind::UInt32));  // チェックサムは見ない
+    ASSERT_FALSE(reader.open(path, layout_file::key_kind::UInt32, layout_reader::Verify));
+    {
+        std::fstream fs{path, std::ios::in | std::ios::out | std::ios::binary};  // マジックを壊す
+        fs.seekp(0);
+        fs.put('X');
+    }
+    ASSERT_FALSE(reader.open(path, layout_file::key_kind::UInt32));
+    {
+        std::ofstream ofs{path, std::ios::binary | std::ios::trunc};  // 短すぎる
+        ofs << "COLAYOUT";
+    }
+    ASSERT_FALSE(reader.open(path, layout_file::key_kind::UInt32));
+    std::remove(path.c_str());
+}
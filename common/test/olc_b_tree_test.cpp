@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "common/olc_b_tree.hpp"
+#include "common/rng.hpp"
+
+namespace {
+
+using tree_t = olc::tree<uint32_t, 128>;  // 頂点を小さくして分割を多く起こす
+
+}  // anonymous namespace
+
+TEST(OlcBTreeTest, Sequential)
+{
+    rng_base rng{20201013};
+    tree_t tree;
+    std::set<uint32_t> set;
+    ASSERT_EQ(tree_t::Inf, tree.lower_bound(0));
+    for (std::size_t i = 0; i < 100000; i++) {
+        const uint32_t x = rng.val<uint32_t>(0, 1000000);
+        ASSERT_EQ(set.insert(x).second, tree.insert(x));  // 既にあればfalse
+    }
+    for (std::size_t i = 0; i < 100000; i++) {
+        const uint32_t x = rng.val<uint32_t>(0, 1001000);
+        const auto it    = set.lower_bound(x);
+        ASSERT_EQ(it == set.end() ? tree_t::Inf : *it, tree.lower_bound(x));
+    }
+}
+
+/**
+ * 書き手が偶数のキーを入れている間、読み手は入れ終わったキーが見つかるか確かめる
+ * - 書き手wはキーi*Writers+w (の2倍+2) を乱順に入れ、入れた個数をpublishedに書く
+ * - 奇数のキーは入らないので、x-1のlower_boundもxになる
+ */
+TEST(OlcBTreeTest, Concurrent)
+{
+    constexpr std::size_t Writers = 4;
+    constexpr std::size_t Readers = 2;
+    constexpr std::size_t PerW    = 50000;
+    tree_t tree;
+    std::vector<std::vector<uint32_t>> keys(Writers);
+    rng_base rng{20201013};
+    for (std::size_t w = 0; w < Writers; w++) {
+        for (std::size_t i = 0; i < PerW; i++) { keys[w].push_back(static_cast<uint32_t>((i * Writers + w) * 2 + 2)); }
+        for (std::size_t i = PerW - 1; i > 0; i--) { std::swap(keys[w][i], keys[w][rng.val<std::size_t>(0, i)]); }
+    }
+    std::vector<std::atomic<std::size_t>> published(Writers);
+    std::atomic<std::size_t> writing{Writers};
+    std::atomic<bool> ok{true};
+    std::vector<std::thread> ths;
+    for (std::size_t w = 0; w < Writers; w++) {
+        ths.emplace_back([&, w] {
+            for (std::size_t i = 0; i < PerW; i++) {
+                ok = ok and tree.insert(keys[w][i]);
+                published[w].store(i + 1, std::memory_order_release);
+            }
+            writing--;
+        });
+    }
+    for (std::size_t r = 0; r < Readers; r++) {
+        ths.emplace_back([&, r] {
+            rng_base rrng{r};
+            while (writing.load() != 0) {
+                const std::size_t w = rrng.val<std::size_t>(0, Writers - 1);
+                const std::size_t n = published[w].load(std::memory_order_acquire);
+                if (n == 0) { continue; }
+                const uint32_t x = keys[w][rrng.val<std::size_t>(0, n - 1)];
+                ok               = ok and tree.lower_bound(x) == x and tree.lower_bound(x - 1) == x;
+            }
+        });
+    }
+    for (auto& th : ths) { th.join(); }
+    ASSERT_TRUE(ok.load());
+    for (uint32_t x = 2; x <= Writers * PerW * 2; x += 2) {
+        ASSERT_EQ(x, tree.lower_bound(x));
+        ASSERT_EQ(x, tree.lower_bound(x - 1));
+        ASSERT_FALSE(tree.insert(x));
+    }
+    ASSERT_EQ(tree_t::Inf, tree.lower_bound(Writers * PerW * 2 + 1));
+}
+
+/**
+ * 先に入れたキーだけを読み手が探す間、書き手が間のキーを入れて分割を起こし続ける
+ * - 先に入れるキーは4i、書き手が入れるキーは4i+2なので、4iのlower_boundは常に4i、4i-1のlower_boundも4i
+ * - 子を読む前後で親が分割されたのに気づかないと、葉の右隣の先頭 (kより小さいキー) を返してしまう
+ */
+TEST(OlcBTreeTest, ConcurrentSplit)
+{
+    constexpr std::size_t Writers = 4;
+    constexpr std::size_t Readers = 4;
+    constexpr std::size_t Pre     = 100000;
+    tree_t tree;
+    for (std::size_t i = 1; i <= Pre; i++) { ASSERT_TRUE(tree.insert(static_cast<uint32_t>(i * 4))); }
+    std::vector<uint32_t> keys;
+    for (std::size_t i = 0; i < Pre; i++) { keys.push_back(static_cast<uint32_t>(i * 4 + 2)); }
+    rng_base rng{20201013};
+    for (std::size_t i = Pre - 1; i > 0; i--) { std::swap(keys[i], keys[rng.val<std::size_t>(0, i)]); }
+    std::atomic<std::size_t> writing{Writers};
+    std::atomic<bool> ok{true};
+    std::vector<std::thread> ths;
+    for (std::size_t w = 0; w < Writers; w++) {
+        ths.emplace_back([&, w] {
+            for (std::size_t i = w; i < Pre; i += Writers) { ok = ok and tree.insert(keys[i]); }
+            writing--;
+        });
+    }
+    for (std::size_t r = 0; r < Readers; r++) {
+        ths.emplace_back([&, r] {
+            rng_base rrng{r};
+            while (writing.load() != 0) {
+                const uint32_t x = static_cast<uint32_t>(rrng.val<std::size_t>(1, Pre) * 4);
+                ok               = ok and tree.lower_bound(x) == x and tree.lower_bound(x - 1) == x;
+            }
+        });
+    }
+    for (auto& th : ths) { th.join(); }
+    ASSERT_TRUE(ok.load());
+    for (uint32_t x = 2; x <= Pre * 4; x += 2) { ASSERT_EQ(x, tree.lower_bound(x - 1)); }
+}
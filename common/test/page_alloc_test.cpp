@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "common/page_alloc.hpp"
+
+TEST(PageAllocTest, Small)
+{
+    constexpr std::size_t Count = 10000;
+    page_alloc::backing_t backing;
+    uint32_t* xs = page_alloc::allocate_array<uint32_t>(Count, page_alloc::page_t::Small, &backing);
+    ASSERT_NE(nullptr, xs);
+    ASSERT_EQ(page_alloc::backing_t::Small, backing);
+    ASSERT_EQ(0UL, reinterpret_cast<uintptr_t>(xs) % page_alloc::SmallPage);
+    for (std::size_t i = 0; i < Count; i++) { xs[i] = static_cast<uint32_t>(i * i); }
+    for (std::size_t i = 0; i < Count; i++) { ASSERT_EQ(static_cast<uint32_t>(i * i), xs[i]); }
+    page_alloc::deallocate_array(xs, Count, page_alloc::page_t::Small);
+}
+
+TEST(PageAllocTest, Huge)
+{
+    // 2Mページの境界をまたぐサイズ
+    constexpr std::size_t Count = (page_alloc::HugePage * 3 / 2) / sizeof(uint64_t);
+    page_alloc::backing_t backing;
+    uint64_t* xs = page_alloc::allocate_array<uint64_t>(Count, page_alloc::page_t::Huge, &backing);
+    ASSERT_NE(nullptr, xs);
+    ASSERT_NE(page_alloc::backing_t::Small, backing);
+    ASSERT_EQ(0UL, reinterpret_cast<uintptr_t>(xs) % page_alloc::HugePage);
+    for (std::size_t i = 0; i < Count; i++) { xs[i] = i; }
+    for (std::size_t i = 0; i < Count; i++) { ASSERT_EQ(i, xs[i]); }
+    page_alloc::deallocate_array(xs, Count, page_alloc::page_t::Huge);
+}
+
+TEST(PageAllocTest, Empty)
+{
+    for (const auto page : {page_alloc::page_t::Small, page_alloc::page_t::Huge}) {
+        void* ptr = page_alloc::allocate(0, page);
+        ASSERT_NE(nullptr, ptr);
+        page_alloc::deallocate(ptr, 0, page);
+    }
+    page_alloc::deallocate(nullptr, 0, page_alloc::page_t::Small);
+}
@@ -0,0 +1,20 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "common/perf_counter.hpp"
+
+TEST(PerfCounterTest, StartStop)
+{
+    // 使えない環境でもstart/stopは呼べて、0を返す
+    for (const auto event : {perf_counter::DTLBLoadMiss, perf_counter::LLCLoadMiss}) {
+        perf_counter counter{event};
+        std::vector<uint64_t> xs(1 << 20);
+        counter.start();
+        uint64_t sum = 0;
+        for (std::size_t i = 0; i < xs.size(); i += 512) { sum += xs[(i * 7919) % xs.size()]; }
+        const uint64_t count = counter.stop();
+        ASSERT_EQ(0UL, sum);
+        if (not counter.available()) { ASSERT_EQ(0UL, count); }
+    }
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "common/tree_layout.hpp"
+#include "common/tree_layout_reference.hpp"
+
+namespace {
+
+/**
+ * 1からTNまでの並べ替えになっているか
+ */
+bool is_permutation(std::vector<std::size_t> orders)
+{
+    std::sort(orders.begin(), orders.end());
+    for (std::size_t i = 0; i < orders.size(); i++) {
+        if (orders[i] != i + 1) { return false; }
+    }
+    return true;
+}
+
+constexpr std::size_t MaxH        = 12;  // 試す木の高さの上限
+constexpr std::size_t ParallelMin = 16;  // 小さい木でも並列の経路を通す
+
+}  // anonymous namespace
+
+TEST(TreeLayoutTest, vEB)
+{
+    // 高さ4: 上の高さ2の木(8,4,12) -> 下の高さ2の木たち
+    const std::vector<std::size_t> expected{8, 4, 12, 2, 1, 3, 6, 5, 7, 10, 9, 11, 14, 13, 15};
+    ASSERT_EQ(expected, layout::vEB_orders(8));
+    for (std::size_t h = 1; h <= MaxH; h++) {
+        const std::size_t root = 1UL << (h - 1);
+        const auto orders      = layout_reference::vEB_orders(root);
+        ASSERT_TRUE(is_permutation(orders));
+        ASSERT_EQ(root, orders[0]);
+        ASSERT_EQ(orders, layout::vEB_orders(root));
+        for (const std::size_t threads : {1UL, 3UL, 8UL}) {
+            std::vector<std::size_t> inplace(orders.size());
+            layout::vEB_orders(root, inplace.data(), threads, ParallelMin);
+            ASSERT_EQ(orders, inplace) << "h=" << h << ", threads=" << threads;
+        }
+    }
+}
+
+TEST(TreeLayoutTest, Block)
+{
+    // 高さ4, ブロック高さ2: 上のブロック(4,8,12) -> 下のブロックたち (ブロック内は中間順)
+    const std::vector<std::size_t> expected{4, 8, 12, 1, 2, 3, 5, 6, 7, 9, 10, 11, 13, 14, 15};
+    ASSERT_EQ(expected, layout::block_orders(8, 2));
+    for (std::size_t h = 1; h <= MaxH; h++) {
+        const std::size_t root = 1UL << (h - 1);
+        for (const std::size_t max_height : {1UL, 3UL, 7UL}) {
+            const auto orders = layout_reference::block_orders(root, max_height);
+            ASSERT_TRUE(is_permutation(orders));
+            ASSERT_EQ(orders, layout::block_orders(root, max_height));
+            for (const std::size_t threads : {1UL, 3UL, 8UL}) {
+                std::vector<std::size_t> inplace(orders.size());
+                layout::block_orders(root, max_height, inplace.data(), threads, ParallelMin);
+                ASSERT_EQ(orders, inplace) << "h=" << h << ", max_height=" << max_height << ", threads=" << threads;
+            }
+        }
+    }
+}
+
+TEST(TreeLayoutTest, Complete)
+{
+    ASSERT_EQ(0UL, layout::complete_leaves(0));
+    ASSERT_TRUE(layout::complete_orders({1}, 0).empty());
+    for (std::size_t N = 1; N <= 100; N++) {
+        const std::size_t root = ceil2(N + 1) / 2;
+        const auto orders      = layout::complete_orders(layout::vEB_orders(root), N);
+        ASSERT_EQ(N, orders.size());
+        std::vector<std::size_t> ranks;
+        for (const auto order : orders) { ranks.push_back(layout::complete_rank(order, N)); }
+        ASSERT_TRUE(is_permutation(ranks));
+        auto inplace = layout::block_orders(root, 3);
+        layout::complete_orders(inplace.data(), N);
+        inplace.resize(N);
+        ASSERT_EQ(layout::complete_orders(layout::block_orders(root, 3), N), inplace) << "N=" << N;
+    }
+}
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <thread>
+
+#include "tree_layout.hpp"
+
+namespace layout {
+
+std::vector<std::size_t> complete_orders(const std::vector<std::size_t>& orders, const std::size_t N)
+{
+    std::vector<std::size_t> ans;
+    if (N == 0) { return ans; }
+    ans.reserve(N);
+    for (const auto order : orders) {
+        if (complete_contains(order, N)) { ans.push_back(order); }
+    }
+    return ans;
+}
+
+void complete_orders(std::size_t* orders, const std::size_t N)
+{
+    if (N == 0) { return; }
+    std::remove_if(orders, orders + ceil2(N + 1) - 1, [N](const std::size_t order) { return not complete_contains(order, N); });
+}
+
+namespace {
+
+/**
+ * f(i, threads_i)をi=0..n-1について呼ぶ
+ * - threads個のスレッドでiを等分する (threads_iは各iで使ってよいスレッド数)
+ */
+template<typename F>
+void parallel_for(const std::size_t n, const std::size_t threads, F f)
+{
+    const std::size_t T = std::min(threads, n);
+    if (T <= 1) {
+        for (std::size_t i = 0; i < n; i++) { f(i, threads); }
+        return;
+    }
+    const std::size_t sub_threads = threads / T;
+    std::vector<std::thread> ths;
+    for (std::size_t t = 1; t < T; t++) {
+        ths.emplace_back([&, t] {
+            for (std::size_t i = n * t / T; i < n * (t + 1) / T; i++) { f(i, sub_threads); }
+        });
+    }
+    for (std::size_t i = 0; i < n / T; i++) { f(i, sub_threads); }
+    for (auto& th : ths) { th.join(); }
+}
+
+}  // anonymous namespace
+
+std::vector<std::size_t> vEB_orders(const std::size_t root)
+{
+    std::vector<std::size_t> orders((1UL << (lsb(root) + 1)) - 1);
+    vEB_orders(root, orders.data(), std::thread::hardware_concurrency());
+    return orders;
+}
+
+/**
+ * 上の部分木の頂点番号は根をroot/2^dhとした木で求めてから2^dh倍する
+ */
+void vEB_orders(const std::size_t root, std::size_t* orders, const std::size_t threads, const std::size_t parallel_min)
+{
+    if (root & 1UL) {
+        orders[0] = root;
+        return;
+    }
+    const std::size_t height      = lsb(root) + 1;
+    const std::size_t offset      = root - (1UL << (height - 1));
+    const std::size_t uh          = height / 2;
+    const std::size_t dh          = height - uh;
+    const std::size_t top_size    = (1UL << uh) - 1;
+    const std::size_t bottom_size = (1UL << dh) - 1;
+
+    vEB_orders(root >> dh, orders, 1, parallel_min);
+    for (std::size_t i = 0; i < top_size; i++) { orders[i] <<= dh; }
+    parallel_for(1UL << uh, (1UL << height) >= parallel_min ? threads : 1, [&](const std::size_t i, const std::size_t sub_threads) {
+        vEB_orders((1UL << (dh - 1)) * (i * 2 + 1) + offset, orders + top_size + i * bottom_size, sub_threads, parallel_min);
+    });
+}
+
+std::vector<std::size_t> block_orders(const std::size_t root, const std::size_t max_height)
+{
+    std::vector<std::size_t> orders((1UL << (lsb(root) + 1)) - 1);
+    block_orders(root, max_height, orders.data(), std::thread::hardware_concurrency());
+    return orders;
+}
+
+void block_orders(const std::size_t root, const std::size_t max_height, std::size_t* orders, const std::size_t threads, const std::size_t parallel_min)
+{
+    const std::size_t height   = lsb(root) + 1;
+    const std::size_t offset   = root - (1UL << (height - 1));
+    const std::size_t uh       = (height - 1) % max_height + 1;
+    const std::size_t dh       = height - uh;
+    const std::size_t top_size = (1UL << uh) - 1;
+
+    for (std::size_t i = 1; i <= top_size; i++) { orders[i - 1] = i * (1UL << dh) + offset; }
+    if (dh != 0) {
+        const std::size_t bottom_size = (1UL << dh) - 1;
+        parallel_for(1UL << uh, (1UL << height) >= parallel_min ? threads : 1, [&](const std::size_t i, const std::size_t sub_threads) {
+            block_orders((1UL << (dh - 1)) * (i * 2 + 1) + offset, max_height, orders + top_size + i * bottom_size, sub_threads, parallel_min);
+        });
+    }
+}
+
+std::vector<std::size_t> bfs_orders(const std::size_t root)
+{
+    std::vector<std::size_t> orders{root};
+    for (std::size_t i = 0; i < orders.size(); i++) {
+        const std::size_t n = orders[i];
+        if ((n & 1UL) == 0) {
+            orders.push_back(left(n));
+            orders.push_back(right(n));
+        }
+    }
+    return orders;
+}
+
+std::vector<std::size_t> dfs_orders(const std::size_t root)
+{
+    std::vector<std::size_t> orders;
+    std::vector<std::size_t> stack{root};
+    while (not stack.empty()) {
+        const std::size_t n = stack.back();
+        stack.pop_back();
+        orders.push_back(n);
+        if ((n & 1UL) == 0) {
+            stack.push_back(right(n));
+            stack.push_back(left(n));
+        }
+    }
+    return orders;
+}
+
+}  // namespace layout
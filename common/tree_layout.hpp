@@ -0,0 +1,148 @@
+#pragma once
+/**
+ * @file tree_layout.hpp
+ * @brief 完全二分木の頂点の並べ方
+ * @note
+ * - 頂点番号は1-indexedの中間順 (高さhの完全二分木で根は2^(h-1), 葉は奇数)
+ * - 頂点nの部分木の高さはlsb(n)+1
+ * - N頂点を持つには高さclg(N+1)の完全二分木を使う
+ *   余る頂点を番兵で埋める代わりに、左詰めの完全二分木(最下段の葉が左からL個だけある)として頂点を間引くこともできる
+ */
+#include <vector>
+
+#include "common/bit.hpp"
+
+namespace layout {
+
+/**
+ * @brief N頂点を載せる木の形
+ * - Complete: 左詰めの完全二分木 (N頂点ちょうど)
+ * - Padded: 高さclg(N+1)の完全二分木 (余る頂点は番兵で埋める)
+ */
+enum class shape_t
+{
+    Complete,
+    Padded,
+};
+
+/**
+ * @brief 頂点nの左の子の頂点番号
+ * @note
+ * - 葉(奇数)を渡しちゃだめ
+ */
+inline std::size_t left(const std::size_t n)
+{
+    const std::size_t i = lsb(n) - 1;
+    return n - (1UL << i);
+}
+
+/**
+ * @brief 頂点nの右の子の頂点番号
+ * @note
+ * - 葉(奇数)を渡しちゃだめ
+ */
+inline std::size_t right(const std::size_t n)
+{
+    const std::size_t i = lsb(n) - 1;
+    return n + (1UL << i);
+}
+
+/**
+ * @brief N頂点の左詰めの完全二分木の最下段の葉の個数
+ */
+inline std::size_t complete_leaves(const std::size_t N)
+{
+    return N == 0 ? 0 : N + 1 - ceil2(N + 1) / 2;
+}
+
+/**
+ * @brief N頂点の左詰めの完全二分木に頂点nが含まれるか
+ * @details 間引かれるのは最下段の葉(奇数)のうち右側だけ
+ */
+inline bool complete_contains(const std::size_t n, const std::size_t N)
+{
+    return (n & 1UL) == 0 or n < 2 * complete_leaves(N);
+}
+
+/**
+ * @brief N頂点の左詰めの完全二分木での頂点nの順位 (1-indexed)
+ * @details 2L以下の頂点は全部残っていて、それより右は偶数だけが残っている
+ * @note
+ * - 含まれない頂点を渡しちゃだめ
+ */
+inline std::size_t complete_rank(const std::size_t n, const std::size_t N)
+{
+    const std::size_t L = complete_leaves(N);
+    return n <= 2 * L ? n : 2 * L + (n - 2 * L) / 2;
+}
+
+/**
+ * @brief 並びからN頂点の左詰めの完全二分木に含まれない頂点を除く
+ * @param orders[in] 高さclg(N+1)の完全二分木の頂点の並び
+ * @param N[in] 頂点数 (0なら空)
+ */
+std::vector<std::size_t> complete_orders(const std::vector<std::size_t>& orders, const std::size_t N);
+
+/**
+ * @brief 配列上の並びからN頂点の左詰めの完全二分木に含まれない頂点を除く (残ったN個を前に詰める)
+ * @param orders[in,out] 高さclg(N+1)の完全二分木の頂点の並び (ceil2(N+1)-1個)
+ * @param N[in] 頂点数
+ * @details 順序は変えず、メモリ確保もしない
+ */
+void complete_orders(std::size_t* orders, const std::size_t N);
+
+/**
+ * @brief 頂点root以下の部分木のvEB Layout
+ * @param root[in] 部分木の根
+ * @details 高さhの木を上半分(h/2)と下半分に分け、上 -> 下の各部分木の順に再帰的に並べる
+ */
+std::vector<std::size_t> vEB_orders(const std::size_t root);
+
+/**
+ * @brief 並べる部分木のサイズがこれより小さければ、下の部分木たちをスレッドで分けない
+ */
+constexpr std::size_t ParallelMin = 1UL << 16;
+
+/**
+ * @brief 頂点root以下の部分木のvEB Layoutを配列に直接書く
+ * @param root[in] 部分木の根
+ * @param orders[out] 書き込み先 (部分木のサイズ 2^(lsb(root)+1)-1 だけ確保しておく)
+ * @param threads[in] 使うスレッド数
+ * @param parallel_min[in] スレッドで分ける部分木のサイズの下限 (テストでは小さくして並列の経路を通す)
+ * @details
+ * - 下の部分木たちは互いに独立なのでスレッドで分担する
+ * - 再帰の途中でメモリ確保をしない
+ */
+void vEB_orders(const std::size_t root, std::size_t* orders, const std::size_t threads = 1, const std::size_t parallel_min = ParallelMin);
+
+/**
+ * @brief 頂点root以下の部分木のBlock Layout
+ * @param root[in] 部分木の根
+ * @param max_height[in] ブロックの最大高さ
+ * @details 下から高さmax_heightずつブロックに区切り、上のブロックから順に並べる
+ */
+std::vector<std::size_t> block_orders(const std::size_t root, const std::size_t max_height);
+
+/**
+ * @brief 頂点root以下の部分木のBlock Layoutを配列に直接書く
+ * @param root[in] 部分木の根
+ * @param max_height[in] ブロックの最大高さ
+ * @param orders[out] 書き込み先 (部分木のサイズ 2^(lsb(root)+1)-1 だけ確保しておく)
+ * @param threads[in] 使うスレッド数
+ * @param parallel_min[in] スレッドで分ける部分木のサイズの下限
+ */
+void block_orders(const std::size_t root, const std::size_t max_height, std::size_t* orders, const std::size_t threads = 1, const std::size_t parallel_min = ParallelMin);
+
+/**
+ * @brief 頂点root以下の部分木のBFS順 (Eytzinger Layout)
+ * @param root[in] 部分木の根
+ */
+std::vector<std::size_t> bfs_orders(const std::size_t root);
+
+/**
+ * @brief 頂点root以下の部分木のDFS順 (行きがけ順)
+ * @param root[in] 部分木の根
+ */
+std::vector<std::size_t> dfs_orders(const std::size_t root);
+
+}  // namespace layout
@@ -0,0 +1,52 @@
+#pragma once
+/**
+ * @file tree_layout_reference.hpp
+ * @brief tree_layout.hppの並べ方の素朴な実装 (比較用)
+ * @note
+ * - 部分木ごとにvectorを作って親に連結するだけの再帰
+ * - テストでの答え合わせと、in-place版との速度比較に使う
+ */
+#include <vector>
+
+#include "common/bit.hpp"
+
+namespace layout_reference {
+
+/**
+ * @brief 頂点rootを根とする部分木のvEB順 (layout::vEB_ordersと同じ並び)
+ */
+inline std::vector<std::size_t> vEB_orders(const std::size_t root)
+{
+    if (root & 1UL) { return {root}; }
+    const std::size_t height = lsb(root) + 1;
+    const std::size_t offset = root - (1UL << (height - 1));
+    const std::size_t uh     = height / 2;
+    const std::size_t dh     = height - uh;
+    std::vector<std::size_t> orders;
+    for (const auto top_order : vEB_orders(root / (1UL << dh))) { orders.push_back(top_order * (1UL << dh)); }
+    for (std::size_t i = 1; i <= (1UL << uh); i++) {
+        for (const auto child_order : vEB_orders((1UL << (dh - 1)) * (i * 2 - 1) + offset)) { orders.push_back(child_order); }
+    }
+    return orders;
+}
+
+/**
+ * @brief 頂点rootを根とする部分木のブロック順 (layout::block_ordersと同じ並び)
+ */
+inline std::vector<std::size_t> block_orders(const std::size_t root, const std::size_t max_height)
+{
+    const std::size_t height = lsb(root) + 1;
+    const std::size_t offset = root - (1UL << (height - 1));
+    const std::size_t uh     = (height - 1) % max_height + 1;
+    const std::size_t dh     = height - uh;
+    std::vector<std::size_t> orders;
+    for (std::size_t i = 1; i < (1UL << uh); i++) { orders.push_back(i * (1UL << dh) + offset); }
+    if (dh != 0) {
+        for (std::size_t i = 1; i <= (1UL << uh); i++) {
+            for (const auto child_order : block_orders((1UL << (dh - 1)) * (i * 2 - 1) + offset, max_height)) { orders.push_back(child_order); }
+        }
+    }
+    return orders;
+}
+
+}  // namespace layout_reference
@@ -1,105 +1,398 @@
+#include <algorithm>
+#include <cassert>
+
 #include "b_tree.hpp"
 #include "simulator/simulator.hpp"
 
 namespace {
 
-using ptr_t = b_tree::ptr_t;
+using ptr_t  = b_tree::ptr_t;
+using node_t = b_tree::node_t;
+
+/**
+ * 頂点の確保 (キーと子は上限まで先に確保しておき、途中で場所が動かないようにする)
+ */
+ptr_t alloc(const std::size_t K_)
+{
+    ptr_t p = std::make_shared<node_t>();
+    p->keys.reserve(2 * K_ - 1);
+    p->sons.reserve(2 * K_);
+    return p;
+}
+
+/**
+ * Simがtrueならシミュレータを通して読み書きする (falseは前計算用)
+ */
+template<bool Sim, typename T>
+const T& get(const disk_var<T>& dv)
+{
+    if constexpr (Sim) {
+        return sim::read(dv);
+    } else {
+        return dv.illegal_ref();
+    }
+}
+
+template<bool Sim, typename T>
+void set(disk_var<T>& dv, const T& val)
+{
+    if constexpr (Sim) {
+        sim::write(dv, val);
+    } else {
+        dv.illegal_ref() = val;
+    }
+}
+
+/**
+ * vs[i]にvalを挿入する (後ろを1個ずつずらす)
+ */
+template<bool Sim, typename T>
+void insert_at(std::vector<disk_var<T>>& vs, const std::size_t i, const T& val)
+{
+    vs.emplace_back();
+    for (std::size_t j = vs.size() - 1; j > i; j--) { set<Sim>(vs[j], get<Sim>(vs[j - 1])); }
+    set<Sim>(vs[i], val);
+}
+
+/**
+ * vs[i]を取り除いて返す (後ろを1個ずつ詰める)
+ */
+template<bool Sim, typename T>
+T erase_at(std::vector<disk_var<T>>& vs, const std::size_t i)
+{
+    const T val = get<Sim>(vs[i]);
+    for (std::size_t j = i; j + 1 < vs.size(); j++) { set<Sim>(vs[j], get<Sim>(vs[j + 1])); }
+    vs.pop_back();
+    return val;
+}
 
-ptr_t alloc()
+/**
+ * 頂点内でkey未満のキーの個数 (二分探索)
+ * - 中間ノードではkeyが入りうる最も左の子の番号になる
+ */
+template<bool Sim>
+std::size_t rank(const node_t& x, const data_t key)
 {
-    return std::make_shared<b_tree::node_t>();
+    std::size_t inf = 0, sup = x.keys.size();
+    while (inf < sup) {
+        const std::size_t mid = (inf + sup) / 2;
+        if (get<Sim>(x.keys[mid]) < key) {
+            inf = mid + 1;
+        } else {
+            sup = mid;
+        }
+    }
+    return inf;
 }
 
-void split_child(ptr_t x, const std::size_t i, const std::size_t K_)
+/**
+ * 満杯の子sons[i]をyとzに分ける
+ * - 葉: 後ろK-1個をzに移し、zの先頭のキーをxにコピーする (zを葉の列に挟む)
+ * - 中間ノード: 後ろK-1個と子K個をzに移し、真ん中のキーをxに上げる
+ */
+template<bool Sim>
+void split_child(const ptr_t& x, const std::size_t i, const std::size_t K_)
 {
-    ptr_t z = alloc();
-    ptr_t y = x->sons[i].illegal_ref();
+    const ptr_t z = alloc(K_);
+    const ptr_t y = get<Sim>(x->sons[i]);
     assert(y->keys.size() == 2 * K_ - 1);
-    z->leaf = y->leaf;
-    for (std::size_t j = 0; j < K_ - 1; j++) {
-        z->keys.push_back(y->keys[j + K_]);
+    const bool leaf = get<Sim>(y->leaf);
+    set<Sim>(z->leaf, leaf);
+    data_t sep;
+    if (leaf) {
+        for (std::size_t j = K_; j < 2 * K_ - 1; j++) { insert_at<Sim>(z->keys, z->keys.size(), get<Sim>(y->keys[j])); }
+        set<Sim>(z->next, get<Sim>(y->next));
+        set<Sim>(y->next, z.get());
+        y->keys.resize(K_);
+        sep = get<Sim>(z->keys[0]);
+    } else {
+        for (std::size_t j = K_; j < 2 * K_ - 1; j++) { insert_at<Sim>(z->keys, z->keys.size(), get<Sim>(y->keys[j])); }
+        for (std::size_t j = K_; j < 2 * K_; j++) { insert_at<Sim>(z->sons, z->sons.size(), get<Sim>(y->sons[j])); }
+        sep = get<Sim>(y->keys[K_ - 1]);
+        y->keys.resize(K_ - 1);
+        y->sons.resize(K_);
+    }
+    insert_at<Sim>(x->keys, i, sep);
+    insert_at<Sim>(x->sons, i + 1, z);
+}
+
+/**
+ * 根から降りながら満杯の子を分割し、葉に挿入する
+ */
+template<bool Sim>
+void insert_key(ptr_t& root, const data_t key, const std::size_t K_)
+{
+    if (root->keys.size() == 2 * K_ - 1) {
+        const ptr_t s = alloc(K_);
+        insert_at<Sim>(s->sons, 0, root);
+        root = s;
+        split_child<Sim>(root, 0, K_);
     }
-    if (not y->leaf.illegal_ref()) {
-        for (std::size_t j = 0; j < K_; j++) {
-            z->sons.push_back(y->sons[j + K_]);
+    ptr_t x = root;
+    while (not get<Sim>(x->leaf)) {
+        std::size_t i = rank<Sim>(*x, key);
+        if (get<Sim>(x->sons[i])->keys.size() == 2 * K_ - 1) {
+            split_child<Sim>(x, i, K_);
+            if (get<Sim>(x->keys[i]) < key) { i++; }
         }
+        x = get<Sim>(x->sons[i]);
     }
-    x->keys.insert(x->keys.begin() + i, y->keys[K_ - 1]);
-    x->sons.insert(x->sons.begin() + i + 1, z);
-    y->keys.resize(K_ - 1);
-    y->sons.resize(K_);
+    insert_at<Sim>(x->keys, rank<Sim>(*x, key), key);
 }
 
-void insert_nonfull(ptr_t x, const data_t k, const std::size_t K_)
+/**
+ * キー数がK-2個になった子sons[i]を直す
+ * - 兄弟がK個以上持っていれば1個借りる (区切りのキーも付け替える)
+ * - そうでなければ兄弟と併合する (2K-3個 or 2K-2個に収まる)
+ */
+void fix_child(const ptr_t& x, const std::size_t i, const std::size_t K_)
 {
-    std::size_t i = 0;
-    for (; i < x->keys.size(); i++) {
-        if (k < x->keys[i].illegal_ref()) { break; }
+    const ptr_t c   = sim::read(x->sons[i]);
+    const bool leaf = sim::read(c->leaf);
+    if (i > 0) {
+        const ptr_t l = sim::read(x->sons[i - 1]);
+        if (l->keys.size() >= K_) {
+            if (leaf) {
+                insert_at<true>(c->keys, 0, erase_at<true>(l->keys, l->keys.size() - 1));
+                sim::write(x->keys[i - 1], sim::read(c->keys[0]));
+            } else {
+                insert_at<true>(c->keys, 0, sim::read(x->keys[i - 1]));
+                insert_at<true>(c->sons, 0, erase_at<true>(l->sons, l->sons.size() - 1));
+                sim::write(x->keys[i - 1], erase_at<true>(l->keys, l->keys.size() - 1));
+            }
+            return;
+        }
     }
-    if (x->leaf.illegal_ref()) {
-        x->keys.insert(x->keys.begin() + i, k);
-    } else {
-        if (x->sons[i].illegal_ref()->keys.size() == 2 * K_ - 1) {
-            split_child(x, i, K_);
-            if (k >= x->keys[i].illegal_ref()) {
-                i++;
+    if (i < x->keys.size()) {
+        const ptr_t r = sim::read(x->sons[i + 1]);
+        if (r->keys.size() >= K_) {
+            if (leaf) {
+                insert_at<true>(c->keys, c->keys.size(), erase_at<true>(r->keys, 0));
+                sim::write(x->keys[i], sim::read(r->keys[0]));
+            } else {
+                insert_at<true>(c->keys, c->keys.size(), sim::read(x->keys[i]));
+                insert_at<true>(c->sons, c->sons.size(), erase_at<true>(r->sons, 0));
+                sim::write(x->keys[i], erase_at<true>(r->keys, 0));
             }
+            return;
+        }
+    }
+    const std::size_t j = i > 0 ? i - 1 : i;  // sons[j]にsons[j+1]を足す
+    const ptr_t l       = sim::read(x->sons[j]);
+    const ptr_t r       = sim::read(x->sons[j + 1]);
+    const data_t sep    = erase_at<true>(x->keys, j);
+    erase_at<true>(x->sons, j + 1);
+    if (leaf) {
+        sim::write(l->next, sim::read(r->next));
+    } else {
+        insert_at<true>(l->keys, l->keys.size(), sep);
+        for (std::size_t k = 0; k < r->sons.size(); k++) { insert_at<true>(l->sons, l->sons.size(), sim::read(r->sons[k])); }
+    }
+    for (std::size_t k = 0; k < r->keys.size(); k++) { insert_at<true>(l->keys, l->keys.size(), sim::read(r->keys[k])); }
+}
+
+/**
+ * xを根とする部分木からkeyを1個消す
+ * - keyが入りうる子を左から試す (keys[i] == keyなら右の子にもありうる)
+ * - 消した後に子のキーが足りなければ直す
+ */
+bool erase_key(const ptr_t& x, const data_t key, const std::size_t K_)
+{
+    std::size_t i = rank<true>(*x, key);
+    if (sim::read(x->leaf)) {
+        if (i == x->keys.size() or sim::read(x->keys[i]) != key) { return false; }
+        erase_at<true>(x->keys, i);
+        return true;
+    }
+    for (; i <= x->keys.size(); i++) {
+        if (erase_key(sim::read(x->sons[i]), key, K_)) {
+            if (sim::read(x->sons[i])->keys.size() < K_ - 1) { fix_child(x, i, K_); }
+            return true;
         }
-        insert_nonfull(x->sons[i].illegal_ref(), k, K_);
+        if (i == x->keys.size() or sim::read(x->keys[i]) != key) { break; }
     }
+    return false;
+}
+
+/**
+ * 1段をまとめて作るときの頂点数
+ * - n個のキーをc個の頂点に配り、頂点の間のc-1個は1つ上の段に上げる
+ * - 各頂点のキー数が(n+1)/c-1程度になるので、m以上・2K-1以下になるように選ぶ
+ */
+std::size_t level_node_num(const std::size_t n, const std::size_t m, const std::size_t K_)
+{
+    return std::max({(n + 1) / (m + 1), (n + 1 + 2 * K_ - 1) / (2 * K_), std::size_t{1}});
+}
+
+/**
+ * 葉の段の頂点数
+ * - n個のキーをc個の葉に配る (各葉のキー数がm以上・2K-1以下)
+ */
+std::size_t leaf_node_num(const std::size_t n, const std::size_t m, const std::size_t K_)
+{
+    return std::max({n / m, (n + 2 * K_ - 2) / (2 * K_ - 1), std::size_t{1}});
 }
 
 }  // anonymous namespace
 
-b_tree::b_tree(const std::size_t K_) : K{K_}, m_root{alloc()}
+b_tree::b_tree(const std::size_t K_) : K{K_}, m_root{alloc(K_)}
 {
+    assert(K_ >= 2);
     m_root->leaf = true;
 }
 
-b_tree::b_tree(const std::vector<data_t>& datas, const std::size_t K_) : K{K_}, m_root{alloc()}
+b_tree::b_tree(const std::vector<data_t>& datas, const std::size_t K_) : K{K_}, m_root{alloc(K_)}
 {
+    assert(K_ >= 2);
     m_root->leaf = true;
     for (const auto data : datas) {
         illegal_insert(data);
     }
 }
 
-void b_tree::illegal_insert(const data_t key)
+/**
+ * 葉の段から順に作る
+ * - 葉: キーを配って左から順につなぎ、2つ目以降の葉の先頭のキーを区切りとして上の段に渡す
+ * - 中間ノード: items(区切り)を配り、頂点の間の区切りを1つ上の段に上げる
+ *   sonsは1つ下の段の頂点 (items.size()+1個)
+ */
+b_tree b_tree::bulk_load(std::vector<data_t> datas, const std::size_t K_, const double fill)
 {
-    if (m_root->keys.size() == 2 * K - 1) {
-        auto r = m_root;
-        auto s = alloc();
-        s->sons.push_back(disk_var<ptr_t>{r});
-        m_root = s;
-        split_child(m_root, 0, K);
+    assert(K_ >= 2);
+    if (not std::is_sorted(datas.begin(), datas.end())) { std::sort(datas.begin(), datas.end()); }
+    const double full   = static_cast<double>(2 * K_ - 1);
+    const std::size_t m = std::clamp(static_cast<std::size_t>(full * fill + 0.5), K_ - 1, 2 * K_ - 1);
+
+    std::vector<data_t> items;
+    std::vector<ptr_t> sons;
+    {
+        const std::size_t n = datas.size();
+        const std::size_t c = leaf_node_num(n, m, K_);
+        const std::size_t q = n / c, r = n % c;
+        items.reserve(c - 1), sons.reserve(c);
+        std::size_t i = 0;
+        for (std::size_t k = 0; k < c; k++) {
+            ptr_t p               = alloc(K_);
+            p->leaf               = true;
+            const std::size_t num = q + (k < r ? 1 : 0);
+            for (std::size_t l = 0; l < num; l++) { p->keys.push_back(disk_var<data_t>{datas[i++]}); }
+            if (k > 0) {
+                items.push_back(datas[i - num]);
+                sons.back()->next = p.get();
+            }
+            sons.push_back(std::move(p));
+        }
+        assert(i == n);
+    }
+    while (sons.size() > 1) {
+        const std::size_t n = items.size();
+        const std::size_t c = level_node_num(n, m, K_);
+        const std::size_t q = (n + 1 - c) / c, r = (n + 1 - c) % c;
+        std::vector<data_t> next_items;
+        std::vector<ptr_t> next_sons;
+        next_items.reserve(c - 1), next_sons.reserve(c);
+        std::size_t i = 0, j = 0;
+        for (std::size_t k = 0; k < c; k++) {
+            ptr_t p               = alloc(K_);
+            const std::size_t num = q + (k < r ? 1 : 0);
+            for (std::size_t l = 0; l < num; l++) { p->keys.push_back(disk_var<data_t>{items[i++]}); }
+            for (std::size_t l = 0; l <= num; l++) { p->sons.push_back(disk_var<ptr_t>{sons[j++]}); }
+            if (k + 1 < c) { next_items.push_back(items[i++]); }
+            next_sons.push_back(std::move(p));
+        }
+        assert(i == n and j == sons.size());
+        items = std::move(next_items);
+        sons  = std::move(next_sons);
     }
-    insert_nonfull(m_root, key, K);
+    b_tree tree{K_};
+    tree.m_root = sons[0];
+    return tree;
+}
+
+void b_tree::illegal_insert(const data_t key)
+{
+    insert_key<false>(m_root, key, K);
 }
 
+void b_tree::insert(const data_t key)
+{
+    insert_key<true>(m_root, key, K);
+}
+
+bool b_tree::erase(const data_t key)
+{
+    const bool found = erase_key(m_root, key, K);
+    if (not sim::read(m_root->leaf) and m_root->keys.empty()) { m_root = sim::read(m_root->sons[0]); }
+    return found;
+}
+
+/**
+ * 葉まで降りて、葉の中に無ければ右隣の葉の先頭が答え
+ */
 data_t b_tree::lower_bound(const data_t key) const
 {
-    ptr_t p    = m_root;
-    data_t max = Max + 1;
-    while (true) {
-        for (std::size_t i = 0; i < p->keys.size(); i++) {
-            const data_t k = sim::read(p->keys[i]);
-            if (key <= k) {
-                max = std::min(max, k);
-                if (k == key) { return k; }
-            }
+    const node_t* p = m_root.get();
+    while (not sim::read(p->leaf)) { p = sim::read(p->sons[rank<true>(*p, key)]).get(); }
+    const std::size_t i = rank<true>(*p, key);
+    if (i < p->keys.size()) { return sim::read(p->keys[i]); }
+    p = sim::read(p->next);
+    return p == nullptr ? Max + 1 : sim::read(p->keys[0]);
+}
+
+std::vector<data_t> b_tree::range(const data_t lo, const data_t hi) const
+{
+    std::vector<data_t> out;
+    const node_t* p = m_root.get();
+    while (not sim::read(p->leaf)) { p = sim::read(p->sons[rank<true>(*p, lo)]).get(); }
+    for (std::size_t i = rank<true>(*p, lo); p != nullptr; p = sim::read(p->next), i = 0) {
+        for (; i < p->keys.size(); i++) {
+            const data_t key = sim::read(p->keys[i]);
+            if (key >= hi) { return out; }
+            out.push_back(key);
         }
-        if (not sim::read(p->leaf)) {
-            std::size_t i = 0;
-            for (; i < p->keys.size(); i++) {
-                const data_t k = sim::read(p->keys[i]);
-                if (key < k) {
-                    break;
-                }
-            }
-            p = sim::read(p->sons[i]);
-        } else {
-            break;
+    }
+    return out;
+}
+
+std::size_t b_tree::height() const
+{
+    std::size_t h = 1;
+    for (ptr_t p = m_root; not p->leaf.illegal_ref(); p = p->sons[0].illegal_ref()) { h++; }
+    return h;
+}
+
+std::vector<data_t> b_tree::lower_bound_batch(const std::vector<data_t>& qs, const std::size_t B, const std::size_t M) const
+{
+    auto sorted = batch::sorted_queries(qs, B, M);
+    descend(m_root.get(), sorted.data(), sorted.data() + sorted.size());
+    return batch::answers(sorted, B, M);
+}
+
+/**
+ * pを根とする部分木で[first,last)のクエリに答える
+ * - 中間ノード: keys[i-1]より大きくkeys[i]以下のクエリはsons[i]へ
+ * - 葉: keys[i-1]より大きくkeys[i]以下のクエリの答えはkeys[i]
+ *   最大のキーより大きいクエリの答えは右隣の葉の先頭
+ */
+void b_tree::descend(const node_t* p, batch::iter_t first, const batch::iter_t last) const
+{
+    const std::size_t k = p->keys.size();
+    if (sim::read(p->leaf)) {
+        for (std::size_t i = 0; i < k and first != last; i++) {
+            const data_t key        = sim::read(p->keys[i]);
+            const batch::iter_t mid = batch::upper(first, last, key);
+            batch::answer(first, mid, key);
+            first = mid;
         }
+        if (first != last) {
+            const node_t* next = sim::read(p->next);
+            batch::answer(first, last, next == nullptr ? Max + 1 : sim::read(next->keys[0]));
+        }
+        return;
+    }
+    for (std::size_t i = 0; i <= k and first != last; i++) {
+        const batch::iter_t mid = i < k ? batch::upper(first, last, sim::read(p->keys[i])) : last;
+        if (first != mid) { descend(sim::read(p->sons[i]).get(), first, mid); }
+        first = mid;
     }
-    return max;
 }
@@ -6,18 +6,21 @@
 #include <memory>
 
 #include "config.hpp"
+#include "sim_algorithm/query_batch.hpp"
 #include "simulator/disk_variable.hpp"
 /**
  * @brief B-木
  * @details Cache Awareなデータ構造
  * @note
- * 中間ノードは以下のデータを持つ (根のキー数はK-1未満でもOK ＋ 葉のsonsは空)
- * - keys：k個のキー (キー数kは K-1 <= k <= 2K-1)
- * - sons：k+1個の子ノード
+ * B+木の形で持つ (キーは全て葉にあり、中間ノードのキーは区切り)
+ * - keys：k個のキー (キー数kは K-1 <= k <= 2K-1, 根はK-1未満でもOK)
+ * - sons：k+1個の子ノード (葉は空)
+ * - next：右隣の葉 (葉のみ, 右端はnullptr)
  *
  * さらに探索木としての性質として以下が成立している
  * - keysは昇順
- * - sons[i]に含まれるキーは、keys[i-1]以上＆keys[i]未満
+ * - sons[i]に含まれるキーは、keys[i-1]以上＆keys[i]以下 (重複したキーは両側にありうる)
+ * - 葉をnextで辿るとキーは昇順
  */
 class b_tree
 {
@@ -27,39 +30,83 @@ class b_tree
         std::vector<disk_var<data_t>> keys{};
         std::vector<disk_var<std::shared_ptr<node_t>>> sons{};
         disk_var<bool> leaf{false};
+        disk_var<node_t*> next{nullptr};
     };
 
 public:
     /**
      * @brief コンストラクタ
-     * @param K[in] キー数に関する定数
+     * @param K[in] キー数に関する定数 (2以上)
      */
     b_tree(const std::size_t K_);
 
     /**
      * @brief コンストラクタ
-     * @param K[in] キー数に関する定数
+     * @param K[in] キー数に関する定数 (2以上)
      * @param datas[in] 初期データ
      */
     b_tree(const std::vector<data_t>& datas, const std::size_t K_);
 
+    /**
+     * @brief ソート済みのデータから下の段から順に一括で構築する
+     * @param datas[in] 初期データ (ソートされていなければソートする)
+     * @param K[in] キー数に関する定数 (2以上)
+     * @param fill[in] 充填率 (各頂点のキー数を2K-1のfill倍に揃える, K-1以上2K-1以下に丸める)
+     * @details
+     * - 1個ずつ挿入すると頂点は半分程度しか埋まらないが、fill=1なら全頂点がほぼ満杯になり段数も減る
+     */
+    static b_tree bulk_load(std::vector<data_t> datas, const std::size_t K_, const double fill = 1.0);
+
     /**
      * @brief 挿入
      * @param key[in] キー
+     * @details 根から降りながら満杯の子を分割する
      */
     void insert(const data_t key);
 
+    /**
+     * @brief 削除
+     * @param key[in] キー
+     * @return keyがあればtrue (1個だけ消す)
+     * @details キーがK-2個になった子は、兄弟から1個借りるか兄弟と併合する
+     */
+    bool erase(const data_t key);
+
+    /**
+     * @brief [lo,hi)のキーを昇順に列挙
+     * @param lo[in] 下限
+     * @param hi[in] 上限 (含まない)
+     * @details loの葉まで降りた後は葉をnextで辿るだけ (連続した読み込み)
+     */
+    std::vector<data_t> range(const data_t lo, const data_t hi) const;
+
     /**
      * @brief LowerBound
      * @param key[in] キー
      */
     data_t lower_bound(const data_t key) const;
 
+    /**
+     * @brief LowerBoundをまとめて処理
+     * @param qs[in] クエリの配列
+     * @param B[in] ブロックサイズ (クエリ列の並べ替えに使う)
+     * @param M[in] キャッシュサイズ (クエリ列の並べ替えに使う)
+     * @return 各クエリの答え (qsと同じ順)
+     * @details クエリをディスク上で昇順に並べ、根から1回だけ降りながらクエリ列を子に振り分ける
+     */
+    std::vector<data_t> lower_bound_batch(const std::vector<data_t>& qs, const std::size_t B, const std::size_t M) const;
+
+    /**
+     * @brief 高さ (根だけなら1)
+     */
+    std::size_t height() const;
+
     using node_t = node_t;
     using ptr_t  = std::shared_ptr<node_t>;
     std::size_t K;
 
 private:
     void illegal_insert(const data_t key);
+    void descend(const node_t* p, batch::iter_t first, const batch::iter_t last) const;
     ptr_t m_root;
 };
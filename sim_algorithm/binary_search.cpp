@@ -21,3 +21,28 @@ data_t binary_search::lower_bound(const data_t x) const
     }
     return sim::read<data_t>(m_datas[sup]);
 }
+
+std::vector<data_t> binary_search::lower_bound_batch(const std::vector<data_t>& qs, const std::size_t B, const std::size_t M) const
+{
+    auto sorted = batch::sorted_queries(qs, B, M);
+    descend(0, m_datas.size(), sorted.data(), sorted.data() + sorted.size());  // 番兵として左端に-∞があるとみなす
+    return batch::answers(sorted, B, M);
+}
+
+/**
+ * 答えが(inf,sup]にある[first,last)のクエリに答える (添字は番兵の分1つずれている)
+ * - 真ん中の値x以下のクエリは左へ、xより大きいクエリは右へ
+ */
+void binary_search::descend(const std::size_t inf, const std::size_t sup, const batch::iter_t first, const batch::iter_t last) const
+{
+    if (first == last) { return; }
+    if (sup - inf == 1) {
+        batch::answer(first, last, sim::read(m_datas[sup - 1]));
+        return;
+    }
+    const std::size_t mid   = (inf + sup) / 2;
+    const data_t x          = sim::read(m_datas[mid - 1]);
+    const batch::iter_t sep = batch::upper(first, last, x);
+    descend(inf, mid, first, sep);
+    descend(mid, sup, sep, last);
+}
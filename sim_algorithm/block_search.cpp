@@ -4,61 +4,31 @@
 #include "common/bit.hpp"
 #include "simulator/simulator.hpp"
 
-namespace {
-
-inline std::size_t left(const std::size_t n)
-{
-    const std::size_t i = lsb(n) - 1;
-    return n - (1UL << i);
-}
-
-inline std::size_t right(const std::size_t n)
-{
-    const std::size_t i = lsb(n) - 1;
-    return n + (1UL << i);
-}
-
-std::vector<std::size_t> build_orders(const std::size_t root, const std::size_t max_height)
+block_search::block_search(std::vector<data_t> vs, const std::size_t max_height, const layout::shape_t shape)
 {
-    const std::size_t height = lsb(root) + 1;
-    const std::size_t offset = root - (1UL << (height - 1));
-    const std::size_t uh     = (height - 1) % max_height + 1;
-    const std::size_t dh     = height - uh;
-
-    std::vector<std::size_t> orders;
-    for (std::size_t i = 1; i < (1UL << uh); i++) {
-        orders.push_back(i * (1UL << dh) + offset);
-    }
-    if (dh != 0) {
-        for (std::size_t i = 1; i <= (1UL << uh); i++) {
-            const auto child_orders = build_orders((1UL << (dh - 1)) * (i * 2 - 1) + offset, max_height);
-            for (const auto child_order : child_orders) { orders.push_back(child_order); }
-        }
+    if (vs.empty()) {
+        m_root_pos = static_cast<std::size_t>(-1);  // 空の木 (lower_boundはMax+1を返す)
+        return;
     }
-    return orders;
-}
-
-}  // namespace
-
-block_search::block_search(std::vector<data_t> vs, const std::size_t max_height)
-{
+    std::sort(vs.begin(), vs.end());
+    if (shape == layout::shape_t::Padded) { vs.resize(ceil2(vs.size() + 1) - 1, Max + 1); }  // 番兵で埋めると左詰めの完全二分木が満杯になる
     const std::size_t N    = vs.size();
     const std::size_t TN   = ceil2(N + 1) - 1;
     const std::size_t ROOT = (TN + 1) / 2;
 
-    const std::vector<std::size_t> orders = build_orders(ROOT, max_height);  // 1-indexed
+    const std::vector<std::size_t> orders = layout::complete_orders(layout::block_orders(ROOT, max_height), N);  // 1-indexed, N頂点
     std::vector<std::size_t> poss(TN + 1);
-    for (std::size_t i = 0; i < TN; i++) {
+    for (std::size_t i = 0; i < N; i++) {
         poss[orders[i]] = i;
     }
-    std::sort(vs.begin(), vs.end());
-    m_root_pos = poss[ROOT];
-    for (std::size_t i = 0; i < TN; i++) {
+    const auto child_pos = [&](const std::size_t n) { return layout::complete_contains(n, N) ? poss[n] : static_cast<std::size_t>(-1); };
+    m_root_pos           = poss[ROOT];
+    for (std::size_t i = 0; i < N; i++) {
         const std::size_t order = orders[i];
-        m_xs.push_back(order > N ? data_t{Max + 1} : vs[order - 1]);
+        m_xs.push_back(vs[layout::complete_rank(order, N) - 1]);
         if ((order & 1UL) == 0) {
-            m_ls.push_back(poss[left(order)]);
-            m_rs.push_back(poss[right(order)]);
+            m_ls.push_back(child_pos(layout::left(order)));
+            m_rs.push_back(child_pos(layout::right(order)));
         } else {
             m_ls.push_back(static_cast<std::size_t>(-1));
             m_rs.push_back(static_cast<std::size_t>(-1));
@@ -81,3 +51,27 @@ data_t block_search::lower_bound(const data_t v) const
     }
     return ans;
 }
+
+std::vector<data_t> block_search::lower_bound_batch(const std::vector<data_t>& qs, const std::size_t B, const std::size_t M) const
+{
+    auto sorted = batch::sorted_queries(qs, B, M);
+    descend(m_root_pos, sorted.data(), sorted.data() + sorted.size(), Max + 1);
+    return batch::answers(sorted, B, M);
+}
+
+/**
+ * posを根とする部分木で[first,last)のクエリに答える (ansは祖先で見つかった候補)
+ * - x以下のクエリは左へ、xより大きいクエリは右へ
+ */
+void block_search::descend(const std::size_t pos, const batch::iter_t first, const batch::iter_t last, const data_t ans) const
+{
+    if (first == last) { return; }
+    if (pos == static_cast<std::size_t>(-1)) {
+        batch::answer(first, last, ans);
+        return;
+    }
+    const data_t x          = sim::read(m_xs[pos]);
+    const batch::iter_t mid = batch::upper(first, last, x);
+    if (first != mid) { descend(sim::read(m_ls[pos]), first, mid, x); }
+    if (mid != last) { descend(sim::read(m_rs[pos]), mid, last, ans); }
+}
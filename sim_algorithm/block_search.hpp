@@ -6,7 +6,9 @@
  * - 静的なデータのみを扱う
  * - B-木に類似している
  */
+#include "common/tree_layout.hpp"
 #include "config.hpp"
+#include "sim_algorithm/query_batch.hpp"
 #include "simulator/data_cache.hpp"
 #include "simulator/disk_variable.hpp"
 
@@ -22,8 +24,12 @@ public:
      * @brief コンストラクタ     
      * @param vs[in] データ配列
      * @param max_height[in] ブロックの最大高さ
+     * @param shape[in] 木の形
+     * @details
+     * - ブロックは下から区切るので、Completeでは最下段が疎なブロックが各経路の一番下に来る
+     *   ブロックがPaddedより小さく不揃いになる分、メモリは減ってもキャッシュミスは増えることがある
      */
-    block_search(std::vector<data_t> vs, const std::size_t block_height);
+    block_search(std::vector<data_t> vs, const std::size_t block_height, const layout::shape_t shape = layout::shape_t::Complete);
 
     /**
      * @brief LowerBoundクエリ
@@ -31,7 +37,19 @@ public:
      */
     data_t lower_bound(const data_t v) const;
 
+    /**
+     * @brief LowerBoundクエリをまとめて処理
+     * @param qs[in] クエリの配列
+     * @param B[in] ブロックサイズ (クエリ列の並べ替えに使う)
+     * @param M[in] キャッシュサイズ (クエリ列の並べ替えに使う)
+     * @return 各クエリの答え (qsと同じ順)
+     * @details クエリをディスク上で昇順に並べ、根から1回だけ降りながらクエリ列を左右の子に振り分ける
+     */
+    std::vector<data_t> lower_bound_batch(const std::vector<data_t>& qs, const std::size_t B, const std::size_t M) const;
+
 private:
+    void descend(const std::size_t pos, const batch::iter_t first, const batch::iter_t last, const data_t ans) const;
+
     std::size_t m_root_pos;
     std::vector<disk_var<std::size_t>> m_ls, m_rs;
     std::vector<disk_var<data_t>> m_xs;
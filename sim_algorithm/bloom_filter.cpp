@@ -0,0 +1,54 @@
+#include <algorithm>
+#include <cmath>
+
+#include "bloom_filter.hpp"
+#include "sim_algorithm/hash_table.hpp"
+#include "simulator/simulator.hpp"
+
+namespace {
+constexpr uint64_t Seed1 = 0x9E3779B97F4A7C15ULL;
+
+/**
+ * レーンごとのビット位置を決める奇数の定数
+ */
+constexpr uint32_t Salts[bloom_filter::Lanes] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+}  // anonymous namespace
+
+bloom_filter::bloom_filter(const std::vector<data_t>& vs, const double bits_per_key)
+    : m_blocks(std::max<std::size_t>(static_cast<std::size_t>(std::ceil(static_cast<double>(vs.size()) * bits_per_key / (sizeof(block_t) * 8))), 1))
+{
+    for (const data_t x : vs) {
+        const uint64_t h = hashing::mix(x, Seed1);
+        const block_t m  = mask(h);
+        auto& lanes      = m_blocks[block(h)].illegal_ref().lanes;
+        for (std::size_t i = 0; i < Lanes; i++) { lanes[i] |= m.lanes[i]; }
+    }
+}
+
+bool bloom_filter::may_contain(const data_t x) const
+{
+    const uint64_t h = hashing::mix(x, Seed1);
+    const block_t m  = mask(h);
+    const block_t& b = sim::read(m_blocks[block(h)]);
+    bool ans         = true;
+    for (std::size_t i = 0; i < Lanes; i++) { ans &= ((b.lanes[i] & m.lanes[i]) == m.lanes[i]); }
+    return ans;
+}
+
+/**
+ * 上位32bitでブロックを選ぶ (剰余の代わりに掛けてシフト)
+ */
+std::size_t bloom_filter::block(const uint64_t h) const
+{
+    return static_cast<std::size_t>(((h >> 32) * m_blocks.size()) >> 32);
+}
+
+/**
+ * 下位32bitから、各レーンで1bitずつ立てる位置を決める
+ */
+bloom_filter::block_t bloom_filter::mask(const uint64_t h)
+{
+    block_t m;
+    for (std::size_t i = 0; i < Lanes; i++) { m.lanes[i] = 1U << ((static_cast<uint32_t>(h) * Salts[i]) >> 27); }
+    return m;
+}
@@ -0,0 +1,53 @@
+#pragma once
+/**
+ * @file bloom_filter.hpp
+ * @brief ブロック化したBloom Filter (検索の前段で、無いキーを弾く)
+ * @note
+ * - 1つのキーのビットは全て1ブロック(32byte)に収める (1回の判定で読むのは1ブロック)
+ * - ブロックは32bitのレーン8本で、キーごとに各レーンに1bitずつ立てる (Split Block Bloom Filter)
+ * - 偽陽性はあるが偽陰性は無いので、falseなら本体を探さずに「無い」と答えてよい
+ */
+#include <cstdint>
+#include <vector>
+
+#include "config.hpp"
+#include "simulator/disk_variable.hpp"
+
+/**
+ * @brief ブロック化したBloom Filter
+ * @details
+ * - MayContain(x): xがあるかもしれないならtrue (無ければ高確率でfalse)
+ */
+class bloom_filter
+{
+public:
+    static constexpr std::size_t Lanes = 8;
+    struct alignas(32) block_t
+    {
+        uint32_t lanes[Lanes];
+    };
+
+    /**
+     * @brief コンストラクタ
+     * @param vs[in] データ配列
+     * @param bits_per_key[in] キーあたりのビット数 (12なら偽陽性率は1%程度)
+     */
+    bloom_filter(const std::vector<data_t>& vs, const double bits_per_key = 12.0);
+
+    /**
+     * @brief MayContainクエリ
+     * @param x[in]
+     */
+    bool may_contain(const data_t x) const;
+
+    /**
+     * @brief フィルタのバイト数
+     */
+    std::size_t bytes() const { return m_blocks.size() * sizeof(block_t); }
+
+private:
+    std::size_t block(const uint64_t h) const;
+    static block_t mask(const uint64_t h);
+
+    std::vector<disk_var<block_t>> m_blocks;
+};
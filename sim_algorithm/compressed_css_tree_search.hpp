@@ -0,0 +1,160 @@
+#pragma once
+/**
+ * @file compressed_css_tree_search.hpp
+ * @brief 葉を圧縮したCSS-treeを用いた探索
+ * @note
+ * - 静的なデータのみを扱う
+ * - 葉のキーは先頭のキーとの差分(Frame of Reference)を、葉ごとに決めたビット幅で詰める
+ * - 1つの葉(1ブロック)に入るキーが増えるので、葉の数と転送量が減る
+ * - 中間ノードはcss_tree_searchと同じ (子の部分木の最大値を持ち、子は添字の計算で求める)
+ */
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "common/bit.hpp"
+#include "config.hpp"
+#include "simulator/disk_variable.hpp"
+#include "simulator/simulator.hpp"
+
+/**
+ * @brief 葉を圧縮したCSS-treeでデータを保持する構造体
+ * @details
+ * - LowerBound(x): データのうちx以上の最小の値を返す
+ * - NodeBytes: 頂点のバイト数 (シミュレータのBと揃えると1頂点=1ブロックになる)
+ * @note
+ * - 葉は base/count/width と、count個の差分(key - base)をwidthビットずつ詰めたもの
+ * - 葉には先頭から貪欲に、count*widthがPayloadBitsに収まる限りキーを入れる
+ * - データの末尾にMax+1を足しておくので、降りる先の葉は必ず存在する
+ */
+template<std::size_t NodeBytes>
+class compressed_css_tree_search
+{
+public:
+    static constexpr std::size_t NodeSize    = NodeBytes / sizeof(data_t);
+    static constexpr std::size_t Fanout      = NodeSize + 1;
+    static constexpr std::size_t PayloadBits = (NodeBytes - 16) * 8;
+
+    struct alignas(NodeBytes) node_t
+    {
+        data_t keys[NodeSize];
+    };
+    struct alignas(NodeBytes) leaf_t
+    {
+        data_t base;
+        uint32_t count;
+        uint32_t width;
+        uint64_t words[PayloadBits / 64];
+    };
+    static_assert(sizeof(node_t) == NodeBytes, "NodeBytes must be a multiple of sizeof(data_t)");
+    static_assert(sizeof(leaf_t) == NodeBytes, "NodeBytes must be a multiple of sizeof(data_t)");
+    static_assert(NodeBytes >= 32, "NodeBytes is too small");
+
+    /**
+     * @brief コンストラクタ
+     * @param vs[in] データ配列
+     */
+    compressed_css_tree_search(std::vector<data_t> vs)
+    {
+        std::sort(vs.begin(), vs.end());
+        vs.push_back(Max + 1);
+        std::vector<data_t> maxs;  // maxs[l]: 葉lの最大値
+        for (std::size_t i = 0; i < vs.size();) {
+            leaf_t& leaf      = m_leaves.emplace_back().illegal_ref();
+            leaf.base         = vs[i];
+            std::size_t count = 0, width = 1;
+            for (; i + count < vs.size(); count++) {
+                const std::size_t w = std::max(width, bit_width(vs[i + count] - leaf.base));
+                if ((count + 1) * w > PayloadBits) { break; }
+                width = w;
+            }
+            leaf.count = static_cast<uint32_t>(count);
+            leaf.width = static_cast<uint32_t>(width);
+            for (std::size_t j = 0; j < count; j++) { pack(leaf, j, vs[i + j] - leaf.base); }
+            i += count;
+            maxs.push_back(vs[i - 1]);
+        }
+
+        std::vector<std::size_t> nums{m_leaves.size()};  // nums[h]: 段hの頂点数
+        while (nums.back() > 1) { nums.push_back((nums.back() + Fanout - 1) / Fanout); }
+        m_offsets.resize(nums.size());
+        std::size_t total = 0;
+        for (std::size_t h = nums.size(); h-- > 1;) {
+            m_offsets[h] = total;
+            total += nums[h];
+        }
+        m_nodes.resize(total);
+        std::size_t span = 1;  // 段h-1の頂点の部分木に含まれる葉の個数
+        for (std::size_t h = 1; h < nums.size(); h++) {
+            for (std::size_t k = 0; k < nums[h]; k++) {
+                for (std::size_t j = 0; j < NodeSize; j++) {
+                    const std::size_t c                             = k * Fanout + j;
+                    m_nodes[m_offsets[h] + k].illegal_ref().keys[j] = c < nums[h - 1] ? maxs[std::min((c + 1) * span, nums[0]) - 1] : data_t{Max + 1};
+                }
+            }
+            span *= Fanout;
+        }
+    }
+
+    /**
+     * @brief LowerBoundクエリ
+     * @param v[in]
+     */
+    data_t lower_bound(const data_t v) const
+    {
+        std::size_t k = 0;
+        for (std::size_t h = m_offsets.size() - 1; h > 0; h--) {
+            k = k * Fanout + rank(sim::read(m_nodes[m_offsets[h] + k]), v);
+        }
+        const leaf_t& leaf = sim::read(m_leaves[k]);
+        if (v <= leaf.base) { return leaf.base; }
+        const data_t d = v - leaf.base;
+        std::size_t r  = 0;
+        for (std::size_t j = 0; j < leaf.count; j++) { r += (unpack(leaf, j) < d); }
+        return leaf.base + unpack(leaf, r);
+    }
+
+    /**
+     * @brief 段数 (葉だけなら1)
+     */
+    std::size_t height() const { return m_offsets.size(); }
+
+    /**
+     * @brief 葉の数
+     */
+    std::size_t leaf_num() const { return m_leaves.size(); }
+
+private:
+    static std::size_t bit_width(const data_t d) { return d == 0 ? 1 : lg(d) + 1; }
+
+    /**
+     * @brief j番目の差分 (64bit境界をまたぐ場合は2語から取り出す)
+     */
+    static data_t unpack(const leaf_t& leaf, const std::size_t j)
+    {
+        const std::size_t p = j * leaf.width, w = p / 64, s = p % 64;
+        data_t x            = leaf.words[w] >> s;
+        if (s + leaf.width > 64) { x |= leaf.words[w + 1] << (64 - s); }
+        return leaf.width == 64 ? x : x & ((data_t{1} << leaf.width) - 1);
+    }
+    static void pack(leaf_t& leaf, const std::size_t j, const data_t d)
+    {
+        const std::size_t p = j * leaf.width, w = p / 64, s = p % 64;
+        leaf.words[w] |= d << s;
+        if (s + leaf.width > 64) { leaf.words[w + 1] |= d >> (64 - s); }
+    }
+
+    /**
+     * @brief 頂点内でv未満のキーの個数 (頂点は丸ごと読んでいるので分岐なしで数える)
+     */
+    static std::size_t rank(const node_t& node, const data_t v)
+    {
+        std::size_t r = 0;
+        for (const data_t x : node.keys) { r += (x < v); }
+        return r;
+    }
+
+    std::vector<std::size_t> m_offsets;  // 段h(>=1)の先頭の頂点の位置 (根が先頭)
+    std::vector<disk_var<node_t>> m_nodes;
+    std::vector<disk_var<leaf_t>> m_leaves;
+};
@@ -0,0 +1,110 @@
+#pragma once
+/**
+ * @file css_tree_search.hpp
+ * @brief 静的なk分木のB+木(CSS-tree)を用いた探索
+ * @note
+ * - 静的なデータのみを扱う
+ * - 葉はソート済み配列をNodeSize個ずつに区切ったもの
+ * - 中間ノードは子の部分木の最大値を持つだけで、子は添字の計算で求める (ポインタを持たない)
+ */
+#include <algorithm>
+#include <vector>
+
+#include "config.hpp"
+#include "simulator/disk_variable.hpp"
+#include "simulator/simulator.hpp"
+
+/**
+ * @brief CSS-treeでデータを保持する構造体
+ * @details
+ * - LowerBound(x): データのうちx以上の最小の値を返す
+ * - NodeBytes: 頂点のバイト数 (シミュレータのBと揃えると1頂点=1ブロックになる)
+ * @note
+ * - 頂点はNodeSize個のキーを持ち、中間ノードはFanout(=NodeSize+1)個の子を持つ
+ * - 段hのk番目の頂点のi番目の子は、段h-1のk*Fanout+i番目の頂点
+ * - 中間ノードのi番目のキーはi番目の子の部分木の最大値 (子が無ければMax+1)
+ * - 葉は少なくとも1個のMax+1で埋めるので、降りる先の子は必ず存在する
+ * - 頂点は根から段ごとに並べる
+ */
+template<std::size_t NodeBytes>
+class css_tree_search
+{
+public:
+    static constexpr std::size_t NodeSize = NodeBytes / sizeof(data_t);
+    static constexpr std::size_t Fanout   = NodeSize + 1;
+
+    struct alignas(NodeBytes) node_t
+    {
+        data_t keys[NodeSize];
+    };
+    static_assert(sizeof(node_t) == NodeBytes, "NodeBytes must be a multiple of sizeof(data_t)");
+
+    /**
+     * @brief コンストラクタ
+     * @param vs[in] データ配列
+     */
+    css_tree_search(std::vector<data_t> vs)
+    {
+        std::sort(vs.begin(), vs.end());
+        std::vector<std::size_t> nums{vs.size() / NodeSize + 1};  // nums[h]: 段hの頂点数
+        while (nums.back() > 1) { nums.push_back((nums.back() + Fanout - 1) / Fanout); }
+        m_offsets.resize(nums.size());
+        std::size_t total = 0;
+        for (std::size_t h = nums.size(); h-- > 0;) {
+            m_offsets[h] = total;
+            total += nums[h];
+        }
+        m_nodes.resize(total);
+
+        const auto leaf_key = [&](const std::size_t l, const std::size_t j) {
+            const std::size_t i = l * NodeSize + j;
+            return i < vs.size() ? vs[i] : data_t{Max + 1};
+        };
+        for (std::size_t l = 0; l < nums[0]; l++) {
+            for (std::size_t j = 0; j < NodeSize; j++) { m_nodes[m_offsets[0] + l].illegal_ref().keys[j] = leaf_key(l, j); }
+        }
+        std::size_t span = 1;  // 段h-1の頂点の部分木に含まれる葉の個数
+        for (std::size_t h = 1; h < nums.size(); h++) {
+            for (std::size_t k = 0; k < nums[h]; k++) {
+                for (std::size_t j = 0; j < NodeSize; j++) {
+                    const std::size_t c = k * Fanout + j;
+                    m_nodes[m_offsets[h] + k].illegal_ref().keys[j] = c < nums[h - 1] ? leaf_key(std::min((c + 1) * span, nums[0]) - 1, NodeSize - 1) : data_t{Max + 1};
+                }
+            }
+            span *= Fanout;
+        }
+    }
+
+    /**
+     * @brief LowerBoundクエリ
+     * @param v[in]
+     */
+    data_t lower_bound(const data_t v) const
+    {
+        std::size_t k = 0;
+        for (std::size_t h = m_offsets.size() - 1; h > 0; h--) {
+            k = k * Fanout + rank(sim::read(m_nodes[m_offsets[h] + k]), v);
+        }
+        const node_t& leaf = sim::read(m_nodes[m_offsets[0] + k]);
+        return leaf.keys[rank(leaf, v)];
+    }
+
+    /**
+     * @brief 段数 (葉だけなら1)
+     */
+    std::size_t height() const { return m_offsets.size(); }
+
+private:
+    /**
+     * @brief 頂点内でv未満のキーの個数 (頂点は丸ごと読んでいるので分岐なしで数える)
+     */
+    static std::size_t rank(const node_t& node, const data_t v)
+    {
+        std::size_t r = 0;
+        for (const data_t x : node.keys) { r += (x < v); }
+        return r;
+    }
+
+    std::vector<std::size_t> m_offsets;  // 段hの先頭の頂点の位置 (根が先頭)
+    std::vector<disk_var<node_t>> m_nodes;
+};
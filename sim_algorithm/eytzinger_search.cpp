@@ -0,0 +1,32 @@
+#include <algorithm>
+
+#include "eytzinger_search.hpp"
+#include "simulator/simulator.hpp"
+
+eytzinger_search::eytzinger_search(std::vector<data_t> vs) : m_xs(vs.size() + 1)
+{
+    std::sort(vs.begin(), vs.end());
+    m_xs[0].illegal_ref() = Max + 1;
+    std::size_t i         = 0;
+    build(vs, i, 1);
+}
+
+/**
+ * 頂点k以下の部分木に昇順の値を中順で詰める
+ */
+void eytzinger_search::build(const std::vector<data_t>& vs, std::size_t& i, const std::size_t k)
+{
+    if (k >= m_xs.size()) { return; }
+    build(vs, i, 2 * k);
+    m_xs[k].illegal_ref() = vs[i++];
+    build(vs, i, 2 * k + 1);
+}
+
+data_t eytzinger_search::lower_bound(const data_t v) const
+{
+    const std::size_t N = m_xs.size() - 1;
+    std::size_t k       = 1;
+    while (k <= N) { k = 2 * k + (sim::read(m_xs[k]) < v); }
+    k >>= __builtin_ctzll(~k) + 1;  // 最後に左に降りた頂点 (なければ0)
+    return sim::read(m_xs[k]);
+}
@@ -0,0 +1,39 @@
+#pragma once
+/**
+ * @file eytzinger_search.hpp
+ * @brief Eytzinger Layout(BFS順)を用いた二分探索
+ * @note
+ * - 静的なデータのみを扱う
+ */
+#include "config.hpp"
+#include "simulator/data_cache.hpp"
+#include "simulator/disk_variable.hpp"
+
+/**
+ * @brief BFS順でデータを保持する構造体
+ * @details
+ * - LowerBound(x): データのうちx以上の最小の値を返す
+ * @note
+ * - 1-indexedで頂点kの子は2k,2k+1
+ * - 分岐なしで葉まで降り、最後に左に降りた頂点 (答え) を末尾のbitから復元する
+ */
+class eytzinger_search
+{
+public:
+    /**
+     * @brief コンストラクタ     
+     * @param vs[in] データ配列
+     */
+    eytzinger_search(std::vector<data_t> vs);
+
+    /**
+     * @brief LowerBoundクエリ
+     * @param x[in] 
+     */
+    data_t lower_bound(const data_t v) const;
+
+private:
+    void build(const std::vector<data_t>& vs, std::size_t& i, const std::size_t k);
+
+    std::vector<disk_var<data_t>> m_xs;  // m_xs[0]は番兵(Max+1)
+};
@@ -0,0 +1,62 @@
+#include "floyd_warshall.hpp"
+#include "simulator/simulator.hpp"
+
+floyd_warshall::floyd_warshall(const std::size_t n, const std::vector<data_t>& ds) : m_n{n}
+{
+    assert(ds.size() == n * n);
+    for (const auto d : ds) { m_ds.push_back(disk_var<data_t>{d}); }
+}
+
+void floyd_warshall::naive()
+{
+    for (std::size_t k = 0; k < m_n; k++) {
+        for (std::size_t i = 0; i < m_n; i++) {
+            for (std::size_t j = 0; j < m_n; j++) { relax(i, j, k); }
+        }
+    }
+}
+
+void floyd_warshall::recursive()
+{
+    std::size_t size = 1;
+    while (size < m_n) { size <<= 1; }
+    gep(0, 0, 0, size);
+}
+
+std::vector<data_t> floyd_warshall::illegal_values() const
+{
+    std::vector<data_t> ds;
+    for (const auto& dv : m_ds) { ds.push_back(dv.illegal_ref()); }
+    return ds;
+}
+
+void floyd_warshall::relax(const std::size_t i, const std::size_t j, const std::size_t k)
+{
+    const data_t dik = sim::read(m_ds[i * m_n + k]);
+    const data_t dkj = sim::read(m_ds[k * m_n + j]);
+    const data_t dij = sim::read(m_ds[i * m_n + j]);
+    if (dik + dkj < dij) { sim::write(m_ds[i * m_n + j], dik + dkj); }
+}
+
+/**
+ * [i0,i0+size)x[j0,j0+size)を[k0,k0+size)で更新する
+ * - kの前半で4ブロックを順に、kの後半で逆順に更新する
+ * - 頂点数を2冪に切り上げて考え、n以上の頂点は無視する (孤立点なので結果は変わらない)
+ */
+void floyd_warshall::gep(const std::size_t i0, const std::size_t j0, const std::size_t k0, const std::size_t size)
+{
+    if (i0 >= m_n or j0 >= m_n or k0 >= m_n) { return; }
+    if (size == 1) {
+        relax(i0, j0, k0);
+        return;
+    }
+    const std::size_t h = size / 2;
+    gep(i0, j0, k0, h);
+    gep(i0, j0 + h, k0, h);
+    gep(i0 + h, j0, k0, h);
+    gep(i0 + h, j0 + h, k0, h);
+    gep(i0 + h, j0 + h, k0 + h, h);
+    gep(i0 + h, j0, k0 + h, h);
+    gep(i0, j0 + h, k0 + h, h);
+    gep(i0, j0, k0 + h, h);
+}
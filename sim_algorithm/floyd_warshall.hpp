@@ -0,0 +1,54 @@
+#pragma once
+/**
+ * @file floyd_warshall.hpp
+ * @brief 全点対最短路 (Floyd-Warshall) のCache Obliviousな計算
+ */
+#include "config.hpp"
+#include "simulator/disk_variable.hpp"
+
+/**
+ * @brief 全点対最短路
+ * @details
+ * - naive(): k,i,jの3重ループ
+ * - recursive(): Gaussian Elimination Paradigm (I-GEP, Chowdhury-Ramachandran)
+ *   (i,j,k)の立方体を8分割して再帰する
+ * @note
+ * - 距離行列は行優先
+ * - 到達不能はInf (Inf+Infが溢れないようにMax)
+ */
+class floyd_warshall
+{
+public:
+    static constexpr data_t Inf = Max;
+
+    /**
+     * @brief コンストラクタ
+     * @param n[in] 頂点数
+     * @param ds[in] 辺の長さ (行優先, n*n要素)
+     */
+    floyd_warshall(const std::size_t n, const std::vector<data_t>& ds);
+
+    /**
+     * @brief 3重ループ
+     */
+    void naive();
+
+    /**
+     * @brief I-GEP
+     */
+    void recursive();
+
+    /**
+     * @brief 距離行列
+     * @note
+     * - 結果確認用 (キャッシュを介さない)
+     */
+    std::vector<data_t> illegal_values() const;
+
+private:
+    void relax(const std::size_t i, const std::size_t j, const std::size_t k);
+    void gep(const std::size_t i0, const std::size_t j0, const std::size_t k0, const std::size_t size);
+
+    std::size_t m_n;
+    std::vector<disk_var<data_t>> m_ds;
+};
@@ -0,0 +1,33 @@
+#include "grid_layout.hpp"
+
+grid_layout::grid_layout(const std::size_t H, const std::size_t W, const grid_order order) : m_H{H}, m_W{W}, m_lg_side{0}, m_side{1}, m_order{order}
+{
+    while (m_side < std::max(H, W)) { m_side <<= 1, m_lg_side++; }
+    const std::size_t cell_num = m_order == grid_order::RowMajor ? H * W : m_side * m_side;
+    m_cells.resize(cell_num, disk_var<data_t>{data_t{0}});
+}
+
+std::size_t grid_layout::index(const std::size_t i, const std::size_t j) const
+{
+    switch (m_order) {
+    case grid_order::ZOrder: return morton_encode(i, j);
+    case grid_order::Hilbert: return hilbert_encode(m_lg_side, i, j);
+    default: return i * m_W + j;
+    }
+}
+
+std::pair<std::size_t, std::size_t> grid_layout::position(const std::size_t ind) const
+{
+    switch (m_order) {
+    case grid_order::ZOrder: return morton_decode(ind);
+    case grid_order::Hilbert: return hilbert_decode(m_lg_side, ind);
+    default: return {ind / m_W, ind % m_W};
+    }
+}
+
+data_t grid_layout::range_sum(const std::size_t i0, const std::size_t j0, const std::size_t i1, const std::size_t j1) const
+{
+    data_t sum = 0;
+    for_tile(i0, j0, i1, j1, [&](const std::size_t, const std::size_t, const data_t v) { sum += v; });
+    return sum;
+}
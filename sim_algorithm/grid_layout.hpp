@@ -0,0 +1,168 @@
+#pragma once
+/**
+ * @file grid_layout.hpp
+ * @brief 2次元グリッドのレイアウト (Row Major / Z-order / Hilbert order)
+ * @note
+ * - 1次元のvEB Layout, Block Layoutに対応する2次元版
+ */
+#include <algorithm>
+#include <array>
+#include <utility>
+
+#include "common/space_filling_curve.hpp"
+#include "config.hpp"
+#include "simulator/disk_variable.hpp"
+#include "simulator/simulator.hpp"
+
+/**
+ * @brief グリッドの並べ方
+ * @details
+ * - RowMajor: 行優先 (H*Wマス)
+ * - ZOrder: Morton符号順 (一辺を2冪に切り上げた正方形)
+ * - Hilbert: Hilbert曲線順 (一辺を2冪に切り上げた正方形)
+ */
+enum class grid_order
+{
+    RowMajor,
+    ZOrder,
+    Hilbert,
+};
+
+/**
+ * @brief 2次元グリッド
+ * @details
+ * - get(i,j)/set(i,j,v): 1マスの読み書き
+ * - for_row(i,f)/for_col(j,f): 行/列を順に走査
+ * - for_tile(i0,j0,i1,j1,f): 矩形[i0,i1)x[j0,j1)をレイアウト順に走査
+ * - range_sum(i0,j0,i1,j1): 矩形[i0,i1)x[j0,j1)の総和
+ * @note
+ * - 走査関数fは f(i, j, v) の形で呼ばれる
+ * - 矩形がグリッドからはみ出す部分は無視する
+ */
+class grid_layout
+{
+public:
+    /**
+     * @brief コンストラクタ
+     * @param H[in] 行数
+     * @param W[in] 列数
+     * @param order[in] 並べ方
+     * @details 全マス0で初期化する
+     */
+    grid_layout(const std::size_t H, const std::size_t W, const grid_order order);
+
+    /**
+     * @brief (i,j)がレイアウトで何番目にあるか
+     */
+    std::size_t index(const std::size_t i, const std::size_t j) const;
+
+    /**
+     * @brief 読み込み
+     */
+    data_t get(const std::size_t i, const std::size_t j) const { return sim::read(m_cells[index(i, j)]); }
+
+    /**
+     * @brief 書き込み
+     */
+    void set(const std::size_t i, const std::size_t j, const data_t v) { sim::write(m_cells[index(i, j)], v); }
+
+    /**
+     * @brief 直接書き込み
+     * @note
+     * - 前計算でのみ使う
+     */
+    void illegal_set(const std::size_t i, const std::size_t j, const data_t v) { m_cells[index(i, j)].illegal_ref() = v; }
+
+    /**
+     * @brief i行目を左から走査
+     */
+    template<typename F>
+    void for_row(const std::size_t i, F f) const
+    {
+        if (m_order == grid_order::ZOrder) {
+            uint64_t z = morton_encode(i, 0);
+            for (std::size_t j = 0; j < m_W; j++, z = morton_next_col(z)) { f(i, j, sim::read(m_cells[z])); }
+        } else {
+            for (std::size_t j = 0; j < m_W; j++) { f(i, j, get(i, j)); }
+        }
+    }
+
+    /**
+     * @brief j列目を上から走査
+     */
+    template<typename F>
+    void for_col(const std::size_t j, F f) const
+    {
+        if (m_order == grid_order::ZOrder) {
+            uint64_t z = morton_encode(0, j);
+            for (std::size_t i = 0; i < m_H; i++, z = morton_next_row(z)) { f(i, j, sim::read(m_cells[z])); }
+        } else {
+            for (std::size_t i = 0; i < m_H; i++) { f(i, j, get(i, j)); }
+        }
+    }
+
+    /**
+     * @brief 矩形[i0,i1)x[j0,j1)をレイアウト順に走査
+     * @details
+     * - RowMajorは行ごとに走査
+     * - ZOrder/Hilbertは四分木で分割し、曲線順に子を訪れる
+     *   (完全に含まれる四分木ノードは連続領域なので先頭から順に読む)
+     */
+    template<typename F>
+    void for_tile(const std::size_t i0, const std::size_t j0, const std::size_t i1, const std::size_t j1, F f) const
+    {
+        const std::size_t ci1 = std::min(i1, m_H), cj1 = std::min(j1, m_W);
+        if (i0 >= ci1 or j0 >= cj1) { return; }
+        if (m_order == grid_order::RowMajor) {
+            for (std::size_t i = i0; i < ci1; i++) {
+                for (std::size_t j = j0; j < cj1; j++) { f(i, j, sim::read(m_cells[i * m_W + j])); }
+            }
+        } else {
+            visit(0, 0, m_side, i0, j0, ci1, cj1, f);
+        }
+    }
+
+    /**
+     * @brief 矩形[i0,i1)x[j0,j1)の総和
+     */
+    data_t range_sum(const std::size_t i0, const std::size_t j0, const std::size_t i1, const std::size_t j1) const;
+
+    /**
+     * @brief 行数
+     */
+    std::size_t height() const { return m_H; }
+
+    /**
+     * @brief 列数
+     */
+    std::size_t width() const { return m_W; }
+
+private:
+    std::pair<std::size_t, std::size_t> position(const std::size_t ind) const;
+
+    template<typename F>
+    void visit(const std::size_t qi, const std::size_t qj, const std::size_t size,
+               const std::size_t i0, const std::size_t j0, const std::size_t i1, const std::size_t j1, F& f) const
+    {
+        if (qi >= i1 or qj >= j1 or qi + size <= i0 or qj + size <= j0) { return; }
+        if (i0 <= qi and qi + size <= i1 and j0 <= qj and qj + size <= j1) {
+            const std::size_t head = index(qi, qj) & ~(size * size - 1);  // 四分木ノードの先頭
+            for (std::size_t ind = head; ind < head + size * size; ind++) {
+                const auto [i, j] = position(ind);
+                f(i, j, sim::read(m_cells[ind]));
+            }
+            return;
+        }
+        const std::size_t half = size / 2;
+        std::array<std::pair<std::size_t, std::size_t>, 4> sons{{{qi, qj}, {qi, qj + half}, {qi + half, qj}, {qi + half, qj + half}}};
+        std::sort(sons.begin(), sons.end(), [&](const auto& s1, const auto& s2) {
+            return index(s1.first, s1.second) < index(s2.first, s2.second);
+        });
+        for (const auto& [si, sj] : sons) { visit(si, sj, half, i0, j0, i1, j1, f); }
+    }
+
+    std::size_t m_H, m_W;
+    std::size_t m_lg_side, m_side;
+    grid_order m_order;
+    std::vector<disk_var<data_t>> m_cells;
+};
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <cmath>
+
+#include "common/bit.hpp"
+#include "hash_table.hpp"
+#include "simulator/simulator.hpp"
+
+namespace {
+constexpr uint64_t Seed1 = 0x9E3779B97F4A7C15ULL;
+constexpr uint64_t Seed2 = 0xC2B2AE3D27D4EB4FULL;
+
+/**
+ * n個をload以下で詰められる最小の2冪
+ */
+std::size_t capacity(const std::size_t n, const double load)
+{
+    return ceil2(std::max<std::size_t>(static_cast<std::size_t>(std::ceil(static_cast<double>(n) / load)), 1));
+}
+
+std::vector<data_t> dedup(std::vector<data_t> vs)
+{
+    std::sort(vs.begin(), vs.end());
+    vs.erase(std::unique(vs.begin(), vs.end()), vs.end());
+    return vs;
+}
+}  // anonymous namespace
+
+linear_probing_table::linear_probing_table(const std::vector<data_t>& vs, const double load)
+{
+    const auto xs = dedup(vs);
+    m_slots.resize(std::max(capacity(xs.size(), load), ceil2(xs.size() + 1)), disk_var<data_t>{hashing::Empty});  // 空きが必ず1つはある
+    m_mask = m_slots.size() - 1;
+    for (const data_t x : xs) {
+        std::size_t i = hashing::mix(x, Seed1) & m_mask;
+        while (m_slots[i].illegal_ref() != hashing::Empty) { i = (i + 1) & m_mask; }
+        m_slots[i].illegal_ref() = x;
+    }
+}
+
+bool linear_probing_table::find(const data_t x) const
+{
+    for (std::size_t i = hashing::mix(x, Seed1) & m_mask;; i = (i + 1) & m_mask) {
+        const data_t y = sim::read(m_slots[i]);
+        if (y == x) { return true; }
+        if (y == hashing::Empty) { return false; }
+    }
+}
+
+cuckoo_table::cuckoo_table(const std::vector<data_t>& vs, const double load)
+{
+    const auto xs = dedup(vs);
+    for (std::size_t num = capacity((xs.size() + BucketSize - 1) / BucketSize, load);; num *= 2) {
+        m_buckets.assign(num, disk_var<bucket_t>{});
+        m_mask = num - 1;
+        if (build(xs)) { break; }
+    }
+}
+
+bool cuckoo_table::build(const std::vector<data_t>& xs)
+{
+    for (auto& b : m_buckets) { std::fill(std::begin(b.illegal_ref().keys), std::end(b.illegal_ref().keys), hashing::Empty); }
+    uint64_t rnd = Seed1;
+    for (const data_t x : xs) {
+        if (not illegal_insert(x, rnd)) { return false; }
+    }
+    return true;
+}
+
+/**
+ * 空きがあれば入れる、なければどちらかのバケットからランダムに1つ追い出して、追い出したキーを入れ直す
+ */
+bool cuckoo_table::illegal_insert(data_t x, uint64_t& rnd)
+{
+    constexpr std::size_t MaxKicks = 500;
+    std::size_t b                  = bucket(x, 0);
+    for (std::size_t kick = 0; kick < MaxKicks; kick++) {
+        for (const std::size_t c : {bucket(x, 0), bucket(x, 1)}) {
+            auto& keys = m_buckets[c].illegal_ref().keys;
+            for (auto& key : keys) {
+                if (key == hashing::Empty) {
+                    key = x;
+                    return true;
+                }
+            }
+        }
+        rnd          = hashing::mix(rnd, Seed2);
+        b            = (b == bucket(x, 0)) ? bucket(x, 1) : bucket(x, 0);
+        const auto j = rnd % BucketSize;
+        std::swap(x, m_buckets[b].illegal_ref().keys[j]);
+    }
+    return false;
+}
+
+std::size_t cuckoo_table::bucket(const data_t x, const std::size_t i) const
+{
+    return hashing::mix(x, i == 0 ? Seed1 : Seed2) & m_mask;
+}
+
+bool cuckoo_table::find(const data_t x) const
+{
+    for (std::size_t i = 0; i < 2; i++) {
+        const bucket_t& b = sim::read(m_buckets[bucket(x, i)]);
+        if (std::find(std::begin(b.keys), std::end(b.keys), x) != std::end(b.keys)) { return true; }
+    }
+    return false;
+}
+
+swiss_table::swiss_table(const std::vector<data_t>& vs, const double load)
+{
+    const auto xs  = dedup(vs);
+    const auto num = capacity((xs.size() + GroupSize - 1) / GroupSize, load);
+    ctrl_t empty;
+    std::fill(std::begin(empty.bytes), std::end(empty.bytes), CtrlEmpty);
+    m_ctrls.assign(num, disk_var<ctrl_t>{empty});
+    m_slots.assign(num * GroupSize, disk_var<data_t>{hashing::Empty});
+    m_mask = num - 1;
+    for (const data_t x : xs) {
+        const uint64_t h = hashing::mix(x, Seed1);
+        for (std::size_t g = (h >> 7) & m_mask, step = 1;; g = (g + step++) & m_mask) {
+            auto& ctrl    = m_ctrls[g].illegal_ref().bytes;
+            const auto it = std::find(std::begin(ctrl), std::end(ctrl), CtrlEmpty);
+            if (it == std::end(ctrl)) { continue; }
+            const auto j                             = static_cast<std::size_t>(it - ctrl);
+            *it                                      = static_cast<uint8_t>(h & 0x7F);
+            m_slots[g * GroupSize + j].illegal_ref() = x;
+            break;
+        }
+    }
+}
+
+bool swiss_table::find(const data_t x) const
+{
+    const uint64_t h = hashing::mix(x, Seed1);
+    const uint8_t h2 = static_cast<uint8_t>(h & 0x7F);
+    for (std::size_t g = (h >> 7) & m_mask, step = 1;; g = (g + step++) & m_mask) {
+        const ctrl_t& ctrl = sim::read(m_ctrls[g]);
+        bool empty         = false;
+        for (std::size_t j = 0; j < GroupSize; j++) {
+            if (ctrl.bytes[j] == h2 and sim::read(m_slots[g * GroupSize + j]) == x) { return true; }
+            empty |= (ctrl.bytes[j] == CtrlEmpty);
+        }
+        if (empty) { return false; }
+    }
+}
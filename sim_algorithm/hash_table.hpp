@@ -0,0 +1,154 @@
+#pragma once
+/**
+ * @file hash_table.hpp
+ * @brief 点検索用のハッシュ表 (線形探査/Cuckoo/Swiss Table)
+ * @note
+ * - 順序が要らない検索(キーがあるかどうか)だけを扱う
+ * - 構築は前計算 (illegal_ref) で行い、find()だけをシミュレートする
+ * - Emptyは空きスロットを表す (キーはMax以下なので衝突しない)
+ */
+#include <cstdint>
+#include <vector>
+
+#include "config.hpp"
+#include "simulator/disk_variable.hpp"
+
+namespace hashing {
+
+constexpr data_t Empty = Max + 1;
+
+/**
+ * @brief splitmix64の後半 (下位ビットも上位ビットもよく混ざる)
+ */
+constexpr uint64_t mix(const data_t x, const uint64_t seed)
+{
+    uint64_t z = x + seed;
+    z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z          = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+}  // namespace hashing
+
+/**
+ * @brief 線形探査のハッシュ表
+ * @details
+ * - Find(x): xがあるかどうか
+ * @note
+ * - スロットは2冪個で、キー数/容量がload以下になるようにする
+ * - 衝突したら隣のスロットを見る (同じブロック内に続くことが多い)
+ */
+class linear_probing_table
+{
+public:
+    /**
+     * @brief コンストラクタ
+     * @param vs[in] データ配列 (重複は1つにまとめる)
+     * @param load[in] 最大充填率 (1未満, スロット数は2冪に切り上げる)
+     */
+    linear_probing_table(const std::vector<data_t>& vs, const double load = 0.5);
+
+    /**
+     * @brief Findクエリ
+     * @param x[in]
+     */
+    bool find(const data_t x) const;
+
+    /**
+     * @brief 表のバイト数
+     */
+    std::size_t bytes() const { return m_slots.size() * sizeof(data_t); }
+
+private:
+    std::size_t m_mask;
+    std::vector<disk_var<data_t>> m_slots;
+};
+
+/**
+ * @brief バケット化したCuckooハッシュ表
+ * @details
+ * - Find(x): xがあるかどうか
+ * @note
+ * - キーは2つのハッシュ関数が指すバケットのどちらかにある (見るのは高々2バケット)
+ * - 1バケットはBucketSize個のキー(1キャッシュライン)
+ * - 挿入で両方のバケットが満杯なら、追い出しを繰り返す (失敗したらバケット数を倍にして作り直す)
+ */
+class cuckoo_table
+{
+public:
+    static constexpr std::size_t BucketSize = 8;
+    struct alignas(64) bucket_t
+    {
+        data_t keys[BucketSize];
+    };
+
+    /**
+     * @brief コンストラクタ
+     * @param vs[in] データ配列 (重複は1つにまとめる)
+     * @param load[in] 最大充填率 (1未満, スロット数は2冪に切り上げる)
+     */
+    cuckoo_table(const std::vector<data_t>& vs, const double load = 0.9);
+
+    /**
+     * @brief Findクエリ
+     * @param x[in]
+     */
+    bool find(const data_t x) const;
+
+    /**
+     * @brief 表のバイト数
+     */
+    std::size_t bytes() const { return m_buckets.size() * sizeof(bucket_t); }
+
+private:
+    bool build(const std::vector<data_t>& vs);
+    bool illegal_insert(data_t x, uint64_t& rnd);
+    std::size_t bucket(const data_t x, const std::size_t i) const;
+
+    std::size_t m_mask;
+    std::vector<disk_var<bucket_t>> m_buckets;
+};
+
+/**
+ * @brief Swiss Table (グループ単位で制御バイトを比べるハッシュ表)
+ * @details
+ * - Find(x): xがあるかどうか
+ * @note
+ * - ハッシュ値の上位(h1)でグループを選び、下位7bit(h2)を制御バイトに入れる
+ * - 1グループはGroupSize個のスロットで、制御バイトは別の配列にまとめる (16byte)
+ * - 制御バイトでh2が一致したスロットだけキーを読む
+ * - グループに空き(CtrlEmpty)があれば探索を打ち切る、なければ次のグループへ (三角数で飛ぶ)
+ */
+class swiss_table
+{
+public:
+    static constexpr std::size_t GroupSize = 16;
+    static constexpr uint8_t CtrlEmpty     = 0x80;
+    struct alignas(GroupSize) ctrl_t
+    {
+        uint8_t bytes[GroupSize];
+    };
+
+    /**
+     * @brief コンストラクタ
+     * @param vs[in] データ配列 (重複は1つにまとめる)
+     * @param load[in] 最大充填率 (1未満, スロット数は2冪に切り上げる)
+     */
+    swiss_table(const std::vector<data_t>& vs, const double load = 0.875);
+
+    /**
+     * @brief Findクエリ
+     * @param x[in]
+     */
+    bool find(const data_t x) const;
+
+    /**
+     * @brief 表のバイト数
+     */
+    std::size_t bytes() const { return m_ctrls.size() * sizeof(ctrl_t) + m_slots.size() * sizeof(data_t); }
+
+private:
+    std::size_t m_mask;
+    std::vector<disk_var<ctrl_t>> m_ctrls;
+    std::vector<disk_var<data_t>> m_slots;
+};
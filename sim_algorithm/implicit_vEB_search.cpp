@@ -0,0 +1,58 @@
+#include <algorithm>
+
+#include "common/bit.hpp"
+#include "common/tree_layout.hpp"
+#include "implicit_vEB_search.hpp"
+#include "simulator/simulator.hpp"
+
+implicit_vEB_search::implicit_vEB_search(std::vector<data_t> vs)
+{
+    const std::size_t N                   = vs.size();
+    const std::size_t TN                  = N == 0 ? 1 : ceil2(N + 1) - 1;  // 空なら番兵(Max+1)1個だけの木
+    const std::size_t ROOT                = (TN + 1) / 2;
+    const std::vector<std::size_t> orders = layout::vEB_orders(ROOT);  // 1-indexed
+    std::sort(vs.begin(), vs.end());
+    for (std::size_t i = 0; i < TN; i++) {
+        const std::size_t order = orders[i];
+        m_xs.push_back(order > N ? data_t{Max + 1} : vs[order - 1]);
+    }
+    m_height = lsb(ROOT) + 1;
+    m_tops.resize(m_height), m_bottoms.resize(m_height), m_top_depths.resize(m_height);
+    build_tables(0, m_height);
+}
+
+/**
+ * 深さdepthを根とする高さheightの部分木の分割を表に書く (layout::vEB_ordersと同じ分け方)
+ */
+void implicit_vEB_search::build_tables(const std::size_t depth, const std::size_t height)
+{
+    if (height == 1) { return; }
+    const std::size_t uh     = height / 2;
+    const std::size_t dh     = height - uh;
+    m_tops[depth + uh]       = (1UL << uh) - 1;
+    m_bottoms[depth + uh]    = (1UL << dh) - 1;
+    m_top_depths[depth + uh] = depth;
+    build_tables(depth, uh);
+    build_tables(depth + uh, dh);
+}
+
+data_t implicit_vEB_search::lower_bound(const data_t v) const
+{
+    data_t ans = Max + 1;
+    std::size_t poss[64];  // poss[d]: 今いる頂点の深さdの祖先の位置
+    poss[0]       = 0;
+    std::size_t i = 1;  // BFS番号
+    for (std::size_t d = 0;;) {
+        const data_t x = sim::read(m_xs[poss[d]]);
+        if (x == v) { return v; }
+        if (x < v) {
+            i = 2 * i + 1;
+        } else {
+            ans = x;
+            i   = 2 * i;
+        }
+        if (++d == m_height) { break; }
+        poss[d] = poss[m_top_depths[d]] + m_tops[d] + (i & m_tops[d]) * m_bottoms[d];
+    }
+    return ans;
+}
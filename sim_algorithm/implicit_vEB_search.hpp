@@ -0,0 +1,49 @@
+#pragma once
+/**
+ * @file implicit_vEB_search.hpp
+ * @brief ポインタを持たないvEB Layoutを用いたCache Obliviousな二分探索
+ * @note
+ * - 静的なデータのみを扱う
+ * - 子の位置は深さごとの表から計算する (Brodal-Fagerberg-Jacob)
+ */
+#include "config.hpp"
+#include "simulator/data_cache.hpp"
+#include "simulator/disk_variable.hpp"
+
+/**
+ * @brief キーだけをvEB Layoutで保持する構造体
+ * @details
+ * - LowerBound(x): データのうちx以上の最小の値を返す
+ * @note
+ * 深さdの頂点について、それを根とする下の部分木が切り出された再帰段での
+ * - m_tops[d]: 上の部分木のサイズ
+ * - m_bottoms[d]: 下の部分木のサイズ
+ * - m_top_depths[d]: 上の部分木の根の深さ
+ * を持つ。BFS番号iの頂点の位置は pos[d] = pos[m_top_depths[d]] + m_tops[d] + (i & m_tops[d]) * m_bottoms[d]
+ * (表はO(log N)なのでキャッシュに乗っているとみなし、ディスク上には置かない)
+ *
+ * 子の位置を計算で求めるため、vEB_searchと違って完全二分木に番兵(Max+1)を詰めて持つ
+ * (間引く葉はvEBの並びのあちこちに散るので、左詰めにはしない。Nが2冪を少し超えると約2倍のメモリを使う)
+ */
+class implicit_vEB_search
+{
+public:
+    /**
+     * @brief コンストラクタ     
+     * @param vs[in] データ配列
+     */
+    implicit_vEB_search(std::vector<data_t> vs);
+
+    /**
+     * @brief LowerBoundクエリ
+     * @param x[in] 
+     */
+    data_t lower_bound(const data_t v) const;
+
+private:
+    void build_tables(const std::size_t depth, const std::size_t height);
+
+    std::size_t m_height;
+    std::vector<std::size_t> m_tops, m_bottoms, m_top_depths;
+    std::vector<disk_var<data_t>> m_xs;
+};
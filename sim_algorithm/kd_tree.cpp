@@ -0,0 +1,124 @@
+#include <algorithm>
+
+#include "common/bit.hpp"
+#include "common/tree_layout.hpp"
+#include "kd_tree.hpp"
+#include "simulator/simulator.hpp"
+
+namespace {
+
+using point_t = kd_tree::point_t;
+using dist_t  = kd_tree::dist_t;
+
+inline kd_tree::coord_t coord(const point_t& p, const std::size_t depth)
+{
+    return depth % 2 == 0 ? p.first : p.second;
+}
+
+inline dist_t dist(const point_t& p, const kd_tree::coord_t x, const kd_tree::coord_t y)
+{
+    const dist_t dx = p.first > x ? p.first - x : x - p.first;
+    const dist_t dy = p.second > y ? p.second - y : y - p.second;
+    return dx * dx + dy * dy;
+}
+
+/**
+ * 頂点n以下の部分木に[first,last)の点を割り当てる (中央値を頂点nに置く)
+ */
+void build(const std::size_t n, const std::size_t depth, std::vector<point_t>::iterator first, std::vector<point_t>::iterator last, std::vector<point_t>& nodes)
+{
+    const auto mid = first + (last - first) / 2;
+    std::nth_element(first, mid, last, [&](const point_t& p1, const point_t& p2) { return coord(p1, depth) < coord(p2, depth); });
+    nodes[n] = *mid;
+    if ((n & 1UL) == 0) {
+        build(layout::left(n), depth + 1, first, mid, nodes);
+        build(layout::right(n), depth + 1, mid + 1, last, nodes);
+    }
+}
+
+}  // anonymous namespace
+
+kd_tree::kd_tree(std::vector<point_t> ps, const kd_order order)
+{
+    const std::size_t N    = ps.size();
+    const std::size_t TN   = N == 0 ? 1 : ceil2(N + 1) - 1;  // 空なら番兵1個だけの木
+    const std::size_t ROOT = (TN + 1) / 2;
+    ps.resize(TN, point_t{Sentinel, Sentinel});
+    std::vector<point_t> nodes(TN + 1);
+    build(ROOT, 0, ps.begin(), ps.end(), nodes);
+
+    const std::vector<std::size_t> orders = order == kd_order::BFS ? layout::bfs_orders(ROOT) : order == kd_order::DFS ? layout::dfs_orders(ROOT) : layout::vEB_orders(ROOT);  // 1-indexed
+    std::vector<std::size_t> poss(TN + 1);
+    for (std::size_t i = 0; i < TN; i++) {
+        poss[orders[i]] = i;
+    }
+    m_root_pos = poss[ROOT];
+    for (std::size_t i = 0; i < TN; i++) {
+        const std::size_t n = orders[i];
+        m_ps.push_back(disk_var<point_t>{nodes[n]});
+        if ((n & 1UL) == 0) {
+            m_ls.push_back(poss[layout::left(n)]);
+            m_rs.push_back(poss[layout::right(n)]);
+        } else {
+            m_ls.push_back(static_cast<std::size_t>(-1));
+            m_rs.push_back(static_cast<std::size_t>(-1));
+        }
+    }
+}
+
+std::size_t kd_tree::range_count(const coord_t x0, const coord_t y0, const coord_t x1, const coord_t y1) const
+{
+    std::size_t count = 0;
+    auto f            = [&](const point_t&) { count++; };
+    range(m_root_pos, 0, x0, y0, x1, y1, f);
+    return count;
+}
+
+std::vector<point_t> kd_tree::range_search(const coord_t x0, const coord_t y0, const coord_t x1, const coord_t y1) const
+{
+    std::vector<point_t> ps;
+    auto f = [&](const point_t& p) { ps.push_back(p); };
+    range(m_root_pos, 0, x0, y0, x1, y1, f);
+    return ps;
+}
+
+point_t kd_tree::nearest(const coord_t x, const coord_t y) const
+{
+    point_t best     = {Sentinel, Sentinel};
+    dist_t best_dist = ~dist_t{0};
+    nearest(m_root_pos, 0, x, y, best, best_dist);
+    return best;
+}
+
+/**
+ * 分割値sに対して、左の子孫は s以下・右の子孫は s以上
+ * - 左: 範囲の下端 <= s なら見る
+ * - 右: s < 範囲の上端 なら見る
+ * - 番兵は報告しない (座標が最大なので右の子孫は見ない)
+ */
+template<typename F>
+void kd_tree::range(const std::size_t pos, const std::size_t depth, const coord_t x0, const coord_t y0, const coord_t x1, const coord_t y1, F& f) const
+{
+    if (pos == static_cast<std::size_t>(-1)) { return; }
+    const point_t p = sim::read(m_ps[pos]);
+    if (p.first != Sentinel and x0 <= p.first and p.first < x1 and y0 <= p.second and p.second < y1) { f(p); }
+    const coord_t s  = coord(p, depth);
+    const coord_t lo = depth % 2 == 0 ? x0 : y0, hi = depth % 2 == 0 ? x1 : y1;
+    if (lo <= s) { range(sim::read(m_ls[pos]), depth + 1, x0, y0, x1, y1, f); }
+    if (s < hi) { range(sim::read(m_rs[pos]), depth + 1, x0, y0, x1, y1, f); }
+}
+
+/**
+ * 質問点を含む側から先に降り、分割線までの距離が暫定解未満なら反対側も見る
+ */
+void kd_tree::nearest(const std::size_t pos, const std::size_t depth, const coord_t x, const coord_t y, point_t& best, dist_t& best_dist) const
+{
+    if (pos == static_cast<std::size_t>(-1)) { return; }
+    const point_t p = sim::read(m_ps[pos]);
+    const dist_t d  = dist(p, x, y);
+    if (p.first != Sentinel and d < best_dist) { best = p, best_dist = d; }
+    const coord_t s = coord(p, depth), q = depth % 2 == 0 ? x : y;
+    nearest(sim::read(q < s ? m_ls[pos] : m_rs[pos]), depth + 1, x, y, best, best_dist);
+    const dist_t gap = q < s ? s - q : q - s;
+    if (gap * gap < best_dist) { nearest(sim::read(q < s ? m_rs[pos] : m_ls[pos]), depth + 1, x, y, best, best_dist); }
+}
@@ -0,0 +1,76 @@
+#pragma once
+/**
+ * @file kd_tree.hpp
+ * @brief 2次元の静的k-d木
+ * @note
+ * - 静的なデータのみを扱う
+ * - 頂点の並べ方(BFS順/DFS順/vEB Layout)を選べる
+ */
+#include <limits>
+#include <utility>
+
+#include "config.hpp"
+#include "simulator/disk_variable.hpp"
+
+/**
+ * @brief 頂点の並べ方
+ */
+enum class kd_order
+{
+    BFS,
+    DFS,
+    vEB,
+};
+
+/**
+ * @brief 2次元k-d木
+ * @details
+ * - 深さdの頂点はd%2番目の座標で分割する (左の子孫 <= 分割値 <= 右の子孫)
+ * - RangeCount(x0,y0,x1,y1): [x0,x1)x[y0,y1)に含まれる点の個数
+ * - RangeSearch(x0,y0,x1,y1): [x0,x1)x[y0,y1)に含まれる点
+ * - Nearest(x,y): ユークリッド距離が最小の点
+ * @note
+ * - 完全二分木にするため足りない頂点は番兵(Sentinel)で埋める
+ * - 座標はSentinel未満とする
+ */
+class kd_tree
+{
+public:
+    using coord_t                     = uint32_t;
+    using point_t                     = std::pair<coord_t, coord_t>;
+    using dist_t                      = unsigned __int128;  // 距離の2乗 (座標の差が2^32近くになると64bitに収まらない)
+    static constexpr coord_t Sentinel = std::numeric_limits<coord_t>::max();
+
+    /**
+     * @brief コンストラクタ
+     * @param ps[in] 点の配列
+     * @param order[in] 頂点の並べ方
+     */
+    kd_tree(std::vector<point_t> ps, const kd_order order);
+
+    /**
+     * @brief 矩形に含まれる点の個数
+     */
+    std::size_t range_count(const coord_t x0, const coord_t y0, const coord_t x1, const coord_t y1) const;
+
+    /**
+     * @brief 矩形に含まれる点
+     */
+    std::vector<point_t> range_search(const coord_t x0, const coord_t y0, const coord_t x1, const coord_t y1) const;
+
+    /**
+     * @brief 最近点
+     * @note
+     * - 点が1つもないときは(Sentinel,Sentinel)
+     */
+    point_t nearest(const coord_t x, const coord_t y) const;
+
+private:
+    template<typename F>
+    void range(const std::size_t pos, const std::size_t depth, const coord_t x0, const coord_t y0, const coord_t x1, const coord_t y1, F& f) const;
+    void nearest(const std::size_t pos, const std::size_t depth, const coord_t x, const coord_t y, point_t& best, dist_t& best_dist) const;
+
+    std::size_t m_root_pos;
+    std::vector<disk_var<std::size_t>> m_ls, m_rs;
+    std::vector<disk_var<point_t>> m_ps;
+};
@@ -0,0 +1,174 @@
+#pragma once
+/**
+ * @file packed_b_tree.hpp
+ * @brief 頂点を1ブロックに詰めたB-木
+ * @note
+ * - b_treeは1頂点のkeys/sons/leafが別々の領域にあるので、1頂点を読むのに複数ブロック読む
+ * - ここでは頂点を固定長(NodeBytes)の構造体にし、NodeBytes境界に置いて1頂点=1ブロックにする
+ * - 子はポインタではなく頂点配列(アリーナ)の添字で持つ
+ */
+#include <cstdint>
+#include <vector>
+
+#include "config.hpp"
+#include "simulator/disk_variable.hpp"
+#include "simulator/simulator.hpp"
+
+/**
+ * @brief 頂点を1ブロックに詰めたB-木
+ * @details
+ * - NodeBytes: 頂点のバイト数 (2冪, シミュレータのBと揃えると1頂点=1ブロックになる)
+ * - 頂点のキー数は最大Capacity (根以外はCapacity/2以上)
+ * - 頂点内は二分探索する
+ * @note
+ * b_treeと同じく以下が成立している
+ * - keysは昇順
+ * - sons[i]に含まれるキーは、keys[i-1]以上＆keys[i]以下 (重複したキーは両側にありうる)
+ */
+template<std::size_t NodeBytes>
+class packed_b_tree
+{
+public:
+    using index_t                         = uint32_t;
+    static constexpr std::size_t Capacity = (NodeBytes - 3 * sizeof(index_t)) / (sizeof(data_t) + sizeof(index_t));
+    static_assert((NodeBytes & (NodeBytes - 1)) == 0, "NodeBytes must be a power of 2");
+    static_assert(Capacity >= 3, "NodeBytes is too small");
+
+    /**
+     * @brief 頂点 (キー数/葉かどうか/キー/子の添字)
+     */
+    struct alignas(NodeBytes) node_t
+    {
+        disk_var<index_t> count;
+        disk_var<index_t> leaf;
+        disk_var<data_t> keys[Capacity];
+        disk_var<index_t> sons[Capacity + 1];
+    };
+    static_assert(sizeof(node_t) == NodeBytes, "node_t must be NodeBytes");
+
+    /**
+     * @brief コンストラクタ
+     * @param datas[in] 初期データ
+     */
+    packed_b_tree(const std::vector<data_t>& datas) : m_nodes(1)
+    {
+        m_nodes.reserve(datas.size() / (Capacity / 2) + 1);
+        m_nodes[0].leaf.illegal_ref() = 1;
+        for (const auto data : datas) { illegal_insert(data); }
+    }
+
+    /**
+     * @brief LowerBound
+     * @param key[in] キー
+     */
+    data_t lower_bound(const data_t key) const
+    {
+        data_t ans = Max + 1;
+        for (index_t k = m_root;;) {
+            const node_t& node  = m_nodes[k];
+            const std::size_t i = rank(node, key);
+            if (i < sim::read(node.count)) {
+                const data_t x = sim::read(node.keys[i]);
+                if (x == key) { return x; }
+                ans = x;
+            }
+            if (sim::read(node.leaf)) { break; }
+            k = sim::read(node.sons[i]);
+        }
+        return ans;
+    }
+
+    /**
+     * @brief 頂点数
+     */
+    std::size_t node_num() const { return m_nodes.size(); }
+
+    /**
+     * @brief 高さ (根だけなら1)
+     */
+    std::size_t height() const
+    {
+        std::size_t h = 1;
+        for (index_t k = m_root; not m_nodes[k].leaf.illegal_ref(); k = m_nodes[k].sons[0].illegal_ref()) { h++; }
+        return h;
+    }
+
+private:
+    /**
+     * @brief 頂点内でkey未満のキーの個数 (二分探索)
+     */
+    static std::size_t rank(const node_t& node, const data_t key)
+    {
+        std::size_t inf = 0, sup = sim::read(node.count);
+        while (inf < sup) {
+            const std::size_t mid = (inf + sup) / 2;
+            (sim::read(node.keys[mid]) < key ? inf = mid + 1 : sup = mid);
+        }
+        return inf;
+    }
+
+    index_t alloc()
+    {
+        m_nodes.emplace_back();
+        return static_cast<index_t>(m_nodes.size() - 1);
+    }
+
+    /**
+     * 満杯の子sons[i]を真ん中のキーで2つに分け、真ん中のキーをxに上げる
+     * (alloc()で頂点が動くので参照は確保後に取る)
+     */
+    void split_child(const index_t x, const std::size_t i)
+    {
+        const index_t z = alloc();
+        const index_t y = m_nodes[x].sons[i].illegal_ref();
+        node_t& xn      = m_nodes[x];
+        node_t& yn      = m_nodes[y];
+        node_t& zn      = m_nodes[z];
+        assert(yn.count.illegal_ref() == Capacity);
+        constexpr std::size_t Mid = Capacity / 2;
+        zn.leaf.illegal_ref()     = yn.leaf.illegal_ref();
+        zn.count.illegal_ref()    = static_cast<index_t>(Capacity - Mid - 1);
+        for (std::size_t j = 0; j < Capacity - Mid - 1; j++) { zn.keys[j] = yn.keys[j + Mid + 1]; }
+        if (not yn.leaf.illegal_ref()) {
+            for (std::size_t j = 0; j < Capacity - Mid; j++) { zn.sons[j] = yn.sons[j + Mid + 1]; }
+        }
+        const std::size_t n = xn.count.illegal_ref();
+        for (std::size_t j = n; j > i; j--) {
+            xn.keys[j]     = xn.keys[j - 1];
+            xn.sons[j + 1] = xn.sons[j];
+        }
+        xn.keys[i]              = yn.keys[Mid];
+        xn.sons[i + 1]          = disk_var<index_t>{z};
+        xn.count.illegal_ref()  = static_cast<index_t>(n + 1);
+        yn.count.illegal_ref()  = static_cast<index_t>(Mid);
+    }
+
+    void illegal_insert(const data_t key)
+    {
+        if (m_nodes[m_root].count.illegal_ref() == Capacity) {
+            const index_t s               = alloc();
+            m_nodes[s].sons[0]            = disk_var<index_t>{m_root};
+            m_root                        = s;
+            split_child(m_root, 0);
+        }
+        for (index_t x = m_root;;) {
+            node_t& xn    = m_nodes[x];
+            std::size_t i = xn.count.illegal_ref();
+            if (xn.leaf.illegal_ref()) {
+                for (; i > 0 and key < xn.keys[i - 1].illegal_ref(); i--) { xn.keys[i] = xn.keys[i - 1]; }
+                xn.keys[i] = disk_var<data_t>{key};
+                xn.count.illegal_ref()++;
+                return;
+            }
+            while (i > 0 and key < xn.keys[i - 1].illegal_ref()) { i--; }
+            if (m_nodes[xn.sons[i].illegal_ref()].count.illegal_ref() == Capacity) {
+                split_child(x, i);
+                if (key >= m_nodes[x].keys[i].illegal_ref()) { i++; }
+            }
+            x = m_nodes[x].sons[i].illegal_ref();
+        }
+    }
+
+    index_t m_root = 0;
+    std::vector<node_t> m_nodes;
+};
@@ -0,0 +1,123 @@
+#pragma once
+/**
+ * @file query_batch.hpp
+ * @brief クエリをまとめて処理するための補助
+ * @note
+ * - クエリ列もディスク上に置き、並べ替えと答えの書き戻しもシミュレートする
+ * - 並べ替えはB,Mを使う外部マージソート (O((Q/B)log_{M/B}(Q/B))回)
+ */
+#include <algorithm>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "config.hpp"
+#include "simulator/simulator.hpp"
+
+namespace batch {
+
+using query_t   = std::pair<data_t, std::size_t>;  // (値, 元の位置)
+using queries_t = std::vector<disk_var<query_t>>;
+using iter_t    = disk_var<query_t>*;
+
+/**
+ * @brief qsをlessの順に外部マージソートする
+ * @param qs[in,out] ディスク上の列
+ * @param B[in] ブロックサイズ
+ * @param M[in] キャッシュサイズ
+ * @param less[in] 比較関数
+ * @details
+ * - M/2に収まる長さの連をキャッシュ上で並べて書き戻す
+ * - 連をM/(2B)本ずつまとめてマージする (各連の読み込み中のブロックと書き出し先のブロックがキャッシュに残る)
+ * - キャッシュに載っている分 (連の中身とマージ中の各連の先頭) はシミュレートしない
+ */
+template<typename Less>
+void external_sort(queries_t& qs, const std::size_t B, const std::size_t M, Less less)
+{
+    const std::size_t N      = qs.size();
+    const std::size_t run    = std::max<std::size_t>(M / 2 / sizeof(disk_var<query_t>), 1);
+    const std::size_t fan_in = std::max<std::size_t>(M / B / 2, 2);
+    std::vector<query_t> buf;
+    for (std::size_t l = 0; l < N; l += run) {
+        const std::size_t r = std::min(l + run, N);
+        buf.clear();
+        for (std::size_t i = l; i < r; i++) { buf.push_back(sim::read(qs[i])); }
+        std::sort(buf.begin(), buf.end(), less);
+        for (std::size_t i = l; i < r; i++) { sim::write(qs[i], buf[i - l]); }
+    }
+    using head_t       = std::pair<query_t, std::size_t>;  // (連の先頭, 連の番号)
+    const auto greater = [&less](const head_t& a, const head_t& b) { return less(b.first, a.first); };
+    queries_t tmp(N);
+    for (std::size_t width = run; width < N; width *= fan_in) {
+        for (std::size_t l = 0; l < N; l += width * fan_in) {
+            std::vector<std::size_t> poss, ends;
+            std::priority_queue<head_t, std::vector<head_t>, decltype(greater)> heads(greater);
+            for (std::size_t s = l; s < std::min(l + width * fan_in, N); s += width) {
+                heads.push({sim::read(qs[s]), poss.size()});
+                poss.push_back(s + 1);
+                ends.push_back(std::min(s + width, N));
+            }
+            for (std::size_t i = l; not heads.empty(); i++) {
+                const auto [q, j] = heads.top();
+                heads.pop();
+                sim::write(tmp[i], q);
+                if (poss[j] < ends[j]) { heads.push({sim::read(qs[poss[j]++]), j}); }
+            }
+        }
+        std::swap(qs, tmp);
+    }
+}
+
+/**
+ * @brief クエリをディスクに書き出して値の昇順に並べる
+ * @param qs[in] クエリの配列
+ * @param B[in] ブロックサイズ
+ * @param M[in] キャッシュサイズ
+ */
+inline queries_t sorted_queries(const std::vector<data_t>& qs, const std::size_t B, const std::size_t M)
+{
+    queries_t sorted(qs.size());
+    for (std::size_t i = 0; i < qs.size(); i++) { sim::write(sorted[i], query_t{qs[i], i}); }
+    external_sort(sorted, B, M, [](const query_t& a, const query_t& b) { return a < b; });
+    return sorted;
+}
+
+/**
+ * @brief [first,last)のうち値がv以上の最初の位置
+ */
+inline iter_t lower(const iter_t first, const iter_t last, const data_t v)
+{
+    return std::partition_point(first, last, [v](const disk_var<query_t>& q) { return sim::read(q).first < v; });
+}
+
+/**
+ * @brief [first,last)のうち値がvより大きい最初の位置
+ */
+inline iter_t upper(const iter_t first, const iter_t last, const data_t v)
+{
+    return std::partition_point(first, last, [v](const disk_var<query_t>& q) { return sim::read(q).first <= v; });
+}
+
+/**
+ * @brief [first,last)の値を答えansで上書きする
+ */
+inline void answer(iter_t first, const iter_t last, const data_t ans)
+{
+    for (; first != last; first++) { sim::write(*first, query_t{ans, sim::read(*first).second}); }
+}
+
+/**
+ * @brief 答えで上書きしたクエリ列を元の順に戻して読み出す
+ * @param qs[in] 全クエリに答えたクエリ列
+ * @param B[in] ブロックサイズ
+ * @param M[in] キャッシュサイズ
+ */
+inline std::vector<data_t> answers(queries_t& qs, const std::size_t B, const std::size_t M)
+{
+    external_sort(qs, B, M, [](const query_t& a, const query_t& b) { return a.second < b.second; });
+    std::vector<data_t> out(qs.size());
+    for (std::size_t i = 0; i < qs.size(); i++) { out[i] = sim::read(qs[i]).first; }
+    return out;
+}
+
+}  // namespace batch
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <cmath>
+
+#include "rmi_search.hpp"
+#include "simulator/simulator.hpp"
+
+namespace {
+/**
+ * 最小二乗法で pos ~ slope * x + icpt を求める (傾きは負にしない)
+ */
+rmi_search::model_t fit(const std::vector<data_t>& xs, const std::vector<double>& ps, const std::size_t first, const std::size_t last)
+{
+    rmi_search::model_t model{0.0, 0.0, 0, 0};
+    if (first == last) { return model; }
+    const double n = static_cast<double>(last - first);
+    double mx      = 0.0;
+    double mp      = 0.0;
+    for (std::size_t i = first; i < last; i++) {
+        mx += static_cast<double>(xs[i]) / n;
+        mp += ps[i] / n;
+    }
+    double sxx = 0.0;
+    double sxp = 0.0;
+    for (std::size_t i = first; i < last; i++) {
+        const double dx = static_cast<double>(xs[i]) - mx;
+        sxx += dx * dx;
+        sxp += dx * (ps[i] - mp);
+    }
+    model.slope = sxx > 0.0 ? std::max(sxp / sxx, 0.0) : 0.0;
+    model.icpt  = mp - model.slope * mx;
+    return model;
+}
+}  // anonymous namespace
+
+rmi_search::rmi_search(std::vector<data_t> vs, const std::size_t model_num) : m_models(model_num)
+{
+    std::sort(vs.begin(), vs.end());
+    const std::size_t N = vs.size();
+    m_xs.resize(N + 1);
+    for (std::size_t i = 0; i < N; i++) { m_xs[i].illegal_ref() = vs[i]; }
+    m_xs[N].illegal_ref() = Max + 1;
+
+    // 1段目: キー -> モデル番号 (の実数値)
+    std::vector<double> ps(N);
+    for (std::size_t i = 0; i < N; i++) { ps[i] = static_cast<double>(i) * static_cast<double>(model_num) / static_cast<double>(N); }
+    m_root = fit(vs, ps, 0, N);
+
+    // 2段目: 担当するキー(1段目の予測で振り分ける, 単調なので区間になる) -> 位置
+    for (std::size_t i = 0; i < N; i++) { ps[i] = static_cast<double>(i); }
+    for (std::size_t m = 0, first = 0; m < model_num; m++) {
+        std::size_t last = first;
+        while (last < N and select(vs[last]) == m) { last++; }
+        model_t model = fit(vs, ps, first, last);
+        for (std::size_t i = first; i < last; i++) {
+            const auto p = static_cast<long long>(std::clamp(predict(model, vs[i]), 0.0, static_cast<double>(N)));
+            const auto a = static_cast<long long>(i);
+            model.lo_err = std::max(model.lo_err, static_cast<uint32_t>(std::max(p - a, 0LL)));
+            model.hi_err = std::max(model.hi_err, static_cast<uint32_t>(std::max(a - p, 0LL)));
+        }
+        m_models[m].illegal_ref() = model;
+        first                     = last;
+    }
+}
+
+data_t rmi_search::lower_bound(const data_t v) const
+{
+    const std::size_t N  = m_xs.size() - 1;
+    const model_t& model = sim::read(m_models[select(v)]);
+    // 遠いクエリの予測はlong longに収まらないことがあるので、実数のまま[0, N]に抑えてから整数にする
+    const auto p         = static_cast<long long>(std::clamp(predict(model, v), 0.0, static_cast<double>(N)));
+    const std::size_t lo = static_cast<std::size_t>(std::clamp(p - static_cast<long long>(model.lo_err), 0LL, static_cast<long long>(N)));
+    const std::size_t hi = static_cast<std::size_t>(std::clamp(p + static_cast<long long>(model.hi_err) + 1, static_cast<long long>(lo), static_cast<long long>(N)));
+    std::size_t i        = search(lo, hi, v);
+    // 範囲の端なら答えは外にあるかもしれない (キー以外のクエリのみ)
+    // 端から倍々に範囲を広げて、答えを挟んだら二分探索する
+    if (i == lo and lo > 0 and sim::read(m_xs[lo - 1]) >= v) {
+        std::size_t r = lo - 1, step = 1;  // m_xs[r] >= v
+        for (; r > 0 and sim::read(m_xs[r - std::min(step, r)]) >= v; step *= 2) { r -= std::min(step, r); }
+        i = search(r - std::min(step, r), r, v);
+    } else if (i == hi and hi < N) {
+        std::size_t l = hi, step = 1;  // m_xs[l - 1] < v
+        for (; l < N and sim::read(m_xs[std::min(l + step, N) - 1]) < v; step *= 2) { l = std::min(l + step, N); }
+        i = search(l, std::min(l + step, N), v);
+    }
+    return sim::read(m_xs[i]);
+}
+
+double rmi_search::mean_error() const
+{
+    double sum = 0.0;
+    for (const auto& model : m_models) { sum += model.illegal_ref().lo_err + model.illegal_ref().hi_err; }
+    return m_models.empty() ? 0.0 : sum / static_cast<double>(m_models.size());
+}
+
+std::size_t rmi_search::select(const data_t v) const
+{
+    const double m = predict(m_root, v);
+    return static_cast<std::size_t>(std::clamp(m, 0.0, static_cast<double>(m_models.size() - 1)));
+}
+
+double rmi_search::predict(const model_t& model, const data_t v)
+{
+    return model.slope * static_cast<double>(v) + model.icpt;
+}
+
+/**
+ * [lo, hi)の中でv以上の最初の位置 (なければhi)
+ */
+std::size_t rmi_search::search(std::size_t lo, std::size_t hi, const data_t v) const
+{
+    while (lo < hi) {
+        const std::size_t mid = (lo + hi) / 2;
+        (sim::read(m_xs[mid]) < v ? lo = mid + 1 : hi = mid);
+    }
+    return lo;
+}
@@ -0,0 +1,68 @@
+#pragma once
+/**
+ * @file rmi_search.hpp
+ * @brief 2段のRecursive Model Index(RMI)を用いた探索
+ * @note
+ * - 静的なデータのみを扱う
+ * - 比較で根から降りる代わりに、キーからソート済み配列上の位置を線形モデルで予測する
+ */
+#include <vector>
+
+#include "config.hpp"
+#include "simulator/disk_variable.hpp"
+
+/**
+ * @brief RMIでデータを保持する構造体
+ * @details
+ * - LowerBound(x): データのうちx以上の最小の値を返す
+ * @note
+ * - 1段目のモデル(1個)でxから2段目のモデルを選び、2段目のモデルでxの位置を予測する
+ * - 2段目のモデルは、担当するキーに対する予測誤差の最大値を持つ (この範囲だけ二分探索する)
+ * - キー以外のクエリでは答えが範囲の外にあり得るので、範囲の端に来たら外側に倍々で広げて探す
+ */
+class rmi_search
+{
+public:
+    /**
+     * @brief 線形モデル (pos = slope * x + icpt, 誤差は [pos - lo_err, pos + hi_err])
+     */
+    struct model_t
+    {
+        double slope;
+        double icpt;
+        uint32_t lo_err;
+        uint32_t hi_err;
+    };
+
+    /**
+     * @brief コンストラクタ
+     * @param vs[in] データ配列
+     * @param model_num[in] 2段目のモデル数
+     */
+    rmi_search(std::vector<data_t> vs, const std::size_t model_num);
+
+    /**
+     * @brief LowerBoundクエリ
+     * @param v[in]
+     */
+    data_t lower_bound(const data_t v) const;
+
+    /**
+     * @brief モデルのバイト数
+     */
+    std::size_t model_bytes() const { return (m_models.size() + 1) * sizeof(model_t); }
+
+    /**
+     * @brief 予測誤差(lo_err + hi_err)の平均
+     */
+    double mean_error() const;
+
+private:
+    std::size_t select(const data_t v) const;
+    static double predict(const model_t& model, const data_t v);
+    std::size_t search(std::size_t lo, std::size_t hi, const data_t v) const;
+
+    model_t m_root;  // 1段目のモデル (常にレジスタにあるとみなす)
+    std::vector<disk_var<model_t>> m_models;
+    std::vector<disk_var<data_t>> m_xs;  // 末尾は番兵(Max+1)
+};
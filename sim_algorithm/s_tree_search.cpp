@@ -0,0 +1,47 @@
+#include <algorithm>
+
+#include "s_tree_search.hpp"
+#include "simulator/simulator.hpp"
+
+namespace {
+
+constexpr std::size_t child(const std::size_t k, const std::size_t i)
+{
+    return k * (s_tree_search::NodeSize + 1) + i + 1;
+}
+
+}  // anonymous namespace
+
+s_tree_search::s_tree_search(std::vector<data_t> vs) : m_nodes((vs.size() + NodeSize - 1) / NodeSize)
+{
+    std::sort(vs.begin(), vs.end());
+    std::size_t i = 0;
+    build(vs, i, 0);
+}
+
+/**
+ * 頂点k以下の部分木に昇順の値を中順で詰める (余りはMax+1)
+ */
+void s_tree_search::build(const std::vector<data_t>& vs, std::size_t& i, const std::size_t k)
+{
+    if (k >= m_nodes.size()) { return; }
+    auto& node = m_nodes[k].illegal_ref();
+    for (std::size_t j = 0; j < NodeSize; j++) {
+        build(vs, i, child(k, j));
+        node[j] = i < vs.size() ? vs[i++] : data_t{Max + 1};
+    }
+    build(vs, i, child(k, NodeSize));
+}
+
+data_t s_tree_search::lower_bound(const data_t v) const
+{
+    data_t ans = Max + 1;
+    for (std::size_t k = 0; k < m_nodes.size();) {
+        const node_t& node = sim::read(m_nodes[k]);
+        std::size_t rank   = 0;  // v未満のキーの個数
+        for (const data_t x : node) { rank += (x < v); }
+        if (rank < NodeSize) { ans = node[rank]; }
+        k = child(k, rank);
+    }
+    return ans;
+}
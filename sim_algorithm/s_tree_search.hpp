@@ -0,0 +1,45 @@
+#pragma once
+/**
+ * @file s_tree_search.hpp
+ * @brief 頂点あたり16キーの静的B木(S-tree)を用いた探索
+ * @note
+ * - 静的なデータのみを扱う
+ * - 頂点はポインタを持たず、頂点単位のEytzinger順(BFS順)で並べる
+ */
+#include <array>
+
+#include "config.hpp"
+#include "simulator/data_cache.hpp"
+#include "simulator/disk_variable.hpp"
+
+/**
+ * @brief S-treeでデータを保持する構造体
+ * @details
+ * - LowerBound(x): データのうちx以上の最小の値を返す
+ * @note
+ * - 0-indexedで頂点kのi番目の子は k*(NodeSize+1)+i+1
+ * - 頂点は1回の読み込みで丸ごと読む
+ */
+class s_tree_search
+{
+public:
+    static constexpr std::size_t NodeSize = 16;
+    using node_t                          = std::array<data_t, NodeSize>;
+
+    /**
+     * @brief コンストラクタ     
+     * @param vs[in] データ配列
+     */
+    s_tree_search(std::vector<data_t> vs);
+
+    /**
+     * @brief LowerBoundクエリ
+     * @param x[in] 
+     */
+    data_t lower_bound(const data_t v) const;
+
+private:
+    void build(const std::vector<data_t>& vs, std::size_t& i, const std::size_t k);
+
+    std::vector<disk_var<node_t>> m_nodes;
+};
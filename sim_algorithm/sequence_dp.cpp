@@ -0,0 +1,125 @@
+#include <algorithm>
+
+#include "sequence_dp.hpp"
+#include "simulator/simulator.hpp"
+
+sequence_dp::sequence_dp(const std::vector<data_t>& as, const std::vector<data_t>& bs, kernel_t kernel, boundary_t boundary)
+    : m_n{as.size()}, m_m{bs.size()}, m_kernel{std::move(kernel)}, m_boundary{std::move(boundary)}, m_frontier(as.size() + bs.size() + 1)
+{
+    for (const auto a : as) { m_as.push_back(disk_var<data_t>{a}); }
+    for (const auto b : bs) { m_bs.push_back(disk_var<data_t>{b}); }
+}
+
+sequence_dp sequence_dp::lcs(const std::vector<data_t>& as, const std::vector<data_t>& bs)
+{
+    return sequence_dp{
+        as, bs,
+        [](const data_t diag, const data_t up, const data_t left, const data_t a, const data_t b) { return a == b ? diag + 1 : std::max(up, left); },
+        [](const std::size_t) { return data_t{0}; }};
+}
+
+sequence_dp sequence_dp::edit_distance(const std::vector<data_t>& as, const std::vector<data_t>& bs)
+{
+    return sequence_dp{
+        as, bs,
+        [](const data_t diag, const data_t up, const data_t left, const data_t a, const data_t b) { return std::min({diag + (a == b ? 0 : 1), up + 1, left + 1}); },
+        [](const std::size_t k) { return data_t{k}; }};
+}
+
+data_t sequence_dp::naive()
+{
+    const std::size_t W = m_m + 1;
+    std::vector<disk_var<data_t>> table((m_n + 1) * W);
+    for (std::size_t j = 0; j <= m_m; j++) { sim::write(table[j], m_boundary(j)); }
+    for (std::size_t i = 1; i <= m_n; i++) {
+        sim::write(table[i * W], m_boundary(i));
+        const data_t a = sim::read(m_as[i - 1]);
+        for (std::size_t j = 1; j <= m_m; j++) {
+            const data_t diag = sim::read(table[(i - 1) * W + j - 1]);
+            const data_t up   = sim::read(table[(i - 1) * W + j]);
+            const data_t left = sim::read(table[i * W + j - 1]);
+            sim::write(table[i * W + j], m_kernel(diag, up, left, a, sim::read(m_bs[j - 1])));
+        }
+    }
+    return sim::read(table[m_n * W + m_m]);
+}
+
+data_t sequence_dp::solve()
+{
+    reset();
+    recursive(1, m_n + 1, 1, m_m + 1);
+    return sim::read(m_frontier[m_m]);
+}
+
+std::vector<data_t> sequence_dp::last_row()
+{
+    reset();
+    recursive(1, m_n + 1, 1, m_m + 1);
+    std::vector<data_t> row(m_m + 1);
+    for (std::size_t j = 0; j <= m_m; j++) { row[j] = sim::read(m_frontier[j]); }
+    return row;
+}
+
+/**
+ * 境界を左の列と上の行にする
+ */
+void sequence_dp::reset()
+{
+    for (std::size_t i = 0; i <= m_n; i++) { sim::write(m_frontier[m_n - i], m_boundary(i)); }
+    for (std::size_t j = 1; j <= m_m; j++) { sim::write(m_frontier[m_n + j], m_boundary(j)); }
+}
+
+/**
+ * [i0,i1)x[j0,j1)のマスを埋める
+ * - 左上 -> 右上 -> 左下 -> 右下の順に再帰
+ * - 長さ1の辺は分割しない (空の部分は何もしない)
+ */
+void sequence_dp::recursive(const std::size_t i0, const std::size_t i1, const std::size_t j0, const std::size_t j1)
+{
+    if (i0 >= i1 or j0 >= j1) { return; }
+    if (i1 - i0 == 1 and j1 - j0 == 1) {
+        const std::size_t d = j0 + m_n - i0;
+        const data_t diag   = sim::read(m_frontier[d]);
+        const data_t up     = sim::read(m_frontier[d + 1]);
+        const data_t left   = sim::read(m_frontier[d - 1]);
+        sim::write(m_frontier[d], m_kernel(diag, up, left, sim::read(m_as[i0 - 1]), sim::read(m_bs[j0 - 1])));
+        return;
+    }
+    const std::size_t im = (i0 + i1) / 2, jm = (j0 + j1) / 2;
+    recursive(i0, im, j0, jm);
+    recursive(i0, im, jm, j1);
+    recursive(im, i1, j0, jm);
+    recursive(im, i1, jm, j1);
+}
+
+namespace {
+
+void hirschberg(const std::vector<data_t>& as, const std::vector<data_t>& bs, std::vector<data_t>& out)
+{
+    if (as.empty() or bs.empty()) { return; }
+    if (as.size() == 1) {
+        if (std::find(bs.begin(), bs.end(), as[0]) != bs.end()) { out.push_back(as[0]); }
+        return;
+    }
+    const std::size_t mid = as.size() / 2;
+    const std::vector<data_t> a1(as.begin(), as.begin() + mid), a2(as.begin() + mid, as.end());
+    const std::vector<data_t> ra2(a2.rbegin(), a2.rend()), rbs(bs.rbegin(), bs.rend());
+    const auto head = sequence_dp::lcs(a1, bs).last_row();   // head[j] = LCS(a1, bs[0,j))
+    const auto tail = sequence_dp::lcs(ra2, rbs).last_row();  // tail[k] = LCS(a2, bs[m-k,m))
+    const std::size_t m = bs.size();
+    std::size_t k       = 0;
+    for (std::size_t j = 0; j <= m; j++) {
+        if (head[j] + tail[m - j] > head[k] + tail[m - k]) { k = j; }
+    }
+    hirschberg(a1, std::vector<data_t>(bs.begin(), bs.begin() + k), out);
+    hirschberg(a2, std::vector<data_t>(bs.begin() + k, bs.end()), out);
+}
+
+}  // anonymous namespace
+
+std::vector<data_t> lcs_traceback(const std::vector<data_t>& as, const std::vector<data_t>& bs)
+{
+    std::vector<data_t> out;
+    hirschberg(as, bs, out);
+    return out;
+}
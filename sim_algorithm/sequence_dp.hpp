@@ -0,0 +1,81 @@
+#pragma once
+/**
+ * @file sequence_dp.hpp
+ * @brief 2系列のDP (LCS / 編集距離) のCache Obliviousな計算
+ * @note
+ * - D[i][j] = kernel(D[i-1][j-1], D[i-1][j], D[i][j-1], a[i-1], b[j-1])
+ * - 境界はD[k][0] = D[0][k] = boundary(k)
+ */
+#include <functional>
+
+#include "config.hpp"
+#include "simulator/disk_variable.hpp"
+
+/**
+ * @brief 2系列のDP
+ * @details
+ * - naive(): (n+1)x(m+1)の表を行優先で全部埋める
+ * - solve(): 表を4分割して再帰的に埋める (Chowdhury-Ramachandran)
+ *   表は持たず、計算済み領域の境界(階段状)だけを対角線ごとに1マスずつ持つ
+ * - last_row(): solve()と同じ方法でD[n][0..m]を求める
+ */
+class sequence_dp
+{
+public:
+    using kernel_t   = std::function<data_t(data_t, data_t, data_t, data_t, data_t)>;
+    using boundary_t = std::function<data_t(std::size_t)>;
+
+    /**
+     * @brief コンストラクタ
+     * @param as[in] 系列a (長さn)
+     * @param bs[in] 系列b (長さm)
+     * @param kernel[in] 更新式
+     * @param boundary[in] 境界値
+     */
+    sequence_dp(const std::vector<data_t>& as, const std::vector<data_t>& bs, kernel_t kernel, boundary_t boundary);
+
+    /**
+     * @brief LCS
+     */
+    static sequence_dp lcs(const std::vector<data_t>& as, const std::vector<data_t>& bs);
+
+    /**
+     * @brief 編集距離
+     */
+    static sequence_dp edit_distance(const std::vector<data_t>& as, const std::vector<data_t>& bs);
+
+    /**
+     * @brief 表を全部埋めてD[n][m]を求める
+     */
+    data_t naive();
+
+    /**
+     * @brief 再帰的にD[n][m]を求める
+     */
+    data_t solve();
+
+    /**
+     * @brief 再帰的にD[n][0..m]を求める
+     */
+    std::vector<data_t> last_row();
+
+private:
+    void reset();
+    void recursive(const std::size_t i0, const std::size_t i1, const std::size_t j0, const std::size_t j1);
+
+    std::size_t m_n, m_m;
+    kernel_t m_kernel;
+    boundary_t m_boundary;
+    std::vector<disk_var<data_t>> m_as, m_bs;
+    std::vector<disk_var<data_t>> m_frontier;  // D[i][j]はm_frontier[j-i+n]
+};
+
+/**
+ * @brief LCSの復元
+ * @param as[in] 系列a
+ * @param bs[in] 系列b
+ * @details
+ * - Hirschbergの分割統治で線形領域で復元する
+ * - 前半/後半の最終行はsequence_dp::last_row()で求める
+ */
+std::vector<data_t> lcs_traceback(const std::vector<data_t>& as, const std::vector<data_t>& bs);
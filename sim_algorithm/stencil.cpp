@@ -0,0 +1,141 @@
+#include "simulator/simulator.hpp"
+#include "stencil.hpp"
+
+stencil_1d::stencil_1d(const std::vector<data_t>& vs, kernel_t kernel) : m_kernel{std::move(kernel)}
+{
+    for (const auto v : vs) {
+        m_grids[0].push_back(disk_var<data_t>{v});
+        m_grids[1].push_back(disk_var<data_t>{v});
+    }
+}
+
+void stencil_1d::naive(const std::size_t T)
+{
+    const std::size_t N = m_grids[0].size();
+    for (std::size_t t = m_time; t < m_time + T; t++) {
+        for (std::size_t x = 0; x < N; x++) { update(t, x); }
+    }
+    m_time += T;
+}
+
+void stencil_1d::trapezoid(const std::size_t T)
+{
+    const long long N = static_cast<long long>(m_grids[0].size());
+    walk(static_cast<long long>(m_time), static_cast<long long>(m_time + T), 0, 0, N, 0);
+    m_time += T;
+}
+
+std::vector<data_t> stencil_1d::illegal_values() const
+{
+    std::vector<data_t> vs;
+    for (const auto& dv : m_grids[m_time & 1]) { vs.push_back(dv.illegal_ref()); }
+    return vs;
+}
+
+void stencil_1d::update(const std::size_t t, const std::size_t x)
+{
+    const auto& src = m_grids[t & 1];
+    auto& dst       = m_grids[(t + 1) & 1];
+    if (x == 0 or x + 1 == src.size()) {
+        sim::write(dst[x], sim::read(src[x]));
+    } else {
+        sim::write(dst[x], m_kernel(sim::read(src[x - 1]), sim::read(src[x]), sim::read(src[x + 1])));
+    }
+}
+
+/**
+ * 時刻[t0,t1), 時刻t0で[x0,x1)・辺の傾きdx0,dx1の台形を計算する
+ * - 幅が高さの倍以上なら傾き-1の線で左右に切る (左 -> 右の順に依存)
+ * - そうでなければ時間方向に半分に切る
+ */
+void stencil_1d::walk(const long long t0, const long long t1, const long long x0, const long long dx0, const long long x1, const long long dx1)
+{
+    const long long dt = t1 - t0;
+    if (dt == 1) {
+        for (long long x = x0; x < x1; x++) { update(static_cast<std::size_t>(t0), static_cast<std::size_t>(x)); }
+    } else if (dt > 1) {
+        if (2 * (x1 - x0) + (dx1 - dx0) * dt >= 4 * dt) {
+            const long long xm = (2 * (x0 + x1) + (2 + dx0 + dx1) * dt) / 4;
+            walk(t0, t1, x0, dx0, xm, -1);
+            walk(t0, t1, xm, -1, x1, dx1);
+        } else {
+            const long long s = dt / 2;
+            walk(t0, t0 + s, x0, dx0, x1, dx1);
+            walk(t0 + s, t1, x0 + dx0 * s, dx0, x1 + dx1 * s, dx1);
+        }
+    }
+}
+
+stencil_2d::stencil_2d(const std::size_t X, const std::size_t Y, const std::vector<data_t>& vs, kernel_t kernel) : m_X{X}, m_Y{Y}, m_kernel{std::move(kernel)}
+{
+    assert(vs.size() == X * Y);
+    for (const auto v : vs) {
+        m_grids[0].push_back(disk_var<data_t>{v});
+        m_grids[1].push_back(disk_var<data_t>{v});
+    }
+}
+
+void stencil_2d::naive(const std::size_t T)
+{
+    for (std::size_t t = m_time; t < m_time + T; t++) {
+        for (std::size_t x = 0; x < m_X; x++) {
+            for (std::size_t y = 0; y < m_Y; y++) { update(t, x, y); }
+        }
+    }
+    m_time += T;
+}
+
+void stencil_2d::trapezoid(const std::size_t T)
+{
+    const long long X = static_cast<long long>(m_X), Y = static_cast<long long>(m_Y);
+    walk(static_cast<long long>(m_time), static_cast<long long>(m_time + T), 0, 0, X, 0, 0, 0, Y, 0);
+    m_time += T;
+}
+
+std::vector<data_t> stencil_2d::illegal_values() const
+{
+    std::vector<data_t> vs;
+    for (const auto& dv : m_grids[m_time & 1]) { vs.push_back(dv.illegal_ref()); }
+    return vs;
+}
+
+void stencil_2d::update(const std::size_t t, const std::size_t x, const std::size_t y)
+{
+    const auto& src     = m_grids[t & 1];
+    auto& dst           = m_grids[(t + 1) & 1];
+    const std::size_t i = x * m_Y + y;
+    if (x == 0 or y == 0 or x + 1 == m_X or y + 1 == m_Y) {
+        sim::write(dst[i], sim::read(src[i]));
+    } else {
+        sim::write(dst[i], m_kernel(sim::read(src[i]), sim::read(src[i - m_Y]), sim::read(src[i + m_Y]), sim::read(src[i - 1]), sim::read(src[i + 1])));
+    }
+}
+
+/**
+ * 1次元版と同様に、x方向 -> y方向 -> 時間方向の順に切れる方向で切る
+ */
+void stencil_2d::walk(const long long t0, const long long t1,
+                      const long long x0, const long long dx0, const long long x1, const long long dx1,
+                      const long long y0, const long long dy0, const long long y1, const long long dy1)
+{
+    const long long dt = t1 - t0;
+    if (dt == 1) {
+        for (long long x = x0; x < x1; x++) {
+            for (long long y = y0; y < y1; y++) { update(static_cast<std::size_t>(t0), static_cast<std::size_t>(x), static_cast<std::size_t>(y)); }
+        }
+    } else if (dt > 1) {
+        if (2 * (x1 - x0) + (dx1 - dx0) * dt >= 4 * dt) {
+            const long long xm = (2 * (x0 + x1) + (2 + dx0 + dx1) * dt) / 4;
+            walk(t0, t1, x0, dx0, xm, -1, y0, dy0, y1, dy1);
+            walk(t0, t1, xm, -1, x1, dx1, y0, dy0, y1, dy1);
+        } else if (2 * (y1 - y0) + (dy1 - dy0) * dt >= 4 * dt) {
+            const long long ym = (2 * (y0 + y1) + (2 + dy0 + dy1) * dt) / 4;
+            walk(t0, t1, x0, dx0, x1, dx1, y0, dy0, ym, -1);
+            walk(t0, t1, x0, dx0, x1, dx1, ym, -1, y1, dy1);
+        } else {
+            const long long s = dt / 2;
+            walk(t0, t0 + s, x0, dx0, x1, dx1, y0, dy0, y1, dy1);
+            walk(t0 + s, t1, x0 + dx0 * s, dx0, x1 + dx1 * s, dx1, y0 + dy0 * s, dy0, y1 + dy1 * s, dy1);
+        }
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+/**
+ * @file stencil.hpp
+ * @brief 台形分割(Frigo-Strumpen)によるCache Obliviousなステンシル計算
+ * @note
+ * - 時刻tの値から時刻t+1の値を計算するのを繰り返す
+ * - 時刻の偶奇で2枚の配列を使い回す
+ * - 境界(端のマス)は固定
+ */
+#include <functional>
+
+#include "config.hpp"
+#include "simulator/disk_variable.hpp"
+
+/**
+ * @brief 1次元3点ステンシル
+ * @details
+ * - u[t+1][x] = kernel(u[t][x-1], u[t][x], u[t][x+1]) (0 < x < N-1)
+ * - naive(T): 時間ループで全体をT回掃く
+ * - trapezoid(T): 時空間を台形に再帰分割してT時刻進める
+ */
+class stencil_1d
+{
+public:
+    using kernel_t = std::function<data_t(data_t, data_t, data_t)>;
+
+    /**
+     * @brief コンストラクタ
+     * @param vs[in] 初期値
+     * @param kernel[in] 更新式
+     */
+    stencil_1d(const std::vector<data_t>& vs, kernel_t kernel);
+
+    /**
+     * @brief 素直な時間ループ
+     * @param T[in] 進める時刻
+     */
+    void naive(const std::size_t T);
+
+    /**
+     * @brief 台形分割
+     * @param T[in] 進める時刻
+     */
+    void trapezoid(const std::size_t T);
+
+    /**
+     * @brief 現在時刻の値
+     * @note
+     * - 結果確認用 (キャッシュを介さない)
+     */
+    std::vector<data_t> illegal_values() const;
+
+private:
+    void update(const std::size_t t, const std::size_t x);
+    void walk(const long long t0, const long long t1, const long long x0, const long long dx0, const long long x1, const long long dx1);
+
+    std::size_t m_time = 0;
+    kernel_t m_kernel;
+    std::vector<disk_var<data_t>> m_grids[2];
+};
+
+/**
+ * @brief 2次元5点ステンシル
+ * @details
+ * - u[t+1][x][y] = kernel(u[t][x][y], u[t][x-1][y], u[t][x+1][y], u[t][x][y-1], u[t][x][y+1]) (境界以外)
+ * - naive(T): 時間ループで全体をT回掃く
+ * - trapezoid(T): 時空間を台形に再帰分割してT時刻進める
+ * @note
+ * - 各時刻の配列は行優先 (x行y列)
+ */
+class stencil_2d
+{
+public:
+    using kernel_t = std::function<data_t(data_t, data_t, data_t, data_t, data_t)>;
+
+    /**
+     * @brief コンストラクタ
+     * @param X[in] 行数
+     * @param Y[in] 列数
+     * @param vs[in] 初期値 (行優先, X*Y要素)
+     * @param kernel[in] 更新式
+     */
+    stencil_2d(const std::size_t X, const std::size_t Y, const std::vector<data_t>& vs, kernel_t kernel);
+
+    /**
+     * @brief 素直な時間ループ
+     * @param T[in] 進める時刻
+     */
+    void naive(const std::size_t T);
+
+    /**
+     * @brief 台形分割
+     * @param T[in] 進める時刻
+     */
+    void trapezoid(const std::size_t T);
+
+    /**
+     * @brief 現在時刻の値 (行優先)
+     * @note
+     * - 結果確認用 (キャッシュを介さない)
+     */
+    std::vector<data_t> illegal_values() const;
+
+private:
+    void update(const std::size_t t, const std::size_t x, const std::size_t y);
+    void walk(const long long t0, const long long t1,
+              const long long x0, const long long dx0, const long long x1, const long long dx1,
+              const long long y0, const long long dy0, const long long y1, const long long dy1);
+
+    std::size_t m_X, m_Y;
+    std::size_t m_time = 0;
+    kernel_t m_kernel;
+    std::vector<disk_var<data_t>> m_grids[2];
+};
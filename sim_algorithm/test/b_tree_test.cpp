@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <set>
+
 #include "common/rng.hpp"
 #include "sim_algorithm/b_tree.hpp"
 #include "simulator/simulator.hpp"
@@ -29,3 +31,140 @@ TEST(BTreeTest, LowerBound)
         ASSERT_EQ(actual, ans);
     }
 }
+
+TEST(BTreeTest, LowerBoundBatch)
+{
+    rng_base rng(seed);
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    constexpr std::size_t K = 10;
+    sim::initialize(B, M);
+    constexpr std::size_t N = (1 << 10);
+    constexpr std::size_t T = (1 << 10);
+    auto vs                 = rng.vec(N, Min, Max);
+    vs.erase(std::unique(vs.begin(), vs.end()), vs.end());
+    const b_tree searcher(vs, K);
+    std::sort(vs.begin(), vs.end());
+    vs.push_back(Max + 1);
+    std::vector<data_t> qxs(T);
+    for (std::size_t t = 0; t < T; t++) { qxs[t] = t == 0 ? Min : t + 1 == T ? Max : rng.val<data_t>(Min, Max); }
+    qxs.push_back(qxs[T / 2]);         // 同じクエリが複数ある場合
+    qxs.push_back(vs[vs.size() / 3]);  // データに含まれる値
+    const auto anss = searcher.lower_bound_batch(qxs, B, M);
+    ASSERT_EQ(qxs.size(), anss.size());
+    for (std::size_t t = 0; t < qxs.size(); t++) {
+        const data_t actual = *std::lower_bound(vs.begin(), vs.end(), qxs[t]);
+        ASSERT_EQ(actual, anss[t]);
+    }
+}
+
+TEST(BTreeTest, BulkLoad)
+{
+    rng_base rng(seed);
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    constexpr std::size_t K = 4;
+    sim::initialize(B, M);
+    constexpr std::size_t T = (1 << 10);
+    for (const std::size_t N : {0UL, 1UL, 6UL, 7UL, 8UL, 100UL, 1UL << 12}) {
+        for (const double fill : {0.0, 0.5, 0.75, 1.0}) {
+            auto vs = rng.vec(N, Min, Max);
+            for (std::size_t i = 0; i < N / 4; i++) { vs[i] = vs[N - 1 - i]; }  // 重複あり
+            const b_tree searcher = b_tree::bulk_load(vs, K, fill);
+            std::sort(vs.begin(), vs.end());
+            vs.push_back(Max + 1);
+            for (std::size_t t = 0; t < T; t++) {
+                const data_t qx     = t == 0 ? Min : t + 1 == T ? Max : t % 2 == 0 ? vs[rng.val<std::size_t>(0, vs.size() - 1)] : rng.val<data_t>(Min, Max);
+                const data_t ans    = searcher.lower_bound(qx);
+                const data_t actual = *std::lower_bound(vs.begin(), vs.end(), qx);
+                ASSERT_EQ(actual, ans);
+            }
+            const auto anss = searcher.lower_bound_batch(std::vector<data_t>(vs.begin(), vs.end() - 1), B, M);
+            for (std::size_t i = 0; i + 1 < vs.size(); i++) { ASSERT_EQ(vs[i], anss[i]); }
+        }
+    }
+}
+
+TEST(BTreeTest, BulkLoadHeight)
+{
+    rng_base rng(seed);
+    constexpr std::size_t K = 4;
+    constexpr std::size_t N = (2 * K - 1) * 8 * 8 * 8;  // (2K-1)*(2K)^3
+    auto vs                 = rng.vec(N, Min, Max);
+    const b_tree inserted(vs, K);
+    const b_tree full = b_tree::bulk_load(vs, K, 1.0);
+    const b_tree half = b_tree::bulk_load(vs, K, 0.5);
+    // 満杯なら葉は2K-1キー・中間ノードは2K分岐なので、高さは1+ceil(log_{2K}(N/(2K-1)))
+    ASSERT_EQ(4UL, full.height());
+    ASSERT_LE(full.height(), inserted.height());
+    ASSERT_LE(full.height(), half.height());
+}
+
+TEST(BTreeTest, InsertErase)
+{
+    rng_base rng(seed);
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    constexpr std::size_t T = (1 << 13);
+    sim::initialize(B, M);
+    for (const std::size_t K : {2UL, 3UL, 10UL}) {
+        b_tree searcher(K);
+        std::multiset<data_t> vs;
+        for (std::size_t t = 0; t < T; t++) {
+            const std::size_t type = rng.val<std::size_t>(0, 2);
+            const data_t v         = rng.val<data_t>(0, 300);  // 重複が多くなるように狭くする
+            if (type == 0 or t < T / 4) {
+                searcher.insert(v);
+                vs.insert(v);
+            } else if (type == 1) {
+                const auto it = vs.find(v);
+                ASSERT_EQ(it != vs.end(), searcher.erase(v));
+                if (it != vs.end()) { vs.erase(it); }
+            } else {
+                const auto it = vs.lower_bound(v);
+                ASSERT_EQ(it == vs.end() ? Max + 1 : *it, searcher.lower_bound(v));
+            }
+        }
+        ASSERT_EQ(std::vector<data_t>(vs.begin(), vs.end()), searcher.range(Min, Max + 1));
+        while (not vs.empty()) {
+            ASSERT_TRUE(searcher.erase(*vs.begin()));
+            vs.erase(vs.begin());
+        }
+        ASSERT_FALSE(searcher.erase(0));
+        ASSERT_EQ(Max + 1, searcher.lower_bound(Min));
+        ASSERT_EQ(1UL, searcher.height());
+    }
+}
+
+TEST(BTreeTest, Range)
+{
+    rng_base rng(seed);
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    constexpr std::size_t K = 4;
+    constexpr std::size_t N = (1 << 12);
+    constexpr std::size_t T = (1 << 8);
+    sim::initialize(B, M);
+    auto vs = rng.vec(N, Min, Max);
+    for (std::size_t i = 0; i < N / 4; i++) { vs[i] = vs[N - 1 - i]; }
+    const b_tree inserted(vs, K);
+    const b_tree bulk = b_tree::bulk_load(vs, K, 0.75);
+    std::sort(vs.begin(), vs.end());
+    for (std::size_t t = 0; t < T; t++) {
+        data_t lo = rng.val<data_t>(Min, Max), hi = rng.val<data_t>(Min, Max);
+        if (t % 2 == 0) { lo = vs[rng.val<std::size_t>(0, N - 1)], hi = vs[rng.val<std::size_t>(0, N - 1)]; }
+        if (lo > hi) { std::swap(lo, hi); }
+        const std::vector<data_t> actual(std::lower_bound(vs.begin(), vs.end(), lo), std::lower_bound(vs.begin(), vs.end(), hi));
+        ASSERT_EQ(actual, inserted.range(lo, hi));
+        ASSERT_EQ(actual, bulk.range(lo, hi));
+    }
+    ASSERT_EQ(vs, bulk.range(Min, Max + 1));
+
+    // 葉を辿るだけなので、読むブロック数は列挙するキーのバイト数/B程度 (葉ごとに頂点とキー配列の端数がかかる)
+    const b_tree wide = b_tree::bulk_load(vs, 32);
+    sim::initialize(B, M);
+    ASSERT_EQ(vs, wide.range(Min, Max + 1));
+    const auto [R, W] = sim::cache_miss_count();
+    ASSERT_EQ(0UL, W);
+    ASSERT_LE(R, 2 * N * sizeof(data_t) / B);
+}
@@ -27,3 +27,29 @@ TEST(BinarySearchTest, LowerBound)
         ASSERT_EQ(actual, ans);
     }
 }
+
+TEST(BinarySearchTest, LowerBoundBatch)
+{
+    rng_base rng(seed);
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    sim::initialize(B, M);
+    constexpr std::size_t N = (1 << 10);
+    constexpr std::size_t T = (1 << 10);
+    auto vs                 = rng.vec(N, Min, Max);
+    const binary_search searcher(vs);
+    std::sort(vs.begin(), vs.end());
+    vs.push_back(Max + 1);
+    std::vector<data_t> qxs(T);
+    for (std::size_t t = 0; t < T; t++) { qxs[t] = t == 0 ? Min : t + 1 == T ? Max : rng.val<data_t>(Min, Max); }
+    qxs.push_back(qxs[T / 2]);         // 同じクエリが複数ある場合
+    qxs.push_back(vs[vs.size() / 3]);  // データに含まれる値
+    for (const std::size_t m : {M, 4 * B}) {  // 4Bだと連が短く、マージが何段にもなる
+        const auto anss = searcher.lower_bound_batch(qxs, B, m);
+        ASSERT_EQ(qxs.size(), anss.size());
+        for (std::size_t t = 0; t < qxs.size(); t++) {
+            const data_t actual = *std::lower_bound(vs.begin(), vs.end(), qxs[t]);
+            ASSERT_EQ(actual, anss[t]);
+        }
+    }
+}
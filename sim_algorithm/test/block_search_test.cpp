@@ -28,3 +28,52 @@ TEST(BlockSearchTest, LowerBound)
         ASSERT_EQ(actual, ans);
     }
 }
+
+TEST(BlockSearchTest, LowerBoundBatch)
+{
+    rng_base rng(seed);
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    sim::initialize(B, M);
+    constexpr std::size_t H = 4;
+    constexpr std::size_t N = (1 << 10);
+    constexpr std::size_t T = (1 << 10);
+    auto vs                 = rng.vec(N, Min, Max);
+    const block_search searcher(vs, H);
+    std::sort(vs.begin(), vs.end());
+    vs.push_back(Max + 1);
+    std::vector<data_t> qxs(T);
+    for (std::size_t t = 0; t < T; t++) { qxs[t] = t == 0 ? Min : t + 1 == T ? Max : rng.val<data_t>(Min, Max); }
+    qxs.push_back(qxs[T / 2]);         // 同じクエリが複数ある場合
+    qxs.push_back(vs[vs.size() / 3]);  // データに含まれる値
+    const auto anss = searcher.lower_bound_batch(qxs, B, M);
+    ASSERT_EQ(qxs.size(), anss.size());
+    for (std::size_t t = 0; t < qxs.size(); t++) {
+        const data_t actual = *std::lower_bound(vs.begin(), vs.end(), qxs[t]);
+        ASSERT_EQ(actual, anss[t]);
+    }
+}
+
+TEST(BlockSearchTest, ArbitrarySize)
+{
+    rng_base rng(seed);
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    sim::initialize(B, M);
+    constexpr std::size_t H = 4;
+    constexpr std::size_t T = (1 << 8);
+    for (const auto shape : {layout::shape_t::Complete, layout::shape_t::Padded}) {
+        for (const std::size_t N : {0UL, 1UL, 2UL, 3UL, 63UL, 64UL, 65UL, 1000UL}) {
+            auto vs = rng.vec(N, Min, Max);
+            const block_search searcher(vs, H, shape);
+            std::sort(vs.begin(), vs.end());
+            vs.push_back(Max + 1);
+            for (std::size_t t = 0; t < T; t++) {
+                const data_t qx     = t == 0 ? Min : t + 1 == T ? Max : t % 2 == 0 ? vs[t % std::max<std::size_t>(N, 1)] : rng.val<data_t>(Min, Max);
+                const data_t ans    = searcher.lower_bound(qx);
+                const data_t actual = *std::lower_bound(vs.begin(), vs.end(), qx);
+                ASSERT_EQ(actual, ans);
+            }
+        }
+    }
+}
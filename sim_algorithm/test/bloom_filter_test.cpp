@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include <set>
+
+#include "common/rng.hpp"
+#include "sim_algorithm/bloom_filter.hpp"
+#include "simulator/simulator.hpp"
+
+namespace {
+constexpr uint64_t seed = 20200810;
+}  // anonymous namespace
+
+TEST(BloomFilterTest, MayContain)
+{
+    sim::initialize(100, 20000);
+    rng_base rng(seed);
+    for (const std::size_t N : {0UL, 1UL, 1000UL, (1UL << 14)}) {
+        const auto vs = rng.vec(static_cast<int>(N), Min, Max);
+        const bloom_filter filter(vs);
+        for (const data_t v : vs) { ASSERT_TRUE(filter.may_contain(v)); }  // 偽陰性は無い
+    }
+}
+
+TEST(BloomFilterTest, FalsePositive)
+{
+    sim::initialize(100, 20000);
+    rng_base rng(seed);
+    constexpr std::size_t N = (1 << 14);
+    constexpr std::size_t T = (1 << 14);
+    const auto vs           = rng.vec(N, Min, Max);
+    const std::set<data_t> set(vs.begin(), vs.end());
+    for (const auto& [bits, rate] : {std::pair{8.0, 0.04}, std::pair{12.0, 0.012}, std::pair{16.0, 0.004}}) {
+        const bloom_filter filter(vs, bits);
+        std::size_t fp = 0, neg = 0;
+        for (std::size_t t = 0; t < T; t++) {
+            const data_t x = rng.val<data_t>(Min, Max);
+            if (set.count(x) > 0) { continue; }
+            neg++;
+            fp += filter.may_contain(x);
+        }
+        EXPECT_LT(static_cast<double>(fp) / static_cast<double>(neg), rate) << "bits_per_key = " << bits;
+    }
+}
+
+TEST(BloomFilterTest, CacheMiss)
+{
+    rng_base rng(seed);
+    constexpr std::size_t N = (1 << 14);
+    constexpr std::size_t Q = (1 << 10);
+    const bloom_filter filter(rng.vec(N, Min, Max));
+    ASSERT_EQ(0UL, alignof(bloom_filter::block_t) % 32);
+
+    // 1回の判定で読むのは1ブロックだけ
+    sim::initialize(32, 32);
+    for (std::size_t q = 0; q < Q; q++) { filter.may_contain(rng.val<data_t>(Min, Max)); }
+    const auto [R, W] = sim::cache_miss_count();
+    ASSERT_LE(R, Q);
+    ASSERT_EQ(0UL, W);
+}
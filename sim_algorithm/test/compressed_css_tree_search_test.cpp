@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+
+#include "common/rng.hpp"
+#include "sim_algorithm/compressed_css_tree_search.hpp"
+#include "sim_algorithm/css_tree_search.hpp"
+#include "sim_algorithm/test/lower_bound_check.hpp"
+#include "simulator/simulator.hpp"
+
+namespace {
+constexpr uint64_t seed = 20200810;
+}  // anonymous namespace
+
+TEST(CompressedCSSTreeSearchTest, LowerBound)
+{
+    sim::initialize(100, 20000);
+    lower_bound_check::check_random<compressed_css_tree_search<64>>(1 << 10);
+    lower_bound_check::check_random<compressed_css_tree_search<64>>(1 << 10, 1 << 12);  // 密 (幅が小さい)
+    lower_bound_check::check_random<compressed_css_tree_search<64>>(1 << 10, 10);       // 重複だらけ
+    lower_bound_check::check_random<compressed_css_tree_search<64>>(1);
+    lower_bound_check::check_random<compressed_css_tree_search<64>>(0);
+    lower_bound_check::check_random<compressed_css_tree_search<512>>(5000);
+    lower_bound_check::check_random<compressed_css_tree_search<512>>(5000, 1 << 20);
+}
+
+TEST(CompressedCSSTreeSearchTest, Compression)
+{
+    rng_base rng(seed);
+    constexpr std::size_t N = (1 << 14);
+    const auto vs           = rng.vec(N, Min, data_t{1} << 22);  // 隣との差は256程度
+    const compressed_css_tree_search<64> searcher(vs);
+    ASSERT_LE(searcher.leaf_num(), N / 8 / 3);  // 圧縮しなければ1頂点に8個
+    ASSERT_LT(searcher.height(), css_tree_search<64>(vs).height());
+
+    // 1頂点は1ブロックなので、1回のクエリは段数分しかミスしない
+    sim::initialize(64, 64);
+    searcher.lower_bound(data_t{1} << 21);
+    const auto [R, W] = sim::cache_miss_count();
+    ASSERT_EQ(searcher.height(), R);
+    ASSERT_EQ(0UL, W);
+}
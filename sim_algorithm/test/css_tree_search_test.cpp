@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+
+#include "common/rng.hpp"
+#include "sim_algorithm/css_tree_search.hpp"
+#include "sim_algorithm/test/lower_bound_check.hpp"
+#include "simulator/simulator.hpp"
+
+namespace {
+constexpr uint64_t seed = 20200810;
+}  // anonymous namespace
+
+TEST(CSSTreeSearchTest, LowerBound)
+{
+    sim::initialize(100, 20000);
+    lower_bound_check::check_random<css_tree_search<64>>(1 << 10);
+    lower_bound_check::check_random<css_tree_search<64>>(1000);   // 葉に余りが出る
+    lower_bound_check::check_random<css_tree_search<64>>(8 * 9);  // 葉がちょうど埋まる
+    lower_bound_check::check_random<css_tree_search<64>>(1);
+    lower_bound_check::check_random<css_tree_search<64>>(0);
+    lower_bound_check::check_random<css_tree_search<512>>(1 << 12);
+    lower_bound_check::check_random<css_tree_search<512>>(5000);
+}
+
+TEST(CSSTreeSearchTest, CacheMiss)
+{
+    rng_base rng(seed);
+    using tree_t = css_tree_search<64>;
+    ASSERT_EQ(64UL, alignof(tree_t::node_t));
+    ASSERT_EQ(9UL, tree_t::Fanout);
+    const tree_t searcher(rng.vec((1 << 12), Min, Max));
+    ASSERT_EQ(4UL, searcher.height());  // 葉513個 -> 57 -> 7 -> 1
+
+    // 1頂点は1ブロックなので、1回のクエリは段数分しかミスしない
+    sim::initialize(64, 64);
+    searcher.lower_bound(Max / 3);
+    const auto [R, W] = sim::cache_miss_count();
+    ASSERT_EQ(searcher.height(), R);
+    ASSERT_EQ(0UL, W);
+}
@@ -0,0 +1,18 @@
+#include <gtest/gtest.h>
+
+#include "sim_algorithm/eytzinger_search.hpp"
+#include "sim_algorithm/test/lower_bound_check.hpp"
+#include "simulator/simulator.hpp"
+
+TEST(EytzingerSearchTest, LowerBound)
+{
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    sim::initialize(B, M);
+    lower_bound_check::check_random<eytzinger_search>(0);
+    lower_bound_check::check_random<eytzinger_search>(1);
+    lower_bound_check::check_random<eytzinger_search>(1000);
+    lower_bound_check::check_random<eytzinger_search>(1023);      // 完全二分木
+    lower_bound_check::check_random<eytzinger_search>(1024);      // 最下段に1つだけ
+    lower_bound_check::check_random<eytzinger_search>(1000, 10);  // 重複だらけ
+}
@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+
+#include "common/rng.hpp"
+#include "sim_algorithm/floyd_warshall.hpp"
+#include "simulator/simulator.hpp"
+
+namespace {
+constexpr uint64_t seed = 20200810;
+}  // anonymous namespace
+
+TEST(FloydWarshallTest, Distance)
+{
+    rng_base rng(seed);
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    sim::initialize(B, M);
+    for (const std::size_t N : {1, 2, 5, 32, 45}) {
+        std::vector<data_t> ds(N * N, floyd_warshall::Inf);
+        for (std::size_t i = 0; i < N; i++) {
+            for (std::size_t j = 0; j < N; j++) {
+                if (i == j) {
+                    ds[i * N + j] = 0;
+                } else if (rng.val<int>(0, 3) == 0) {
+                    ds[i * N + j] = rng.val<data_t>(1, 1000);
+                }
+            }
+        }
+        auto actual = ds;
+        for (std::size_t k = 0; k < N; k++) {
+            for (std::size_t i = 0; i < N; i++) {
+                for (std::size_t j = 0; j < N; j++) { actual[i * N + j] = std::min(actual[i * N + j], actual[i * N + k] + actual[k * N + j]); }
+            }
+        }
+        floyd_warshall naive(N, ds), recursive(N, ds);
+        naive.naive();
+        recursive.recursive();
+        ASSERT_EQ(actual, naive.illegal_values());
+        ASSERT_EQ(actual, recursive.illegal_values());
+    }
+}
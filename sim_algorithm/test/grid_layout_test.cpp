@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include "common/rng.hpp"
+#include "sim_algorithm/grid_layout.hpp"
+#include "simulator/simulator.hpp"
+
+namespace {
+constexpr uint64_t seed = 20200810;
+}  // anonymous namespace
+
+TEST(GridLayoutTest, Curve)
+{
+    constexpr std::size_t LG = 5;
+    constexpr std::size_t S  = 1UL << LG;
+    std::vector<bool> used(S * S, false);
+    for (std::size_t i = 0; i < S; i++) {
+        for (std::size_t j = 0; j < S; j++) {
+            const auto z = morton_encode(i, j);
+            ASSERT_EQ(morton_decode(z), std::make_pair(uint64_t{i}, uint64_t{j}));
+            if (j + 1 < S) { ASSERT_EQ(morton_next_col(z), morton_encode(i, j + 1)); }
+            if (i + 1 < S) { ASSERT_EQ(morton_next_row(z), morton_encode(i + 1, j)); }
+            const auto d = hilbert_encode(LG, i, j);
+            ASSERT_LT(d, S * S);
+            ASSERT_FALSE(used[d]);
+            used[d] = true;
+            ASSERT_EQ(hilbert_decode(LG, d), std::make_pair(uint64_t{i}, uint64_t{j}));
+        }
+    }
+    for (std::size_t d = 0; d + 1 < S * S; d++) {  // Hilbert曲線で隣り合う添字は隣接マス
+        const auto [i1, j1] = hilbert_decode(LG, d);
+        const auto [i2, j2] = hilbert_decode(LG, d + 1);
+        ASSERT_EQ((i1 > i2 ? i1 - i2 : i2 - i1) + (j1 > j2 ? j1 - j2 : j2 - j1), 1);
+    }
+}
+
+TEST(GridLayoutTest, RangeSum)
+{
+    rng_base rng(seed);
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    sim::initialize(B, M);
+    constexpr std::size_t H = 37;
+    constexpr std::size_t W = 50;
+    constexpr std::size_t T = (1 << 8);
+    std::vector<std::vector<data_t>> vss(H, std::vector<data_t>(W));
+    for (auto& vs : vss) {
+        for (auto& v : vs) { v = rng.val<data_t>(0, 1000); }
+    }
+    for (const auto order : {grid_order::RowMajor, grid_order::ZOrder, grid_order::Hilbert}) {
+        grid_layout grid(H, W, order);
+        for (std::size_t i = 0; i < H; i++) {
+            for (std::size_t j = 0; j < W; j++) { grid.set(i, j, vss[i][j]); }
+        }
+        for (std::size_t i = 0; i < H; i++) {
+            std::size_t j_next = 0;
+            grid.for_row(i, [&](const std::size_t ci, const std::size_t cj, const data_t v) {
+                ASSERT_EQ(ci, i);
+                ASSERT_EQ(cj, j_next++);
+                ASSERT_EQ(v, vss[ci][cj]);
+            });
+            ASSERT_EQ(j_next, W);
+        }
+        for (std::size_t j = 0; j < W; j++) {
+            std::size_t i_next = 0;
+            grid.for_col(j, [&](const std::size_t ci, const std::size_t cj, const data_t v) {
+                ASSERT_EQ(ci, i_next++);
+                ASSERT_EQ(cj, j);
+                ASSERT_EQ(v, vss[ci][cj]);
+            });
+            ASSERT_EQ(i_next, H);
+        }
+        for (std::size_t t = 0; t < T; t++) {
+            std::size_t i0 = rng.val<std::size_t>(0, H), i1 = rng.val<std::size_t>(0, H);
+            std::size_t j0 = rng.val<std::size_t>(0, W), j1 = rng.val<std::size_t>(0, W);
+            if (i0 > i1) { std::swap(i0, i1); }
+            if (j0 > j1) { std::swap(j0, j1); }
+            data_t actual = 0;
+            for (std::size_t i = i0; i < i1; i++) {
+                for (std::size_t j = j0; j < j1; j++) { actual += vss[i][j]; }
+            }
+            ASSERT_EQ(actual, grid.range_sum(i0, j0, i1, j1));
+        }
+    }
+}
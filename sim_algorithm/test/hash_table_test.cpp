@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include <set>
+
+#include "common/rng.hpp"
+#include "sim_algorithm/hash_table.hpp"
+#include "simulator/simulator.hpp"
+
+namespace {
+constexpr uint64_t seed = 20200810;
+
+template<typename Table>
+void check_find(const std::size_t N, const data_t max, const double load)
+{
+    rng_base rng(seed);
+    constexpr std::size_t T = (1 << 12);
+    const auto vs           = rng.vec(N, Min, max);
+    const Table table(vs, load);
+    const std::set<data_t> set(vs.begin(), vs.end());
+    for (const data_t v : vs) { ASSERT_TRUE(table.find(v)); }
+    for (std::size_t t = 0; t < T; t++) {
+        const data_t qx = rng.val<data_t>(Min, max);
+        ASSERT_EQ(set.count(qx) > 0, table.find(qx));
+    }
+}
+
+/**
+ * 1回のFindあたりのミス数 (キャッシュは1ブロック)
+ */
+template<typename Table>
+double miss_per_find(const Table& table, const std::vector<data_t>& qs)
+{
+    sim::initialize(64, 64);
+    for (const data_t q : qs) { table.find(q); }
+    const auto [R, W] = sim::cache_miss_count();
+    EXPECT_EQ(0UL, W);
+    return static_cast<double>(R) / static_cast<double>(qs.size());
+}
+}  // anonymous namespace
+
+TEST(HashTableTest, LinearProbing)
+{
+    sim::initialize(100, 20000);
+    check_find<linear_probing_table>(1 << 12, Max, 0.5);
+    check_find<linear_probing_table>(3600, Max, 0.9);          // 充填率0.88
+    check_find<linear_probing_table>(1 << 12, 1 << 10, 0.5);  // 重複あり
+    check_find<linear_probing_table>(1, Max, 0.5);
+    check_find<linear_probing_table>(0, Max, 0.5);
+}
+
+TEST(HashTableTest, Cuckoo)
+{
+    sim::initialize(100, 20000);
+    check_find<cuckoo_table>(1 << 12, Max, 0.9);
+    check_find<cuckoo_table>(8100, Max, 0.99);  // 充填率0.99 (入らなければ作り直す)
+    check_find<cuckoo_table>(1 << 12, 1 << 10, 0.9);
+    check_find<cuckoo_table>(1, Max, 0.9);
+    check_find<cuckoo_table>(0, Max, 0.9);
+}
+
+TEST(HashTableTest, Swiss)
+{
+    sim::initialize(100, 20000);
+    check_find<swiss_table>(1 << 12, Max, 0.875);
+    check_find<swiss_table>(3900, Max, 0.97);  // 充填率0.95
+    check_find<swiss_table>(1 << 12, 1 << 10, 0.875);
+    check_find<swiss_table>(1, Max, 0.875);
+    check_find<swiss_table>(0, Max, 0.875);
+}
+
+TEST(HashTableTest, CacheMiss)
+{
+    rng_base rng(seed);
+    constexpr std::size_t N = (1 << 14);
+    const auto vs           = rng.vec(N, Min, Max);
+    const auto misses       = rng.vec(N, Min, Max);
+
+    // Cuckooはヒットでも外れでも高々2ブロック
+    const cuckoo_table cuckoo(vs);
+    EXPECT_LE(miss_per_find(cuckoo, vs), 2.0);
+    EXPECT_LE(miss_per_find(cuckoo, misses), 2.0);
+    // 線形探査(load=0.5)とSwiss Tableは、ほぼ1ブロック (Swissはヒットなら制御バイト+キーで2ブロック)
+    EXPECT_LE(miss_per_find(linear_probing_table(vs), vs), 1.2);
+    EXPECT_LE(miss_per_find(swiss_table(vs), vs), 2.2);
+    EXPECT_LE(miss_per_find(swiss_table(vs), misses), 1.2);
+}
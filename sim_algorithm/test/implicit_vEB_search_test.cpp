@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+
+#include "sim_algorithm/implicit_vEB_search.hpp"
+#include "sim_algorithm/test/lower_bound_check.hpp"
+#include "simulator/simulator.hpp"
+
+TEST(ImplicitvEB_SearchTest, LowerBound)
+{
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    sim::initialize(B, M);
+    lower_bound_check::check_random<implicit_vEB_search>(1 << 10);
+}
+
+TEST(ImplicitvEB_SearchTest, Empty)
+{
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    sim::initialize(B, M);
+    const implicit_vEB_search searcher({});
+    for (const data_t qx : {Min, Max}) { ASSERT_EQ(Max + 1, searcher.lower_bound(qx)); }
+}
+
+/**
+ * 木の高さごとに深さの表が変わるので、いろいろなNで試す
+ */
+TEST(ImplicitvEB_SearchTest, ArbitrarySize)
+{
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    sim::initialize(B, M);
+    for (const std::size_t N : {1UL, 2UL, 3UL, 5UL, 7UL, 8UL, 63UL, 64UL, 65UL, 1000UL, (1UL << 10) + 1, (1UL << 12) - 1, (1UL << 13) + 5}) {
+        lower_bound_check::check_random<implicit_vEB_search>(N);
+    }
+    lower_bound_check::check_random<implicit_vEB_search>(1000, 10);  // 重複だらけ
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include "common/rng.hpp"
+#include "sim_algorithm/kd_tree.hpp"
+#include "simulator/simulator.hpp"
+
+namespace {
+constexpr uint64_t seed = 20200810;
+using coord_t           = kd_tree::coord_t;
+using point_t           = kd_tree::point_t;
+using dist_t            = kd_tree::dist_t;
+
+dist_t dist(const point_t& p, const coord_t x, const coord_t y)
+{
+    const dist_t dx = p.first > x ? p.first - x : x - p.first;
+    const dist_t dy = p.second > y ? p.second - y : y - p.second;
+    return dx * dx + dy * dy;
+}
+}  // anonymous namespace
+
+TEST(KdTreeTest, RangeSearch)
+{
+    rng_base rng(seed);
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    sim::initialize(B, M);
+    constexpr std::size_t N = 1000;
+    constexpr std::size_t T = (1 << 8);
+    constexpr coord_t MaxXY = 100;
+    std::vector<point_t> ps(N);
+    for (auto& p : ps) { p = {rng.val<coord_t>(0, MaxXY), rng.val<coord_t>(0, MaxXY)}; }
+    for (const auto order : {kd_order::BFS, kd_order::DFS, kd_order::vEB}) {
+        const kd_tree searcher(ps, order);
+        for (std::size_t t = 0; t < T; t++) {
+            coord_t x0 = rng.val<coord_t>(0, MaxXY + 1), x1 = rng.val<coord_t>(0, MaxXY + 1);
+            coord_t y0 = rng.val<coord_t>(0, MaxXY + 1), y1 = rng.val<coord_t>(0, MaxXY + 1);
+            if (x0 > x1) { std::swap(x0, x1); }
+            if (y0 > y1) { std::swap(y0, y1); }
+            std::vector<point_t> actual;
+            for (const auto& p : ps) {
+                if (x0 <= p.first and p.first < x1 and y0 <= p.second and p.second < y1) { actual.push_back(p); }
+            }
+            auto ans = searcher.range_search(x0, y0, x1, y1);
+            std::sort(actual.begin(), actual.end()), std::sort(ans.begin(), ans.end());
+            ASSERT_EQ(actual, ans);
+            ASSERT_EQ(actual.size(), searcher.range_count(x0, y0, x1, y1));
+        }
+    }
+}
+
+TEST(KdTreeTest, Nearest)
+{
+    rng_base rng(seed);
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    sim::initialize(B, M);
+    constexpr std::size_t T = (1 << 8);
+    constexpr coord_t MaxXY = 1000000;
+    for (const std::size_t N : {1, 2, 100, 1000}) {
+        std::vector<point_t> ps(N);
+        for (auto& p : ps) { p = {rng.val<coord_t>(0, MaxXY), rng.val<coord_t>(0, MaxXY)}; }
+        for (const auto order : {kd_order::BFS, kd_order::DFS, kd_order::vEB}) {
+            const kd_tree searcher(ps, order);
+            for (std::size_t t = 0; t < T; t++) {
+                const coord_t x = rng.val<coord_t>(0, MaxXY);
+                const coord_t y = rng.val<coord_t>(0, MaxXY);
+                dist_t actual   = ~dist_t{0};
+                for (const auto& p : ps) { actual = std::min(actual, dist(p, x, y)); }
+                ASSERT_TRUE(actual == dist(searcher.nearest(x, y), x, y));
+            }
+        }
+    }
+}
+
+TEST(KdTreeTest, NearestLargeCoordinate)
+{
+    rng_base rng(seed);
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    sim::initialize(B, M);
+    constexpr std::size_t T = (1 << 8);
+    constexpr coord_t MaxXY = kd_tree::Sentinel - 1;
+    {
+        // 距離の2乗が2^64を超える: 64bitで計算すると(0,0)の方が近く見える
+        const std::vector<point_t> ps{{0, 0}, {MaxXY, MaxXY}};
+        for (const auto order : {kd_order::BFS, kd_order::DFS, kd_order::vEB}) {
+            const kd_tree searcher(ps, order);
+            ASSERT_EQ((point_t{MaxXY, MaxXY}), searcher.nearest(MaxXY, coord_t{1} << 31));
+        }
+    }
+    for (const std::size_t N : {2, 100, 1000}) {
+        std::vector<point_t> ps(N);
+        for (auto& p : ps) { p = {rng.val<coord_t>(0, MaxXY), rng.val<coord_t>(0, MaxXY)}; }
+        ps[0] = {0, 0}, ps[1] = {MaxXY, MaxXY};
+        for (const auto order : {kd_order::BFS, kd_order::DFS, kd_order::vEB}) {
+            const kd_tree searcher(ps, order);
+            for (std::size_t t = 0; t < T; t++) {
+                const coord_t x = rng.val<coord_t>(0, MaxXY);
+                const coord_t y = rng.val<coord_t>(0, MaxXY);
+                dist_t actual   = ~dist_t{0};
+                for (const auto& p : ps) { actual = std::min(actual, dist(p, x, y)); }
+                ASSERT_TRUE(actual == dist(searcher.nearest(x, y), x, y));
+            }
+        }
+    }
+}
+
+TEST(KdTreeTest, Empty)
+{
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    sim::initialize(B, M);
+    for (const auto order : {kd_order::BFS, kd_order::DFS, kd_order::vEB}) {
+        const kd_tree searcher({}, order);
+        ASSERT_EQ(0U, searcher.range_count(0, 0, 100, 100));
+        ASSERT_EQ((point_t{kd_tree::Sentinel, kd_tree::Sentinel}), searcher.nearest(0, 0));
+    }
+}
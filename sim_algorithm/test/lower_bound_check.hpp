@@ -0,0 +1,51 @@
+#pragma once
+/**
+ * @file lower_bound_check.hpp
+ * @brief 静的な探索構造のlower_boundをstd::lower_boundと比べる (テスト用)
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "common/rng.hpp"
+#include "config.hpp"
+
+namespace lower_bound_check {
+
+constexpr uint64_t Seed = 20200810;
+
+/**
+ * @brief searcherのlower_boundがvsでのstd::lower_boundと一致するか確かめる
+ * @param searcher[in] vsから作った探索構造
+ * @param vs[in] データ (順不同, 重複あり)
+ * @param max[in] 外れるクエリの上限
+ * @details クエリはMin, Maxと、半分はデータから選んだ値 (当たる)、半分は[Min, max]の一様な値 (ほぼ外れる)
+ */
+template<typename Searcher>
+void check(const Searcher& searcher, std::vector<data_t> vs, const data_t max = Max)
+{
+    rng_base rng(Seed);
+    constexpr std::size_t T = (1 << 10);
+    std::sort(vs.begin(), vs.end());
+    vs.push_back(Max + 1);
+    for (std::size_t t = 0; t < T; t++) {
+        const data_t qx     = t == 0 ? Min : t + 1 == T ? Max : t % 2 == 0 ? vs[rng.val<std::size_t>(0, vs.size() - 1)] : rng.val<data_t>(Min, max);
+        const data_t ans    = searcher.lower_bound(qx);
+        const data_t actual = *std::lower_bound(vs.begin(), vs.end(), qx);
+        ASSERT_EQ(actual, ans) << "N=" << vs.size() - 1 << ", qx=" << qx;
+    }
+}
+
+/**
+ * @brief [Min, max]の一様なN個のデータからSearcherを作って確かめる
+ */
+template<typename Searcher>
+void check_random(const std::size_t N, const data_t max = Max)
+{
+    rng_base rng(Seed);
+    const auto vs = rng.vec(N, Min, max);
+    check(Searcher(vs), vs, max);
+}
+
+}  // namespace lower_bound_check
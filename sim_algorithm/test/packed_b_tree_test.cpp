@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include "common/rng.hpp"
+#include "sim_algorithm/packed_b_tree.hpp"
+#include "sim_algorithm/test/lower_bound_check.hpp"
+#include "simulator/simulator.hpp"
+
+namespace {
+constexpr uint64_t seed = 20200810;
+
+template<std::size_t NodeBytes>
+void check_lower_bound(const std::size_t N, const bool unique)
+{
+    rng_base rng(seed);
+    auto vs = rng.vec(N, Min, Max);
+    if (unique) {
+        std::sort(vs.begin(), vs.end());
+        vs.erase(std::unique(vs.begin(), vs.end()), vs.end());
+        std::shuffle(vs.begin(), vs.end(), std::mt19937_64{seed});
+    } else {
+        for (std::size_t i = 0; i < N / 4; i++) { vs[i] = vs[N - 1 - i]; }  // 重複あり
+    }
+    lower_bound_check::check(packed_b_tree<NodeBytes>(vs), vs);
+}
+}  // anonymous namespace
+
+TEST(PackedBTreeTest, LowerBound)
+{
+    sim::initialize(64, 20000);
+    check_lower_bound<64>(1 << 10, true);
+    check_lower_bound<64>(1 << 10, false);
+    check_lower_bound<64>(1, true);
+    sim::initialize(512, 20000);
+    check_lower_bound<512>(1 << 12, true);
+    check_lower_bound<512>(1 << 12, false);
+}
+
+TEST(PackedBTreeTest, Layout)
+{
+    using tree_t = packed_b_tree<64>;
+    ASSERT_EQ(64UL, sizeof(tree_t::node_t));
+    ASSERT_EQ(64UL, alignof(tree_t::node_t));
+    ASSERT_EQ(4UL, tree_t::Capacity);
+    rng_base rng(seed);
+    const tree_t searcher(rng.vec(1000, Min, Max));
+    // 根以外は半分以上埋まる
+    ASSERT_LE(searcher.node_num(), 1000 / (tree_t::Capacity / 2) + 1);
+    ASSERT_LE(searcher.height(), 10UL);
+
+    // 1頂点は1ブロックなので、1回のクエリは高さ分しかミスしない
+    sim::initialize(64, 64);
+    searcher.lower_bound(Max / 3);
+    const auto [R, W] = sim::cache_miss_count();
+    ASSERT_EQ(searcher.height(), R);
+    ASSERT_EQ(0UL, W);
+}
@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include "common/rng.hpp"
+#include "sim_algorithm/rmi_search.hpp"
+#include "sim_algorithm/test/lower_bound_check.hpp"
+#include "simulator/simulator.hpp"
+
+namespace {
+constexpr uint64_t seed = 20200810;
+
+void check_lower_bound(const std::vector<data_t>& vs, const std::size_t model_num)
+{
+    lower_bound_check::check(rmi_search(vs, model_num), vs);
+}
+}  // anonymous namespace
+
+TEST(RMISearchTest, LowerBound)
+{
+    sim::initialize(100, 20000);
+    rng_base rng(seed);
+    check_lower_bound(rng.vec((1 << 12), Min, Max), 1);
+    check_lower_bound(rng.vec((1 << 12), Min, Max), 64);
+    check_lower_bound(rng.vec((1 << 12), Min, Max), (1 << 13));   // キーよりモデルが多い
+    check_lower_bound(rng.vec((1 << 12), Min, data_t{100}), 64);  // 重複だらけ
+    check_lower_bound(rng.vec((1 << 12), Min, data_t{100}), 1);   // 傾きが大きく、遠いクエリの予測がlong longに収まらない
+    check_lower_bound(rng.vec(1, Min, Max), 4);
+    check_lower_bound({}, 4);
+
+    // 偏った分布 (1段目の予測が外れるので、2段目のモデルの担当がばらつく)
+    auto vs = rng.vec((1 << 12), Min, data_t{1} << 31);
+    for (auto& v : vs) { v = v * v / 4; }
+    check_lower_bound(vs, 64);
+}
+
+TEST(RMISearchTest, CacheMiss)
+{
+    rng_base rng(seed);
+    constexpr std::size_t N = (1 << 16);
+    constexpr std::size_t Q = (1 << 10);
+    const rmi_search searcher(rng.vec(N, Min, Max), N / 16);
+    ASSERT_LT(searcher.mean_error(), 64.0);
+
+    // 一様な分布なら、モデルを1回読んで狭い範囲を探すだけ (二分探索なら13ミス程度)
+    sim::initialize(64, 64 * 4);
+    for (std::size_t q = 0; q < Q; q++) { searcher.lower_bound(rng.val<data_t>(Min, Max)); }
+    const auto [R, W] = sim::cache_miss_count();
+    ASSERT_LE(R, 6 * Q);
+    ASSERT_EQ(0UL, W);
+}
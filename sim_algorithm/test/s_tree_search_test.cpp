@@ -0,0 +1,31 @@
+#include <gtest/gtest.h>
+
+#include "sim_algorithm/s_tree_search.hpp"
+#include "sim_algorithm/test/lower_bound_check.hpp"
+#include "simulator/simulator.hpp"
+
+TEST(S_TreeSearchTest, LowerBound)
+{
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    sim::initialize(B, M);
+    lower_bound_check::check_random<s_tree_search>(1 << 10);
+    lower_bound_check::check_random<s_tree_search>(0);
+    lower_bound_check::check_random<s_tree_search>(1);
+}
+
+TEST(S_TreeSearchTest, LowerBoundPadded)
+{
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    sim::initialize(B, M);
+    lower_bound_check::check_random<s_tree_search>(1000);  // 頂点に余りが出る
+}
+
+TEST(S_TreeSearchTest, LowerBoundDuplicated)
+{
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    sim::initialize(B, M);
+    lower_bound_check::check_random<s_tree_search>(1000, 10);  // 同じキーが頂点をまたいで並ぶ
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+
+#include "common/rng.hpp"
+#include "sim_algorithm/sequence_dp.hpp"
+#include "simulator/simulator.hpp"
+
+namespace {
+constexpr uint64_t seed = 20200810;
+
+std::vector<std::vector<data_t>> table(const std::vector<data_t>& as, const std::vector<data_t>& bs, const bool edit)
+{
+    std::vector<std::vector<data_t>> dss(as.size() + 1, std::vector<data_t>(bs.size() + 1, 0));
+    for (std::size_t i = 0; i <= as.size(); i++) {
+        for (std::size_t j = 0; j <= bs.size(); j++) {
+            if (i == 0 or j == 0) {
+                dss[i][j] = edit ? i + j : 0;
+            } else if (edit) {
+                dss[i][j] = std::min({dss[i - 1][j - 1] + (as[i - 1] == bs[j - 1] ? 0 : 1), dss[i - 1][j] + 1, dss[i][j - 1] + 1});
+            } else {
+                dss[i][j] = as[i - 1] == bs[j - 1] ? dss[i - 1][j - 1] + 1 : std::max(dss[i - 1][j], dss[i][j - 1]);
+            }
+        }
+    }
+    return dss;
+}
+
+bool is_subsequence(const std::vector<data_t>& xs, const std::vector<data_t>& ys)
+{
+    std::size_t i = 0;
+    for (const auto y : ys) {
+        if (i < xs.size() and xs[i] == y) { i++; }
+    }
+    return i == xs.size();
+}
+}  // anonymous namespace
+
+TEST(SequenceDPTest, LCS)
+{
+    rng_base rng(seed);
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    sim::initialize(B, M);
+    constexpr std::size_t T = 30;
+    for (std::size_t t = 0; t < T; t++) {
+        const auto as   = rng.vec<data_t>(rng.val<int>(0, 100), 0, 3);
+        const auto bs   = rng.vec<data_t>(rng.val<int>(0, 100), 0, 3);
+        const auto dss  = table(as, bs, false);
+        auto dp         = sequence_dp::lcs(as, bs);
+        const auto lcs  = lcs_traceback(as, bs);
+        ASSERT_EQ(dss.back().back(), dp.naive());
+        ASSERT_EQ(dss.back().back(), dp.solve());
+        ASSERT_EQ(dss.back(), dp.last_row());
+        ASSERT_EQ(dss.back().back(), lcs.size());
+        ASSERT_TRUE(is_subsequence(lcs, as));
+        ASSERT_TRUE(is_subsequence(lcs, bs));
+    }
+}
+
+TEST(SequenceDPTest, EditDistance)
+{
+    rng_base rng(seed);
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    sim::initialize(B, M);
+    constexpr std::size_t T = 30;
+    for (std::size_t t = 0; t < T; t++) {
+        const auto as  = rng.vec<data_t>(rng.val<int>(0, 100), 0, 3);
+        const auto bs  = rng.vec<data_t>(rng.val<int>(0, 100), 0, 3);
+        const auto dss = table(as, bs, true);
+        auto dp        = sequence_dp::edit_distance(as, bs);
+        ASSERT_EQ(dss.back().back(), dp.naive());
+        ASSERT_EQ(dss.back().back(), dp.solve());
+        ASSERT_EQ(dss.back(), dp.last_row());
+    }
+}
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include "common/rng.hpp"
+#include "sim_algorithm/stencil.hpp"
+#include "simulator/simulator.hpp"
+
+namespace {
+constexpr uint64_t seed = 20200810;
+}  // anonymous namespace
+
+TEST(StencilTest, Trapezoid1D)
+{
+    rng_base rng(seed);
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    sim::initialize(B, M);
+    const auto kernel = [](const data_t l, const data_t c, const data_t r) { return (l + 2 * c + r) / 4 + (c & 1); };
+    for (const std::size_t N : {1, 2, 3, 100, 1000}) {
+        constexpr std::size_t T = 37;
+        auto vs                 = rng.vec<data_t>(N, 0, 1000000);
+        stencil_1d naive(vs, kernel), trapezoid(vs, kernel);
+        for (std::size_t t = 0; t < T; t++) {
+            auto ws = vs;
+            for (std::size_t x = 1; x + 1 < N; x++) { ws[x] = kernel(vs[x - 1], vs[x], vs[x + 1]); }
+            vs = ws;
+        }
+        naive.naive(T);
+        trapezoid.trapezoid(T - 10);
+        trapezoid.trapezoid(10);
+        ASSERT_EQ(vs, naive.illegal_values());
+        ASSERT_EQ(vs, trapezoid.illegal_values());
+    }
+}
+
+TEST(StencilTest, Trapezoid2D)
+{
+    rng_base rng(seed);
+    constexpr std::size_t B = 100;
+    constexpr std::size_t M = 20000;
+    sim::initialize(B, M);
+    const auto kernel       = [](const data_t c, const data_t n, const data_t s, const data_t w, const data_t e) { return (4 * c + n + s + w + e) / 8 + (n & 1); };
+    constexpr std::size_t X = 37;
+    constexpr std::size_t Y = 50;
+    constexpr std::size_t T = 29;
+    auto vs                 = rng.vec<data_t>(X * Y, 0, 1000000);
+    stencil_2d naive(X, Y, vs, kernel), trapezoid(X, Y, vs, kernel);
+    for (std::size_t t = 0; t < T; t++) {
+        auto ws = vs;
+        for (std::size_t x = 1; x + 1 < X; x++) {
+            for (std::size_t y = 1; y + 1 < Y; y++) {
+                const std::size_t i = x * Y + y;
+                ws[i]               = kernel(vs[i], vs[i - Y], vs[i + Y], vs[i - 1], vs[i + 1]);
+            }
+        }
+        vs = ws;
+    }
+    naive.naive(T);
+    trapezoid.trapezoid(T);
+    ASSERT_EQ(vs, naive.illegal_values());
+    ASSERT_EQ(vs, trapezoid.illegal_values());
+}
@@ -6,6 +6,7 @@
  * - 静的なデータのみを扱う
  */
 #include "config.hpp"
+#include "sim_algorithm/query_batch.hpp"
 #include "simulator/data_cache.hpp"
 #include "simulator/disk_variable.hpp"
 
@@ -29,7 +30,19 @@ public:
      */
     data_t lower_bound(const data_t v) const;
 
+    /**
+     * @brief LowerBoundクエリをまとめて処理
+     * @param qs[in] クエリの配列
+     * @param B[in] ブロックサイズ (クエリ列の並べ替えに使う)
+     * @param M[in] キャッシュサイズ (クエリ列の並べ替えに使う)
+     * @return 各クエリの答え (qsと同じ順)
+     * @details クエリをディスク上で昇順に並べ、根から1回だけ降りながらクエリ列を左右の子に振り分ける
+     */
+    std::vector<data_t> lower_bound_batch(const std::vector<data_t>& qs, const std::size_t B, const std::size_t M) const;
+
 private:
+    void descend(const std::size_t pos, const batch::iter_t first, const batch::iter_t last, const data_t ans) const;
+
     std::size_t m_root_pos;
     std::vector<disk_var<std::size_t>> m_ls, m_rs;
     std::vector<disk_var<data_t>> m_xs;
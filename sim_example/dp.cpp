@@ -0,0 +1,84 @@
+#include <iostream>
+
+#include "common/rng.hpp"
+#include "sim_algorithm/floyd_warshall.hpp"
+#include "sim_algorithm/sequence_dp.hpp"
+#include "simulator/simulator.hpp"
+
+namespace {
+
+constexpr std::size_t B = (1 << 9);
+constexpr std::size_t M = (1 << 16);
+
+void print_miss()
+{
+    const auto [R, W] = sim::cache_miss_count();
+    std::cout << "Cache Miss: " << R + W << " (Read: " << R << ", Write: " << W << ")" << std::endl;
+}
+
+}  // anonymous namespace
+
+int main()
+{
+    rng_base rng{Seed};
+    {
+        constexpr std::size_t N = (1 << 10);
+        const auto as           = rng.vec<data_t>(N, 0, 3);
+        const auto bs           = rng.vec<data_t>(N, 0, 3);
+        {
+            std::cout << "[LCS Sol1] Naive" << std::endl;
+            auto dp = sequence_dp::lcs(as, bs);
+            sim::initialize(B, M);  // リセット
+            std::cout << "LCS: " << dp.naive() << std::endl;
+            print_miss();
+            std::cout << std::endl;
+        }
+        {
+            std::cout << "[LCS Sol2] Recursive" << std::endl;
+            auto dp = sequence_dp::lcs(as, bs);
+            sim::initialize(B, M);  // リセット
+            std::cout << "LCS: " << dp.solve() << std::endl;
+            print_miss();
+            std::cout << std::endl;
+        }
+        {
+            std::cout << "[Edit Sol1] Naive" << std::endl;
+            auto dp = sequence_dp::edit_distance(as, bs);
+            sim::initialize(B, M);  // リセット
+            std::cout << "Edit Distance: " << dp.naive() << std::endl;
+            print_miss();
+            std::cout << std::endl;
+        }
+        {
+            std::cout << "[Edit Sol2] Recursive" << std::endl;
+            auto dp = sequence_dp::edit_distance(as, bs);
+            sim::initialize(B, M);  // リセット
+            std::cout << "Edit Distance: " << dp.solve() << std::endl;
+            print_miss();
+            std::cout << std::endl;
+        }
+    }
+    {
+        constexpr std::size_t N = (1 << 7);
+        std::vector<data_t> ds(N * N);
+        for (std::size_t i = 0; i < N * N; i++) { ds[i] = i % (N + 1) == 0 ? 0 : rng.val<data_t>(1, 1000000); }
+        {
+            std::cout << "[Floyd-Warshall Sol1] Naive" << std::endl;
+            floyd_warshall fw{N, ds};
+            sim::initialize(B, M);  // リセット
+            fw.naive();
+            print_miss();
+            std::cout << std::endl;
+        }
+        {
+            std::cout << "[Floyd-Warshall Sol2] I-GEP" << std::endl;
+            floyd_warshall fw{N, ds};
+            sim::initialize(B, M);  // リセット
+            fw.recursive();
+            print_miss();
+            std::cout << std::endl;
+        }
+    }
+
+    return 0;
+}
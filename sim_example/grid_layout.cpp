@@ -0,0 +1,86 @@
+#include <iomanip>
+#include <iostream>
+
+#include "common/rng.hpp"
+#include "sim_algorithm/grid_layout.hpp"
+#include "simulator/simulator.hpp"
+
+namespace {
+
+constexpr std::size_t B = (1 << 9);
+constexpr std::size_t M = (1 << 18);
+constexpr std::size_t S = (1 << 10);  // グリッドの一辺
+constexpr std::size_t Q = (1 << 16);
+constexpr std::size_t L = 64;  // 矩形クエリの一辺
+
+void print_miss(const char* name)
+{
+    const auto [R, W] = sim::cache_miss_count();
+    std::cout << name << " Cache Miss: " << R + W << " (Read: " << R << ", Write: " << W << ")" << std::endl;
+}
+
+void test(const char* title, const grid_order order, const std::vector<data_t>& vs, const std::vector<std::size_t>& qis, const std::vector<std::size_t>& qjs)
+{
+    std::cout << title << std::endl;
+    grid_layout src{S, S, order}, dst{S, S, order};
+    for (std::size_t i = 0; i < S; i++) {
+        for (std::size_t j = 0; j < S; j++) { src.illegal_set(i, j, vs[i * S + j]); }
+    }
+    std::cout << "Precalc end." << std::endl;
+
+    // 5点ステンシル (レイアウト順に1回掃く)
+    sim::initialize(B, M);
+    src.for_tile(0, 0, S, S, [&](const std::size_t i, const std::size_t j, const data_t c) {
+        data_t sum = c;
+        if (i > 0) { sum += src.get(i - 1, j); }
+        if (i + 1 < S) { sum += src.get(i + 1, j); }
+        if (j > 0) { sum += src.get(i, j - 1); }
+        if (j + 1 < S) { sum += src.get(i, j + 1); }
+        dst.set(i, j, sum / 5);
+    });
+    print_miss("[Stencil]");
+
+    // 列方向の走査
+    sim::initialize(B, M);
+    data_t col_sum = 0;
+    for (std::size_t j = 0; j < S; j++) {
+        src.for_col(j, [&](const std::size_t, const std::size_t, const data_t v) { col_sum += v; });
+    }
+    print_miss("[Column]");
+
+    // ランダムな点の3x3近傍
+    sim::initialize(B, M);
+    data_t nb_sum = 0;
+    for (std::size_t q = 0; q < Q; q++) {
+        const std::size_t i = qis[q], j = qjs[q];
+        nb_sum += src.range_sum(i == 0 ? 0 : i - 1, j == 0 ? 0 : j - 1, i + 2, j + 2);
+    }
+    print_miss("[Neighbor]");
+
+    // ランダムなLxL矩形の総和
+    sim::initialize(B, M);
+    data_t rect_sum = 0;
+    for (std::size_t q = 0; q < Q / L; q++) {
+        const std::size_t i = qis[q] % (S - L), j = qjs[q] % (S - L);
+        rect_sum += src.range_sum(i, j, i + L, j + L);
+    }
+    print_miss("[Range]");
+    std::cout << "Sum(for Debug): " << col_sum + nb_sum + rect_sum << std::endl;
+    std::cout << std::endl;
+}
+
+}  // anonymous namespace
+
+int main()
+{
+    rng_base rng{Seed};
+    const auto vs  = rng.vec<data_t>(S * S, 0, 1000);
+    const auto qis = rng.vec<std::size_t>(Q, 0, S - 1);
+    const auto qjs = rng.vec<std::size_t>(Q, 0, S - 1);
+
+    test("[Sol1] Row Major", grid_order::RowMajor, vs, qis, qjs);
+    test("[Sol2] Z-order", grid_order::ZOrder, vs, qis, qjs);
+    test("[Sol3] Hilbert order", grid_order::Hilbert, vs, qis, qjs);
+
+    return 0;
+}
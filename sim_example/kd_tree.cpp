@@ -0,0 +1,47 @@
+#include <iostream>
+
+#include "common/rng.hpp"
+#include "sim_algorithm/kd_tree.hpp"
+#include "simulator/simulator.hpp"
+
+int main()
+{
+    using coord_t = kd_tree::coord_t;
+
+    constexpr std::size_t B    = (1 << 9);
+    constexpr std::size_t M    = (1 << 18);
+    constexpr std::size_t N    = (1 << 18);
+    constexpr std::size_t Q    = (1 << 14);
+    constexpr coord_t MaxXY    = (1U << 30);
+    constexpr coord_t RectSide = (1U << 23);  // 矩形クエリの一辺 (1個あたり約16点)
+
+    rng_base rng{Seed};
+    std::vector<kd_tree::point_t> ps(N);
+    for (auto& p : ps) { p = {rng.val<coord_t>(0, MaxXY), rng.val<coord_t>(0, MaxXY)}; }
+    const auto qxs = rng.vec<coord_t>(Q, 0, MaxXY - RectSide);
+    const auto qys = rng.vec<coord_t>(Q, 0, MaxXY - RectSide);
+
+    const std::pair<const char*, kd_order> orders[] = {{"[Sol1] BFS order", kd_order::BFS}, {"[Sol2] DFS order", kd_order::DFS}, {"[Sol3] vEB Layout", kd_order::vEB}};
+    for (const auto& [title, order] : orders) {
+        std::cout << title << std::endl;
+        kd_tree searcher{ps, order};
+        std::cout << "Precalc end." << std::endl;
+        {
+            sim::initialize(B, M);  // リセット
+            std::size_t sum = 0;
+            for (std::size_t q = 0; q < Q; q++) { sum += searcher.range_count(qxs[q], qys[q], qxs[q] + RectSide, qys[q] + RectSide); }
+            const auto [R, W] = sim::cache_miss_count();
+            std::cout << "[Range] Cache Miss: " << R + W << " (Points: " << sum << ")" << std::endl;
+        }
+        {
+            sim::initialize(B, M);  // リセット
+            uint64_t sum = 0;
+            for (std::size_t q = 0; q < Q; q++) { sum += searcher.nearest(qxs[q], qys[q]).first; }
+            const auto [R, W] = sim::cache_miss_count();
+            std::cout << "[Nearest] Cache Miss: " << R + W << " (Sum: " << sum << ")" << std::endl;
+        }
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
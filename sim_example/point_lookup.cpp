@@ -0,0 +1,108 @@
+#include <iostream>
+
+#include "common/rng.hpp"
+#include "sim_algorithm/b_tree.hpp"
+#include "sim_algorithm/bloom_filter.hpp"
+#include "sim_algorithm/hash_table.hpp"
+#include "sim_algorithm/vEB_search.hpp"
+#include "simulator/simulator.hpp"
+
+/**
+ * 点検索 (キーがあるかどうか) の比較
+ * - 順序付きの索引はLowerBoundの答えがキーと一致するかで判定する
+ * - クエリは半分がヒット(データから選ぶ)、半分が外れ(ほぼ確実に無い値)
+ * - 後半は外れがほとんどのクエリで、Bloom Filterを前段に置いて降りる回数を減らす
+ */
+int main()
+{
+    constexpr std::size_t B = (1 << 9);
+    constexpr std::size_t M = (1 << 18);
+    constexpr std::size_t N = (1 << 22);
+    constexpr std::size_t Q = (1 << 18);
+    constexpr std::size_t K = B / sizeof(data_t) / 2;  // B-木の1ノードが1ブロックに収まる
+
+    rng_base rng{Seed};
+    const auto vs = rng.vec<data_t>(N, Min, Max);
+    std::vector<data_t> qxs(Q), rare_qxs(Q);  // rare_qxs: ヒットは1/16だけ
+    for (std::size_t q = 0; q < Q; q++) { qxs[q] = q % 2 == 0 ? vs[rng.val<std::size_t>(0, N - 1)] : rng.val<data_t>(Min, Max); }
+    for (std::size_t q = 0; q < Q; q++) { rare_qxs[q] = q % 16 == 0 ? vs[rng.val<std::size_t>(0, N - 1)] : rng.val<data_t>(Min, Max); }
+
+    const auto run_on = [&](const std::vector<data_t>& qs, const auto& find) {
+        sim::initialize(B, M);  // リセット
+        std::size_t hit = 0;
+        for (std::size_t q = 0; q < Q; q++) { hit += find(qs[q]); }
+        const auto [R, W] = sim::cache_miss_count();
+        assert(W == 0);
+        std::cout << "Hit: " << hit << std::endl;
+        std::cout << "Cache Miss: " << R + W << std::endl;
+        std::cout << "Cache Miss / Query: " << static_cast<double>(R + W) / static_cast<double>(Q) << std::endl;
+        std::cout << std::endl;
+    };
+    const auto run = [&](const auto& find) { run_on(qxs, find); };
+
+    {
+        std::cout << "[Sol1] vEB Layout" << std::endl;
+        vEB_search searcher{vs};
+        std::cout << "Precalc end." << std::endl;
+        run([&](const data_t x) { return searcher.lower_bound(x) == x; });
+    }
+    {
+        std::cout << "[Sol2] B-tree (K: " << K << ", Bulk Load)" << std::endl;
+        const b_tree searcher = b_tree::bulk_load(vs, K);
+        std::cout << "Precalc end." << std::endl;
+        run([&](const data_t x) { return searcher.lower_bound(x) == x; });
+    }
+    {
+        std::cout << "[Sol3] Linear Probing (Load: 0.5)" << std::endl;
+        linear_probing_table table{vs, 0.5};
+        std::cout << "Precalc end. (" << table.bytes() << " bytes)" << std::endl;
+        run([&](const data_t x) { return table.find(x); });
+    }
+    {
+        std::cout << "[Sol4] Cuckoo (Bucket: " << cuckoo_table::BucketSize << " keys)" << std::endl;
+        cuckoo_table table{vs};
+        std::cout << "Precalc end. (" << table.bytes() << " bytes)" << std::endl;
+        run([&](const data_t x) { return table.find(x); });
+    }
+    {
+        std::cout << "[Sol5] Swiss Table (Group: " << swiss_table::GroupSize << " slots)" << std::endl;
+        swiss_table table{vs};
+        std::cout << "Precalc end. (" << table.bytes() << " bytes)" << std::endl;
+        run([&](const data_t x) { return table.find(x); });
+    }
+
+    {
+        const vEB_search veb{vs};
+        const b_tree btree = b_tree::bulk_load(vs, K);
+        const bloom_filter filter{vs};
+        std::size_t skipped = 0;
+        const auto filtered = [&](const auto& find) {
+            return [&](const data_t x) {
+                if (not filter.may_contain(x)) {
+                    skipped++;
+                    return false;
+                }
+                return find(x);
+            };
+        };
+        const auto veb_find   = [&](const data_t x) { return veb.lower_bound(x) == x; };
+        const auto btree_find = [&](const data_t x) { return btree.lower_bound(x) == x; };
+        std::cout << "Precalc end. (Bloom Filter: " << filter.bytes() << " bytes)" << std::endl;
+        std::cout << std::endl;
+
+        std::cout << "[Sol6] vEB Layout (Mostly Absent)" << std::endl;
+        run_on(rare_qxs, veb_find);
+        std::cout << "[Sol7] Bloom Filter + vEB Layout (Mostly Absent)" << std::endl;
+        run_on(rare_qxs, filtered(veb_find));
+        std::cout << "Skipped: " << static_cast<double>(skipped) / static_cast<double>(Q) << std::endl;
+        std::cout << std::endl;
+        skipped = 0;
+        std::cout << "[Sol8] B-tree (Mostly Absent)" << std::endl;
+        run_on(rare_qxs, btree_find);
+        std::cout << "[Sol9] Bloom Filter + B-tree (Mostly Absent)" << std::endl;
+        run_on(rare_qxs, filtered(btree_find));
+        std::cout << "Skipped: " << static_cast<double>(skipped) / static_cast<double>(Q) << std::endl;
+        std::cout << std::endl;
+    }
+    return 0;
+}
@@ -1,71 +1,228 @@
-#include <iomanip>
+#include <algorithm>
+#include <cassert>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
 
-#include "common/rng.hpp"
+#include "common/bench.hpp"
 #include "sim_algorithm/b_tree.hpp"
 #include "sim_algorithm/binary_search.hpp"
 #include "sim_algorithm/block_search.hpp"
+#include "sim_algorithm/compressed_css_tree_search.hpp"
+#include "sim_algorithm/css_tree_search.hpp"
+#include "sim_algorithm/eytzinger_search.hpp"
+#include "sim_algorithm/implicit_vEB_search.hpp"
+#include "sim_algorithm/packed_b_tree.hpp"
+#include "sim_algorithm/rmi_search.hpp"
+#include "sim_algorithm/s_tree_search.hpp"
 #include "sim_algorithm/vEB_search.hpp"
 #include "simulator/simulator.hpp"
 
-int main()
+namespace {
+
+/**
+ * データとクエリ (N/Q/分布が変わったときだけ作り直す)
+ */
+std::vector<data_t> Vs, Qxs;
+std::string Dist;
+
+void workload(const bench::params_t& p)
+{
+    if (Vs.size() != p.n or Dist != p.dist) {
+        Vs   = bench::generate<data_t>(p.dist, p.n, Min, Max, Seed);
+        Dist = p.dist;
+        Qxs.clear();
+    }
+    if (Qxs.size() != p.q) { Qxs = bench::generate_queries<data_t>(p.dist, p.q, Min, Max, Vs.empty() ? Max : *std::max_element(Vs.begin(), Vs.end()), Seed + 1); }
+}
+
+/**
+ * キャッシュミス回数 (前計算で分かる値もinfoとして一緒に出す)
+ */
+bench::metrics_t misses(const bench::params_t& p, const bench::metrics_t& info)
+{
+    const auto [R, W]     = sim::cache_miss_count();
+    const uint64_t QTotal = R + W;
+    bench::metrics_t ms{{"miss", static_cast<double>(QTotal)}, {"miss_per_query", static_cast<double>(QTotal) / static_cast<double>(p.q)}};
+    ms.insert(ms.end(), info.begin(), info.end());
+    return ms;
+}
+
+/**
+ * 1回分の計測 (キャッシュを空にしてから全クエリを1つずつ流す)
+ */
+template<typename Searcher>
+bench::trial_t queries(const bench::params_t& p, std::shared_ptr<Searcher> searcher, bench::metrics_t info = {})
+{
+    return [p, searcher, info] {
+        sim::initialize(p.b, p.m);  // リセット
+        for (const data_t qx : Qxs) { [[maybe_unused]] const auto ans = searcher->lower_bound(qx); }
+        assert(sim::cache_miss_count().disk_write_count == 0);
+        return misses(p, info);
+    };
+}
+
+/**
+ * 1回分の計測 (全クエリをまとめて流す)
+ * - クエリ列の書き出し・並べ替え・答えの並べ戻しも数える (書き戻しもあるのでR+W)
+ */
+template<typename Searcher>
+bench::trial_t batch_queries(const bench::params_t& p, std::shared_ptr<Searcher> searcher)
 {
-    constexpr std::size_t B = (1 << 9);
-    constexpr std::size_t M = (1 << 18);
-    constexpr std::size_t N = (1 << 24) + 64;
-    constexpr std::size_t Q = (1 << 20);
+    return [p, searcher] {
+        sim::initialize(p.b, p.m);  // リセット
+        [[maybe_unused]] const auto anss = searcher->lower_bound_batch(Qxs, p.b, p.m);
+        return misses(p, {});
+    };
+}
+
+/**
+ * 頂点のバイト数をBに揃えたテンプレートを選ぶ (Bが64~4096の2冪でなければ飛ばす)
+ */
+template<typename Builder>
+bench::trial_t with_node_bytes(const std::size_t b, Builder build)
+{
+    switch (b) {
+    case 64: return build(std::integral_constant<std::size_t, 64>{});
+    case 128: return build(std::integral_constant<std::size_t, 128>{});
+    case 256: return build(std::integral_constant<std::size_t, 256>{});
+    case 512: return build(std::integral_constant<std::size_t, 512>{});
+    case 1024: return build(std::integral_constant<std::size_t, 1024>{});
+    case 2048: return build(std::integral_constant<std::size_t, 2048>{});
+    case 4096: return build(std::integral_constant<std::size_t, 4096>{});
+    default: return nullptr;
+    }
+}
+
+/**
+ * B-木の1ノードが1ブロックに収まるK (K = B / sizeof(data_t) / 2)
+ */
+std::size_t b_tree_order(const std::size_t b)
+{
+    return b / sizeof(data_t) / 2;
+}
 
-    rng_base rng{Seed};
-    const auto vs  = rng.vec<data_t>(N, Min, Max);
-    const auto qxs = rng.vec<data_t>(Q, Min, Max);
+}  // anonymous namespace
 
-    {
-        std::cout << "[Sol1] Sorting" << std::endl;
-        binary_search searcher{vs};
-        std::cout << "Precalc end." << std::endl;
-        sim::initialize(B, M);  // リセット
-        for (std::size_t q = 0; q < Q; q++) {
-            const data_t qx                 = qxs[q];
-            [[maybe_unused]] const auto ans = searcher.lower_bound(qx);
-        }
-        const auto [R, W] = sim::cache_miss_count();
-        assert(W == 0);
-        const uint64_t QTotal = R + W;
-        std::cout << "Cache Miss: " << QTotal << std::endl;
-        std::cout << std::endl;
+/**
+ * 使い方: static_search [bench.hppの引数] [--heights=3,4,5,6,7]
+ * - heights: ブロッキングの高さ (バッチ版も同じ高さを全部測る)
+ *   1つずつのクエリは左詰めの木と番兵で埋めた木(Padded)の両方を測る
+ * - シミュレータは決定的なので、既定では1回だけ計測する
+ */
+int main(int argc, char* argv[])
+{
+    bench::options_t opts;
+    opts.ns = {(1 << 24) + 64};
+    opts.qs = {1 << 20};
+    opts.bs = {1 << 9};
+    opts.ms = {1 << 18};
+    std::string err;
+    std::vector<std::size_t> heights{3, 4, 5, 6, 7};
+    if (not bench::parse(argc, argv, opts, {"heights"}, err)) {
+        std::cerr << err << std::endl;
+        return 1;
     }
-    {
-        for (std::size_t H = 3; H <= 7; H++) {
-            std::cout << "[Sol2] Blocking (Block Height: " << H << ")" << std::endl;
-            block_search searcher{vs, H};
-            std::cout << "Precalc end." << std::endl;
-            sim::initialize(B, M);  // リセット
-            for (std::size_t q = 0; q < Q; q++) {
-                const data_t qx                 = qxs[q];
-                [[maybe_unused]] const auto ans = searcher.lower_bound(qx);
-            }
-            const auto [R, W] = sim::cache_miss_count();
-            assert(W == 0);
-            const uint64_t QTotal = R + W;
-            std::cout << "Cache Miss: " << QTotal << std::endl;
-            std::cout << std::endl;
-        }
+    if (opts.extra.count("heights") and not bench::parse_sizes(opts.extra["heights"], heights)) {
+        std::cerr << "invalid value: --heights=" << opts.extra["heights"] << std::endl;
+        return 1;
     }
-    {
-        std::cout << "[Sol3] vEB Layout" << std::endl;
-        vEB_search searcher{vs};
-        std::cout << "Precalc end." << std::endl;
-        sim::initialize(B, M);  // リセット
-        for (std::size_t q = 0; q < Q; q++) {
-            const data_t qx                 = qxs[q];
-            [[maybe_unused]] const auto ans = searcher.lower_bound(qx);
-        }
-        const auto [R, W] = sim::cache_miss_count();
-        assert(W == 0);
-        const uint64_t QTotal = R + W;
-        std::cout << "Cache Miss: " << QTotal << std::endl;
-        std::cout << std::endl;
+
+    bench::registry reg;
+    reg.add("[Sol1] Sorting", [](const bench::params_t& p) {
+        workload(p);
+        return queries(p, std::make_shared<binary_search>(Vs));
+    });
+    for (const std::size_t H : heights) {
+        reg.add("[Sol2] Blocking (Block Height: " + std::to_string(H) + ")", [H](const bench::params_t& p) {
+            workload(p);
+            return queries(p, std::make_shared<block_search>(Vs, H));
+        });
+        reg.add("[Sol2] Blocking (Block Height: " + std::to_string(H) + ", Padded)", [H](const bench::params_t& p) {
+            workload(p);
+            return queries(p, std::make_shared<block_search>(Vs, H, layout::shape_t::Padded));
+        });
+    }
+    reg.add("[Sol3] vEB Layout", [](const bench::params_t& p) {
+        workload(p);
+        return queries(p, std::make_shared<vEB_search>(Vs));
+    });
+    reg.add("[Sol4] Implicit vEB Layout", [](const bench::params_t& p) {
+        workload(p);
+        return queries(p, std::make_shared<implicit_vEB_search>(Vs));
+    });
+    reg.add("[Sol5] Eytzinger Layout", [](const bench::params_t& p) {
+        workload(p);
+        return queries(p, std::make_shared<eytzinger_search>(Vs));
+    });
+    reg.add("[Sol6] S-tree", [](const bench::params_t& p) {
+        workload(p);
+        return queries(p, std::make_shared<s_tree_search>(Vs));
+    });
+    // Bが小さくK < 2になるときは分割できないので飛ばす
+    reg.add("[Sol7] B-tree", [](const bench::params_t& p) -> bench::trial_t {
+        const std::size_t K = b_tree_order(p.b);
+        if (K < 2) { return nullptr; }
+        workload(p);
+        const auto searcher = std::make_shared<b_tree>(Vs, K);
+        return queries(p, searcher, {{"k", static_cast<double>(K)}, {"height", static_cast<double>(searcher->height())}});
+    });
+    reg.add("[Sol7] B-tree (Bulk Load)", [](const bench::params_t& p) -> bench::trial_t {
+        const std::size_t K = b_tree_order(p.b);
+        if (K < 2) { return nullptr; }
+        workload(p);
+        const auto searcher = std::make_shared<b_tree>(b_tree::bulk_load(Vs, K));
+        return queries(p, searcher, {{"k", static_cast<double>(K)}, {"height", static_cast<double>(searcher->height())}});
+    });
+    reg.add("[Sol8] Packed B-tree", [](const bench::params_t& p) {
+        workload(p);
+        return with_node_bytes(p.b, [&](auto bytes) {
+            using searcher_t = packed_b_tree<decltype(bytes)::value>;
+            return queries(p, std::make_shared<searcher_t>(Vs), {{"capacity", static_cast<double>(searcher_t::Capacity)}});
+        });
+    });
+    reg.add("[Sol9] CSS-tree", [](const bench::params_t& p) {
+        workload(p);
+        return with_node_bytes(p.b, [&](auto bytes) {
+            using searcher_t    = css_tree_search<decltype(bytes)::value>;
+            const auto searcher = std::make_shared<searcher_t>(Vs);
+            return queries(p, searcher, {{"fanout", static_cast<double>(searcher_t::Fanout)}, {"height", static_cast<double>(searcher->height())}});
+        });
+    });
+    reg.add("[Sol10] Compressed CSS-tree", [](const bench::params_t& p) {
+        workload(p);
+        return with_node_bytes(p.b, [&](auto bytes) {
+            const auto searcher = std::make_shared<compressed_css_tree_search<decltype(bytes)::value>>(Vs);
+            return queries(p, searcher, {{"keys_per_leaf", static_cast<double>(p.n) / static_cast<double>(searcher->leaf_num())}, {"height", static_cast<double>(searcher->height())}});
+        });
+    });
+    reg.add("[Sol11] RMI (Models: N/64)", [](const bench::params_t& p) {
+        workload(p);
+        const auto searcher = std::make_shared<rmi_search>(Vs, std::max<std::size_t>(p.n / 64, 1));  // 2段目のモデル数
+        return queries(p, searcher, {{"model_bytes", static_cast<double>(searcher->model_bytes())}, {"mean_error", searcher->mean_error()}});
+    });
+
+    reg.add("[Sol1] Sorting (Batch)", [](const bench::params_t& p) {
+        workload(p);
+        return batch_queries(p, std::make_shared<binary_search>(Vs));
+    });
+    for (const std::size_t H : heights) {
+        reg.add("[Sol2] Blocking (Block Height: " + std::to_string(H) + ") (Batch)", [H](const bench::params_t& p) {
+            workload(p);
+            return batch_queries(p, std::make_shared<block_search>(Vs, H));
+        });
     }
+    reg.add("[Sol3] vEB Layout (Batch)", [](const bench::params_t& p) {
+        workload(p);
+        return batch_queries(p, std::make_shared<vEB_search>(Vs));
+    });
+    reg.add("[Sol7] B-tree (Batch)", [](const bench::params_t& p) -> bench::trial_t {
+        const std::size_t K = b_tree_order(p.b);
+        if (K < 2) { return nullptr; }
+        workload(p);
+        return batch_queries(p, std::make_shared<b_tree>(Vs, K));
+    });
 
-    return 0;
+    return reg.run(opts);
 }
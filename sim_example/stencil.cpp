@@ -0,0 +1,78 @@
+#include <iostream>
+
+#include "common/rng.hpp"
+#include "sim_algorithm/stencil.hpp"
+#include "simulator/simulator.hpp"
+
+namespace {
+
+constexpr std::size_t B = (1 << 9);
+constexpr std::size_t M = (1 << 16);
+
+data_t kernel1(const data_t l, const data_t c, const data_t r)
+{
+    return (l + 2 * c + r) / 4;
+}
+
+data_t kernel2(const data_t c, const data_t n, const data_t s, const data_t w, const data_t e)
+{
+    return (4 * c + n + s + w + e) / 8;
+}
+
+void print_miss()
+{
+    const auto [R, W] = sim::cache_miss_count();
+    std::cout << "Cache Miss: " << R + W << " (Read: " << R << ", Write: " << W << ")" << std::endl;
+}
+
+}  // anonymous namespace
+
+int main()
+{
+    rng_base rng{Seed};
+    {
+        constexpr std::size_t N = (1 << 14);
+        constexpr std::size_t T = (1 << 7);
+        const auto vs           = rng.vec<data_t>(N, 0, 1000000);
+        {
+            std::cout << "[1D Sol1] Naive" << std::endl;
+            stencil_1d stencil{vs, kernel1};
+            sim::initialize(B, M);  // リセット
+            stencil.naive(T);
+            print_miss();
+            std::cout << std::endl;
+        }
+        {
+            std::cout << "[1D Sol2] Trapezoid" << std::endl;
+            stencil_1d stencil{vs, kernel1};
+            sim::initialize(B, M);  // リセット
+            stencil.trapezoid(T);
+            print_miss();
+            std::cout << std::endl;
+        }
+    }
+    {
+        constexpr std::size_t X = (1 << 8);
+        constexpr std::size_t Y = (1 << 8);
+        constexpr std::size_t T = (1 << 5);
+        const auto vs           = rng.vec<data_t>(X * Y, 0, 1000000);
+        {
+            std::cout << "[2D Sol1] Naive" << std::endl;
+            stencil_2d stencil{X, Y, vs, kernel2};
+            sim::initialize(B, M);  // リセット
+            stencil.naive(T);
+            print_miss();
+            std::cout << std::endl;
+        }
+        {
+            std::cout << "[2D Sol2] Trapezoid" << std::endl;
+            stencil_2d stencil{X, Y, vs, kernel2};
+            sim::initialize(B, M);  // リセット
+            stencil.trapezoid(T);
+            print_miss();
+            std::cout << std::endl;
+        }
+    }
+
+    return 0;
+}